@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+"""Generates the KAT_GL_TRACE hooks from glad's gl.h.
+
+Every PFN...PROC that glad declares gets a wrapper which calls the real entry point and records the call, see
+kat/gl_trace.hpp. Uniform vector and matrix setters record a hash of the values they point to rather than the
+pointer, so the analyzer can spot unchanged uniforms. Run by engine/CMakeLists.txt at configure time:
+
+    gen_gl_trace.py <glad/gl.h> <output.cpp>
+"""
+
+import re
+import sys
+
+TYPEDEF = re.compile(r'^typedef (.+?) ?\(GLAD_API_PTR \*(PFN\w+PROC)\)\((.*)\);$', re.MULTILINE)
+POINTER = re.compile(r'^GLAD_API_CALL (PFN\w+PROC) glad_(\w+);$', re.MULTILINE)
+PARAMETER = re.compile(r'^(.*?)\b(\w+)$')
+# glUniform4fv, glProgramUniformMatrix3x4fv, glUniformHandleui64vARB... with how many values each element holds
+UNIFORM_VECTOR = re.compile(r'^gl(?:Program)?Uniform(?:Matrix(\d)(?:x(\d))?|(\d)|Handle)(?:f|d|i|ui|i64|ui64)v(?:ARB|EXT|NV)?$')
+
+MAX_ARGS = 16
+
+# anything else without a '*' is read as unsigned
+TYPES = {
+    'GLenum': 'e',
+    'GLbitfield': 'x',
+    'GLboolean': 'b',
+    'GLfloat': 'f', 'GLclampf': 'f',
+    'GLdouble': 'd', 'GLclampd': 'd',
+    'GLint': 'i', 'GLsizei': 'i', 'GLshort': 'i', 'GLbyte': 'i', 'GLfixed': 'i', 'GLclampx': 'i',
+    'GLint64': 'i', 'GLint64EXT': 'i', 'GLintptr': 'i', 'GLintptrARB': 'i', 'GLsizeiptr': 'i', 'GLsizeiptrARB': 'i',
+    'GLvdpauSurfaceNV': 'i',
+    'GLsync': 'p', 'GLhandleARB': 'p', 'GLeglImageOES': 'p', 'GLeglClientBufferEXT': 'p',
+}
+
+
+def parse_parameters(text):
+    text = text.strip()
+    if text in ('', 'void'):
+        return []
+
+    parameters = []
+    for parameter in text.split(','):
+        match = PARAMETER.match(parameter.strip())
+        if not match:
+            raise ValueError(f'unexpected parameter "{parameter}"')
+        parameters.append((match.group(1).strip(), match.group(2)))
+    return parameters
+
+
+def type_code(parameter):
+    if '*' in parameter or parameter.endswith('PROC') or parameter.endswith('PROCARB') or \
+            parameter.endswith('PROCKHR') or parameter.endswith('PROCAMD') or parameter.endswith('PROCNV'):
+        return 'p'
+    return TYPES.get(parameter.replace('const ', '').strip(), 'u')
+
+
+def values_per_element(name):
+    match = UNIFORM_VECTOR.match(name)
+    if not match:
+        return None
+
+    rows, columns, size = match.groups()
+    if rows:
+        return int(rows) * int(columns or rows)
+    return int(size or 1)
+
+
+def hashed_values(name, parameters):
+    """(pointer index, count index, values per element) for uniform vector setters, None for everything else."""
+    per_element = values_per_element(name)
+    names = [n for _, n in parameters]
+    if per_element is None or 'count' not in names or '*' not in parameters[-1][0]:
+        return None
+    return len(parameters) - 1, names.index('count'), per_element
+
+
+def argument_codes(parameters, hashed):
+    codes = [type_code(p) for p, _ in parameters]
+    if hashed:
+        codes[hashed[0]] = 'h'
+    return ''.join(codes)
+
+
+def encode_argument(index, hashed):
+    if hashed and hashed[0] == index:
+        return f'hashValues(a{index}, static_cast<size_t>(a{hashed[1]}) * {hashed[2]})'
+    return f'encode(a{index})'
+
+
+def generate(header):
+    typedefs = {name: (result.strip(), parse_parameters(params)) for result, name, params in TYPEDEF.findall(header)}
+
+    functions = []
+    for pfn, name in POINTER.findall(header):
+        if pfn not in typedefs:
+            raise ValueError(f'{name} has no typedef for {pfn}')
+
+        result, parameters = typedefs[pfn]
+        if len(parameters) > MAX_ARGS:
+            raise ValueError(f'{name} takes {len(parameters)} arguments, traces store up to {MAX_ARGS}')
+        functions.append((name, pfn, result, parameters, hashed_values(name, parameters)))
+
+    if not functions:
+        raise ValueError('no GL functions found, is this a glad 2 header?')
+
+    out = [
+        '// Generated by engine/scripts/gen_gl_trace.py from glad/gl.h, changes are overwritten on configure.',
+        '#include "kat/gl_trace.hpp"',
+        '',
+        'namespace kat::gltrace::detail {',
+        '    namespace {',
+    ]
+
+    for index, (name, pfn, result, parameters, hashed) in enumerate(functions):
+        declared = ', '.join(f'{p} a{i}' for i, (p, _) in enumerate(parameters))
+        passed = ', '.join(f'a{i}' for i in range(len(parameters)))
+        encoded = ', '.join(encode_argument(i, hashed) for i in range(len(parameters)))
+
+        out.append(f'        {pfn} real_{name} = nullptr;')
+        out.append(f'        {result} GLAD_API_PTR trace_{name}({declared}) {{')
+        out.append('            uint64_t start = now();')
+        if result == 'void':
+            out.append(f'            real_{name}({passed});')
+            out.append(f'            record({index}, start, {{ {encoded} }});')
+        else:
+            out.append(f'            auto result = real_{name}({passed});')
+            out.append(f'            record({index}, start, {{ {encoded} }});')
+            out.append('            return result;')
+        out.append('        }')
+        out.append('')
+
+    out.append('    }')
+    out.append('')
+    out.append('    const std::vector<GlTraceFunction> FUNCTIONS = {')
+    for name, pfn, result, parameters, hashed in functions:
+        out.append(f'        {{ "{name}", "{argument_codes(parameters, hashed)}" }},')
+    out.append('    };')
+    out.append('')
+    out.append('    void install() {')
+    for name, pfn, result, parameters, hashed in functions:
+        out.append(f'        if (glad_{name} && glad_{name} != trace_{name}) {{')
+        out.append(f'            real_{name} = glad_{name};')
+        out.append(f'            glad_{name} = trace_{name};')
+        out.append('        }')
+    out.append('    }')
+    out.append('}')
+    out.append('')
+    return '\n'.join(out)
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__, file=sys.stderr)
+        return 1
+
+    with open(sys.argv[1], encoding='utf-8') as f:
+        source = generate(f.read())
+
+    # only touch the output when it changes, so reconfiguring doesn't rebuild it.
+    try:
+        with open(sys.argv[2], encoding='utf-8') as f:
+            if f.read() == source:
+                return 0
+    except FileNotFoundError:
+        pass
+
+    with open(sys.argv[2], 'w', encoding='utf-8') as f:
+        f.write(source)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
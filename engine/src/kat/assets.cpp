@@ -0,0 +1,227 @@
+#include "assets.hpp"
+
+#include <algorithm>
+
+namespace kat {
+    static uint64_t hashCombine(uint64_t seed, uint64_t value) {
+        return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    }
+
+    size_t AssetKeyHash::operator()(const AssetKey &key) const noexcept {
+        return hashCombine(hashCombine(static_cast<uint64_t>(key.type), key.path), key.params);
+    }
+
+    Assets::Assets() : Assets(Config{}) {}
+
+    Assets::Assets(const Config &config) : m_Config(config) {}
+
+    PathId Assets::intern(const std::filesystem::path &path) {
+        std::error_code ec;
+        auto canonical = std::filesystem::weakly_canonical(path, ec);
+        if (ec) canonical = std::filesystem::absolute(path).lexically_normal();
+
+        auto s = canonical.generic_string();
+
+        std::lock_guard lock(m_Mutex);
+        auto [it, inserted] = m_PathIds.try_emplace(s, static_cast<PathId>(m_Paths.size()));
+        if (inserted) m_Paths.push_back(s);
+        return it->second;
+    }
+
+    std::string Assets::getPath(PathId id) const {
+        std::lock_guard lock(m_Mutex);
+        return m_Paths.at(id);
+    }
+
+    AssetHandle<Texture2D> Assets::texture(const std::filesystem::path &path, int desiredChannels) {
+        AssetKey key{ AssetType::Texture, intern(path), static_cast<uint64_t>(desiredChannels) };
+
+        return acquire<Texture2D>(key, [&]() { return Texture2D::loadAsync(path, desiredChannels); },
+                                  [](const Texture2D& t) {
+                                      return static_cast<size_t>(t.getSize().x) * t.getSize().y * bytesPerPixel(t.getFormat());
+                                  });
+    }
+
+    static size_t measureShaderModule(const ShaderModule& module) {
+        int length = 0;
+        glGetShaderiv(module.getHandle(), GL_SHADER_SOURCE_LENGTH, &length);
+        return length;
+    }
+
+    AssetHandle<ShaderModule> Assets::shaderModule(const std::filesystem::path &path) {
+        AssetKey key{ AssetType::ShaderModule, intern(path), static_cast<uint64_t>(ShaderType::Unknown) };
+        return acquire<ShaderModule>(key, [&]() { return ShaderModule::load(path); }, measureShaderModule);
+    }
+
+    AssetHandle<ShaderModule> Assets::shaderModule(const std::filesystem::path &path, std::string_view source) {
+        AssetKey key{ AssetType::ShaderModule, intern(path), static_cast<uint64_t>(ShaderType::Unknown) };
+        return acquire<ShaderModule>(key, [&]() { return ShaderModule::load(path, source); }, measureShaderModule);
+    }
+
+    AssetHandle<ShaderModule> Assets::shaderModule(ShaderType type, const std::filesystem::path &path) {
+        AssetKey key{ AssetType::ShaderModule, intern(path), static_cast<uint64_t>(type) };
+        return acquire<ShaderModule>(key, [&]() { return ShaderModule::load(type, path); }, measureShaderModule);
+    }
+
+    AssetHandle<GraphicsShader> Assets::shader(const std::vector<GraphicsShader::SDef> &paths) {
+        // the modules are assets themselves, a program is keyed by the modules it links.
+        std::vector<AssetHandle<ShaderModule>> handles;
+        for (const auto& sd : paths) {
+            if (sd.index() == 0)
+                handles.push_back(shaderModule(std::get<0>(sd)));
+            else
+                handles.push_back(shaderModule(std::get<1>(sd).first, std::get<1>(sd).second));
+        }
+
+        uint64_t params = 0;
+        for (size_t i = 1; i < handles.size(); i++) {
+            params = hashCombine(params, AssetKeyHash{}(handles[i].getKey()));
+        }
+
+        AssetKey key{ AssetType::Shader, handles.empty() ? 0 : handles[0].getKey().path, params };
+
+        return acquire<GraphicsShader>(key, [&]() {
+            std::vector<std::shared_ptr<ShaderModule>> modules;
+            for (const auto& h : handles) modules.push_back(h.getShared());
+            return GraphicsShader::create(modules);
+        }, [](const GraphicsShader& shader) {
+            int length = 0;
+            glGetProgramiv(shader.getHandle(), GL_PROGRAM_BINARY_LENGTH, &length);
+            return static_cast<size_t>(length);
+        });
+    }
+
+    std::shared_ptr<void> Assets::acquireErased(const AssetKey &key, const std::function<std::shared_ptr<void>()> &load,
+                                                const std::function<size_t(const void *)> &measure) {
+        std::unique_lock lock(m_Mutex);
+
+        while (true) {
+            auto [it, inserted] = m_Entries.try_emplace(key);
+            if (inserted) break;
+
+            // loaded, or being loaded by someone else, in which case wait for them.
+            auto loaded = it->second.loaded;
+            lock.unlock();
+            loaded.wait();
+            lock.lock();
+
+            it = m_Entries.find(key);
+            if (it == m_Entries.end()) continue; // their load failed, try ourselves
+
+            it->second.unreferencedSince.reset();
+            m_Stats.hits++;
+            return it->second.asset;
+        }
+
+        std::promise<void> promise;
+        m_Entries[key].loaded = promise.get_future().share();
+        lock.unlock();
+
+        std::shared_ptr<void> asset;
+        try {
+            asset = load();
+        } catch (...) {
+            lock.lock();
+            m_Entries.erase(key);
+            promise.set_value();
+            throw;
+        }
+
+        lock.lock();
+        if (!asset) {
+            m_Entries.erase(key);
+            promise.set_value();
+            return nullptr;
+        }
+
+        auto& entry = m_Entries[key];
+        entry.asset = asset;
+        entry.measure = measure;
+        entry.bytes = measure(asset.get());
+        m_Memory[static_cast<size_t>(key.type)] += entry.bytes;
+        m_Stats.loads++;
+
+        promise.set_value();
+        return asset;
+    }
+
+    void Assets::collect() {
+        // evicted assets are released after unlocking, their destructors may be slow.
+        std::vector<std::shared_ptr<void>> evicted;
+
+        std::lock_guard lock(m_Mutex);
+        auto now = Clock::now();
+
+        m_Memory.fill(0);
+        std::vector<std::pair<Clock::time_point, AssetKey>> candidates;
+
+        for (auto& [key, entry] : m_Entries) {
+            if (!entry.asset) continue; // still loading
+
+            // textures loading asynchronously change size once they land.
+            entry.bytes = entry.measure(entry.asset.get());
+            m_Memory[static_cast<size_t>(key.type)] += entry.bytes;
+
+            if (entry.asset.use_count() > 1) {
+                entry.unreferencedSince.reset();
+                continue;
+            }
+
+            if (!entry.unreferencedSince) entry.unreferencedSince = now;
+
+            if (std::chrono::duration<double>(now - *entry.unreferencedSince).count() >= m_Config.gracePeriod)
+                candidates.emplace_back(*entry.unreferencedSince, key);
+        }
+
+        size_t total = sumMemory();
+        if (total <= m_Config.budget) return;
+
+        std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        for (const auto& [since, key] : candidates) {
+            if (total <= m_Config.budget) break;
+
+            auto it = m_Entries.find(key);
+            total -= it->second.bytes;
+            m_Memory[static_cast<size_t>(key.type)] -= it->second.bytes;
+
+            evicted.push_back(std::move(it->second.asset));
+            m_Entries.erase(it);
+            m_Stats.evictions++;
+        }
+    }
+
+    void Assets::update() {
+        auto now = Clock::now();
+        if (std::chrono::duration<double>(now - m_LastCollect).count() < m_Config.collectInterval) return;
+
+        m_LastCollect = now;
+        collect();
+    }
+
+    size_t Assets::getMemory(AssetType type) const {
+        std::lock_guard lock(m_Mutex);
+        return m_Memory[static_cast<size_t>(type)];
+    }
+
+    size_t Assets::getTotalMemory() const {
+        std::lock_guard lock(m_Mutex);
+        return sumMemory();
+    }
+
+    size_t Assets::sumMemory() const {
+        size_t total = 0;
+        for (auto m : m_Memory) total += m;
+        return total;
+    }
+
+    size_t Assets::getCount() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Entries.size();
+    }
+
+    Assets::Stats Assets::getStats() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Stats;
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "kat/engine.hpp"
+#include "kat/graphics/texture.hpp"
+#include "kat/graphics/shader.hpp"
+
+#include <array>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace kat {
+
+    enum class AssetType : uint8_t {
+        Texture, ShaderModule, Shader, Other,
+        Count
+    };
+
+    using PathId = uint32_t;
+
+    struct AssetKey {
+        AssetType type;
+        PathId path;
+        uint64_t params;    // load parameters, hashed
+
+        bool operator==(const AssetKey&) const = default;
+    };
+
+    struct AssetKeyHash {
+        size_t operator()(const AssetKey& key) const noexcept;
+    };
+
+    // A counted reference to a cached asset. While one is alive the asset can't be evicted.
+    template<typename T>
+    class AssetHandle {
+    public:
+        AssetHandle() = default;
+        AssetHandle(std::shared_ptr<T> asset, const AssetKey& key) : m_Asset(std::move(asset)), m_Key(key) {};
+
+        T* operator->() const noexcept { return m_Asset.get(); };
+        T& operator*() const noexcept { return *m_Asset; };
+        explicit operator bool() const noexcept { return m_Asset != nullptr; };
+
+        // so handles can be passed wherever the engine takes a shared_ptr.
+        operator const std::shared_ptr<T>&() const noexcept { return m_Asset; };
+
+        [[nodiscard]] T* get() const noexcept { return m_Asset.get(); };
+        [[nodiscard]] const std::shared_ptr<T>& getShared() const noexcept { return m_Asset; };
+        [[nodiscard]] const AssetKey& getKey() const noexcept { return m_Key; };
+
+    private:
+        std::shared_ptr<T> m_Asset;
+        AssetKey m_Key{};
+    };
+
+    // The asset registry.
+    //
+    // Assets are keyed by their interned canonical path and load parameters, so the same file is only ever loaded
+    // once, including when two threads ask for it at the same time. Assets nobody references anymore stay cached
+    // while the total stays within the budget, past it the ones unreferenced for longer than the grace period are
+    // evicted, least recently used first.
+    class Assets {
+    public:
+        struct Config {
+            size_t budget = 256 * 1024 * 1024;
+            double gracePeriod = 5.0;        // seconds
+            double collectInterval = 1.0;    // seconds between collect() calls made by update()
+        };
+
+        struct Stats {
+            size_t loads = 0;
+            size_t hits = 0;
+            size_t evictions = 0;
+        };
+
+        Assets();
+        explicit Assets(const Config& config);
+
+        PathId intern(const std::filesystem::path& path);
+        [[nodiscard]] std::string getPath(PathId id) const;
+
+        // the textures come from the async loader, see Texture2D::loadAsync.
+        AssetHandle<Texture2D> texture(const std::filesystem::path& path, int desiredChannels = 0);
+        AssetHandle<ShaderModule> shaderModule(const std::filesystem::path& path);
+        AssetHandle<ShaderModule> shaderModule(ShaderType type, const std::filesystem::path& path);
+        // for sources read elsewhere (e.g. a LoadPipeline), cached as if shaderModule(path) had loaded them.
+        AssetHandle<ShaderModule> shaderModule(const std::filesystem::path& path, std::string_view source);
+        AssetHandle<GraphicsShader> shader(const std::vector<GraphicsShader::SDef>& paths);
+
+        // generic entry point, measure reports the bytes an asset currently holds.
+        template<typename T>
+        AssetHandle<T> acquire(const AssetKey& key, const std::function<std::shared_ptr<T>()>& load,
+                               const std::function<size_t(const T&)>& measure) {
+            auto asset = acquireErased(key,
+                                       [&]() { return std::static_pointer_cast<void>(load()); },
+                                       [measure](const void* p) { return measure(*static_cast<const T*>(p)); });
+            return AssetHandle<T>(std::static_pointer_cast<T>(asset), key);
+        }
+
+        // remeasures everything and evicts over budget. GL thread, since dropping an asset deletes GL objects.
+        void collect();
+
+        // collect() at most every collectInterval, called on present.
+        void update();
+
+        [[nodiscard]] size_t getMemory(AssetType type) const;
+        [[nodiscard]] size_t getTotalMemory() const;
+        [[nodiscard]] size_t getCount() const;
+        [[nodiscard]] Stats getStats() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Entry {
+            std::shared_ptr<void> asset;
+            std::shared_future<void> loaded;
+            std::function<size_t(const void*)> measure;
+
+            size_t bytes = 0;
+            std::optional<Clock::time_point> unreferencedSince;
+        };
+
+        std::shared_ptr<void> acquireErased(const AssetKey& key, const std::function<std::shared_ptr<void>()>& load,
+                                            const std::function<size_t(const void*)>& measure);
+
+        // m_Mutex held
+        [[nodiscard]] size_t sumMemory() const;
+
+        Config m_Config;
+
+        std::unordered_map<std::string, PathId> m_PathIds;
+        std::vector<std::string> m_Paths;
+
+        std::unordered_map<AssetKey, Entry, AssetKeyHash> m_Entries;
+        std::array<size_t, static_cast<size_t>(AssetType::Count)> m_Memory{};
+        Stats m_Stats;
+
+        Clock::time_point m_LastCollect = Clock::now();
+
+        mutable std::mutex m_Mutex;
+    };
+
+    namespace gbl {
+        // created with the GL context, see gbl::setup
+        inline std::unique_ptr<Assets> assets;
+    }
+}
@@ -0,0 +1,35 @@
+#include "kat/core.hpp"
+
+#include "kat/io/file.hpp"
+
+namespace kat {
+    std::string util::readFile(const std::filesystem::path &path) {
+        auto blob = io::read(path);
+        if (!blob) spdlog::error("File {} is missing", path.string());
+
+        return std::string(blob.getString());
+    }
+
+    bool util::isWhitespace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    std::string util::strip(const std::string &in) {
+        return rstrip(lstrip(in));
+    }
+
+    std::string util::lstrip(const std::string &in) {
+        size_t l = 0;
+        while (l < in.size() && isWhitespace(in[l])) l++;
+        if (l == 0) return in;
+        return in.substr(l);
+    }
+
+    std::string util::rstrip(const std::string &in) {
+        size_t l = in.size();
+        while (l > 0 && isWhitespace(in[l])) l--;
+        if (l == 0) return in;
+        return in.substr(0, l);
+
+    }
+}
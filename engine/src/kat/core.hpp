@@ -0,0 +1,23 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <spdlog/spdlog.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Everything here builds without a graphics stack, see KatEngine::Core. GL lives behind kat/gl.hpp.
+namespace kat {
+
+    // Utility
+    namespace util {
+        std::string readFile(const std::filesystem::path& path);
+
+        bool isWhitespace(char c);
+
+        std::string strip(const std::string& in);
+        std::string lstrip(const std::string& in);
+        std::string rstrip(const std::string& in);
+    }
+}
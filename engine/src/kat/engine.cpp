@@ -1,52 +1,59 @@
 #include "kat/engine.hpp"
 #include "kat/os.hpp"
 
-#include <fstream>
 #include <ranges>
 #include <algorithm>
+#include "kat/assets.hpp"
+#include "kat/graphics/dynamic_texture.hpp"
+#include "kat/graphics/gpu_profiler.hpp"
+#include "kat/graphics/palette.hpp"
+#include "kat/graphics/readback.hpp"
+#include "kat/graphics/render_stats.hpp"
 #include "kat/graphics/sprite.hpp"
+#include "kat/graphics/texture_loader.hpp"
+#include "kat/graphics/tiles.hpp"
+#include "kat/io/file.hpp"
+#include "kat/util/job_system.hpp"
 #include "kat/util/transform_stack.hpp"
 
 namespace kat {
     void gbl::cleanup() {
         gbl::appEvents.dispatch(AppEvent::Cleanup);
         gbl::activeWindow = nullptr;
+        gbl::jobs.reset();
     }
 
-    std::string util::readFile(const std::filesystem::path &path) {
-        std::ifstream f(path);
-        std::string s((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
-        return s;
-    }
+    void gbl::setup() {
+        gbl::jobs = std::make_unique<JobSystem>();
 
-    bool util::isWhitespace(char c) {
-        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
-    }
+        gbl::appEvents.appendListener(AppEvent::Initialize, kat::Sprite::init);
+        gbl::appEvents.appendListener(AppEvent::Cleanup, kat::Sprite::cleanup);
+        gbl::appEvents.appendListener(AppEvent::Initialize, kat::TileMeshBuilder::init);
+        gbl::appEvents.appendListener(AppEvent::Cleanup, kat::TileMeshBuilder::cleanup);
+        gbl::appEvents.appendListener(AppEvent::Initialize, kat::IndexedTexture::init);
+        gbl::appEvents.appendListener(AppEvent::Cleanup, kat::IndexedTexture::cleanup);
 
-    std::string util::strip(const std::string &in) {
-        return rstrip(lstrip(in));
-    }
+        gbl::appEvents.appendListener(AppEvent::Initialize, kat::TextureLoader::init);
+        gbl::appEvents.appendListener(AppEvent::Cleanup, kat::TextureLoader::cleanup);
+        gbl::appEvents.appendListener(AppEvent::Initialize, kat::DynamicTexture2D::init);
+        gbl::appEvents.appendListener(AppEvent::Cleanup, kat::DynamicTexture2D::cleanup);
 
-    std::string util::lstrip(const std::string &in) {
-        size_t l = 0;
-        while (l < in.size() && isWhitespace(in[l])) l++;
-        if (l == 0) return in;
-        return in.substr(l);
-    }
+        gbl::appEvents.appendListener(AppEvent::Present, [](){ gbl::renderStats.endFrame(); });
 
-    std::string util::rstrip(const std::string &in) {
-        size_t l = in.size();
-        while (l > 0 && isWhitespace(in[l])) l--;
-        if (l == 0) return in;
-        return in.substr(0, l);
+        gbl::appEvents.appendListener(AppEvent::Initialize, kat::GpuProfiler::init);
+        gbl::appEvents.appendListener(AppEvent::Cleanup, kat::GpuProfiler::cleanup);
+        gbl::appEvents.appendListener(AppEvent::Present, [](){ if (gbl::gpuProfiler) gbl::gpuProfiler->endFrame(); });
 
-    }
+        gbl::appEvents.appendListener(AppEvent::Initialize, kat::ReadbackRing::init);
+        gbl::appEvents.appendListener(AppEvent::Cleanup, kat::ReadbackRing::cleanup);
+        gbl::appEvents.appendListener(AppEvent::Present, [](){ if (gbl::readback) gbl::readback->poll(); });
+        gbl::appEvents.appendListener(AppEvent::Present, [](){ if (gbl::textures) gbl::textures->pump(); });
 
-    void gbl::setup() {
-        gbl::appEvents.appendListener(AppEvent::Initialize, kat::Sprite::init);
-        gbl::appEvents.appendListener(AppEvent::Cleanup, kat::Sprite::cleanup);
+        gbl::appEvents.appendListener(AppEvent::Initialize, [](){ gbl::assets = std::make_unique<Assets>(); });
+        gbl::appEvents.appendListener(AppEvent::Cleanup, [](){ gbl::assets.reset(); });
+        gbl::appEvents.appendListener(AppEvent::Present, [](){ if (gbl::assets) gbl::assets->update(); });
 
         gbl::appEvents.appendListener(AppEvent::Cleanup, [](){ kat::transform::unravel(true); });
-        gbl::appEvents.appendListener(AppEvent::Update, [](){ kat::transform::unravel(false); });
+        gbl::appEvents.appendListener(AppEvent::Present, [](){ kat::transform::unravel(false); });
     }
 }
\ No newline at end of file
@@ -1,21 +1,17 @@
 #pragma once
 
-#include <glad/gl.h>
-#include <GLFW/glfw3.h>
-#include <glm/glm.hpp>
-#include <spdlog/spdlog.h>
-#include <eventpp/eventdispatcher.h>
+#include "kat/core.hpp"
+#include "kat/gl.hpp"
 
-#include <filesystem>
-#include <string>
-#include <vector>
+#include <eventpp/eventdispatcher.h>
 
 namespace kat {
     // Forward Definitions
     class Window;
 
     enum AppEvent {
-        Initialize, Cleanup, Update
+        Initialize, Cleanup, Update,
+        Present // dispatched on the thread owning the GL context, right after a swap
     };
 
     // Global State
@@ -28,15 +24,4 @@ namespace kat {
 
         inline eventpp::EventDispatcher<AppEvent, void()> appEvents;
     }
-
-    // Utility
-    namespace util {
-        std::string readFile(const std::filesystem::path& path);
-
-        bool isWhitespace(char c);
-
-        std::string strip(const std::string& in);
-        std::string lstrip(const std::string& in);
-        std::string rstrip(const std::string& in);
-    }
 }
\ No newline at end of file
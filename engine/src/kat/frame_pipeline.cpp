@@ -0,0 +1,122 @@
+#include "frame_pipeline.hpp"
+#include "kat/os.hpp"
+#include "kat/util/transform_stack.hpp"
+
+namespace kat {
+    FrameScheduler::FrameScheduler(const Config &config) : m_Config(config) {
+        if (m_Config.maxFrameLatency == 0) m_Config.maxFrameLatency = 1;
+    }
+
+    FrameScheduler::~FrameScheduler() {
+        stop();
+    }
+
+    void FrameScheduler::start(std::function<void(size_t)> renderSlot) {
+        if (m_Running) return;
+
+        m_RenderSlot = std::move(renderSlot);
+
+        m_FreeSlots.clear();
+        m_ReadySlots.clear();
+        for (size_t i = 0; i < getSlotCount(); i++) m_FreeSlots.push_back(i);
+        m_InputTimes.assign(getSlotCount(), util::Clock::time_point{});
+
+        m_StopRequested = false;
+        m_Running = true;
+
+        Window::releaseContext();
+        m_RenderThread = std::thread(&FrameScheduler::renderLoop, this);
+    }
+
+    void FrameScheduler::stop() {
+        if (!m_Running) return;
+
+        {
+            std::lock_guard lock(m_Mutex);
+            m_StopRequested = true;
+        }
+        m_Condition.notify_all();
+
+        m_RenderThread.join();
+        m_Running = false;
+
+        gbl::activeWindow->makeContextCurrent();
+    }
+
+    bool FrameScheduler::isRunning() const noexcept {
+        return m_Running;
+    }
+
+    size_t FrameScheduler::getSlotCount() const noexcept {
+        // one being written by simulation, the rest queued for or in use by the render thread.
+        return m_Config.maxFrameLatency + 1;
+    }
+
+    const FrameScheduler::Config &FrameScheduler::getConfig() const noexcept {
+        return m_Config;
+    }
+
+    std::optional<size_t> FrameScheduler::acquireSlot() {
+        if (!m_Running) return std::nullopt;
+
+        std::unique_lock lock(m_Mutex);
+        m_Condition.wait(lock, [this]() { return !m_FreeSlots.empty() || m_StopRequested; });
+
+        // the render thread is gone or going, nothing published from here on would be rendered.
+        if (m_StopRequested) return std::nullopt;
+
+        size_t slot = m_FreeSlots.front();
+        m_FreeSlots.pop_front();
+        return slot;
+    }
+
+    void FrameScheduler::publishSlot(size_t slot) {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_InputTimes[slot] = gbl::activeWindow->getInputTime();
+            m_ReadySlots.push_back(slot);
+        }
+        m_Condition.notify_all();
+    }
+
+    void FrameScheduler::renderLoop() {
+        KAT_PROFILE_THREAD("render");
+        gbl::activeWindow->makeContextCurrent();
+
+        while (true) {
+            size_t slot;
+            util::Clock::time_point inputTime;
+            {
+                std::unique_lock lock(m_Mutex);
+                m_Condition.wait(lock, [this]() { return !m_ReadySlots.empty() || m_StopRequested; });
+                if (m_StopRequested) break;
+
+                slot = m_ReadySlots.front();
+                m_ReadySlots.pop_front();
+                inputTime = m_InputTimes[slot];
+            }
+
+            auto& stats = gbl::clock.getStats();
+            {
+                KAT_PROFILE_SCOPE("render");
+                auto scope = stats.measure(util::FramePhase::Render);
+                m_RenderSlot(slot);
+            }
+            {
+                KAT_PROFILE_SCOPE("swap");
+                auto scope = stats.measure(util::FramePhase::Swap);
+                gbl::activeWindow->swapBuffers(inputTime);
+            }
+
+            {
+                std::lock_guard lock(m_Mutex);
+                m_FreeSlots.push_back(slot);
+            }
+            m_Condition.notify_all();
+        }
+
+        kat::transform::unravel(true);
+        gbl::activeWindow->getLatencyLimiter().clear();
+        Window::releaseContext();
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "kat/engine.hpp"
+#include "kat/util/clock.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace kat {
+
+    // Moves rendering onto a dedicated thread which owns the GL context, so simulating frame N+1 overlaps with
+    // rendering and presenting frame N. The threads only ever share the snapshot slots handed over by the scheduler.
+    class FrameScheduler {
+    public:
+
+        struct Config {
+            // how many submitted frames may be waiting on (or in) the render thread before simulation blocks.
+            size_t maxFrameLatency = 1;
+        };
+
+        explicit FrameScheduler(const Config& config);
+        ~FrameScheduler();
+
+        FrameScheduler(const FrameScheduler&) = delete;
+        FrameScheduler& operator=(const FrameScheduler&) = delete;
+
+        // hands the context of the active window over to the render thread.
+        void start(std::function<void(size_t)> renderSlot);
+
+        // finishes the frame currently rendering, drops anything still queued and takes the context back.
+        void stop();
+
+        [[nodiscard]] bool isRunning() const noexcept;
+        [[nodiscard]] size_t getSlotCount() const noexcept;
+        [[nodiscard]] const Config& getConfig() const noexcept;
+
+    protected:
+        // empty once the scheduler isn't running, the render thread won't read anything written after that.
+        std::optional<size_t> acquireSlot();
+        void publishSlot(size_t slot);
+
+    private:
+        void renderLoop();
+
+        Config m_Config;
+
+        std::function<void(size_t)> m_RenderSlot;
+        std::thread m_RenderThread;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+
+        std::deque<size_t> m_FreeSlots;
+        std::deque<size_t> m_ReadySlots;
+        std::vector<util::Clock::time_point> m_InputTimes;  // per slot, when its input was sampled
+
+        bool m_Running = false;
+        bool m_StopRequested = false;
+    };
+
+    // Snapshots are what simulation produces for the render thread each frame. They're recycled, so write every
+    // field you read on the render side.
+    template<typename Snapshot>
+    class FramePipeline : public FrameScheduler {
+    public:
+        using RenderFunction = std::function<void(const Snapshot&)>;
+
+        explicit FramePipeline(RenderFunction render, const Config& config = {})
+                : FrameScheduler(config), m_Render(std::move(render)), m_Snapshots(getSlotCount()) {}
+
+        inline void start() {
+            FrameScheduler::start([this](size_t slot) { m_Render(m_Snapshots[slot]); });
+        };
+
+        // blocks while simulation is maxFrameLatency frames ahead of presentation. when stopped the frame goes into a
+        // scratch snapshot which is never rendered.
+        inline Snapshot& beginFrame() {
+            m_WriteSlot = acquireSlot();
+            return m_WriteSlot ? m_Snapshots[*m_WriteSlot] : m_Scratch;
+        };
+
+        inline void submitFrame() {
+            if (m_WriteSlot) publishSlot(*m_WriteSlot);
+            m_WriteSlot.reset();
+        };
+
+    private:
+        RenderFunction m_Render;
+        std::vector<Snapshot> m_Snapshots;
+        Snapshot m_Scratch{};
+        std::optional<size_t> m_WriteSlot;
+    };
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+#include <glad/gl.h>
+#include <GLFW/glfw3.h>
@@ -0,0 +1,84 @@
+#include "gl_trace.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <mutex>
+
+namespace kat::gltrace {
+    namespace {
+        // GL calls come from whichever thread holds the context, the lock only matters around handovers.
+        std::mutex s_Mutex;
+        GlTraceWriter s_Writer;
+        std::atomic<bool> s_Recording = false;
+        std::atomic<uint64_t> s_Start = 0;
+        std::atomic<uint32_t> s_Threads = 0;
+
+        uint8_t threadIndex() {
+            thread_local auto index = static_cast<uint8_t>(std::min<uint32_t>(s_Threads.fetch_add(1), 255));
+            return index;
+        }
+    }
+
+    bool start(const std::filesystem::path &path) {
+#ifdef KAT_GL_TRACE
+        std::lock_guard lock(s_Mutex);
+        detail::install();
+
+        if (!s_Writer.open(path, detail::FUNCTIONS)) return false;
+
+        s_Start.store(detail::now(), std::memory_order_relaxed);
+        s_Recording.store(true, std::memory_order_release);
+        spdlog::info("Tracing GL calls into {}", path.string());
+        return true;
+#else
+        spdlog::error("Can't trace GL calls into {}, this build has no KAT_GL_TRACE", path.string());
+        return false;
+#endif
+    }
+
+    void stop() {
+        std::lock_guard lock(s_Mutex);
+        if (!s_Writer.isOpen()) return;
+
+        s_Recording.store(false, std::memory_order_relaxed);
+        s_Writer.close();
+        spdlog::info("GL trace finished, {} records", s_Writer.getRecordCount());
+    }
+
+    void frame() {
+        if (isRecording()) detail::record(GL_TRACE_FRAME, detail::now(), {});
+    }
+
+    bool isRecording() noexcept {
+        return s_Recording.load(std::memory_order_relaxed);
+    }
+
+    bool isAvailable() noexcept {
+#ifdef KAT_GL_TRACE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    uint64_t detail::now() noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void detail::record(uint16_t function, uint64_t start, std::initializer_list<uint64_t> args) {
+        if (!s_Recording.load(std::memory_order_acquire)) return;
+
+        uint64_t duration = now() - start;
+
+        GlTraceRecord record{};
+        record.function = function;
+        record.thread = threadIndex();
+        record.duration = static_cast<uint32_t>(std::min<uint64_t>(duration, std::numeric_limits<uint32_t>::max()));
+        record.time = start - std::min(start, s_Start.load(std::memory_order_relaxed));
+
+        std::lock_guard lock(s_Mutex);
+        if (s_Writer.isOpen()) s_Writer.write(record, { args.begin(), args.size() });
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "kat/engine.hpp"
+#include "kat/io/gl_trace_file.hpp"
+
+#include <bit>
+#include <initializer_list>
+#include <type_traits>
+
+namespace kat::gltrace {
+
+    // Records every GL call, with its arguments and how long it took, into a GlTrace file for KatGlTrace to pick apart.
+    // Only available when built with KAT_GL_TRACE: glad's function pointers are then swapped for generated wrappers
+    // (see engine/scripts/gen_gl_trace.py) the first time tracing starts. Window::create starts it when the
+    // KAT_GL_TRACE environment variable names a file.
+
+    // false when it can't be written, or in builds without KAT_GL_TRACE.
+    bool start(const std::filesystem::path& path);
+    void stop();
+
+    // marks a present, called by the window after every swap.
+    void frame();
+
+    [[nodiscard]] bool isRecording() noexcept;
+    [[nodiscard]] bool isAvailable() noexcept;
+
+    namespace detail {
+        // generated, KAT_GL_TRACE builds only
+        extern const std::vector<GlTraceFunction> FUNCTIONS;
+        void install();
+
+        [[nodiscard]] uint64_t now() noexcept;
+        void record(uint16_t function, uint64_t start, std::initializer_list<uint64_t> args);
+
+        template<typename T>
+        [[nodiscard]] inline uint64_t encode(T value) noexcept {
+            if constexpr (std::is_pointer_v<T>) return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value));
+            else if constexpr (std::is_same_v<T, float>) return std::bit_cast<uint32_t>(value);
+            else if constexpr (std::is_same_v<T, double>) return std::bit_cast<uint64_t>(value);
+            else if constexpr (std::is_signed_v<T>) return static_cast<uint64_t>(static_cast<int64_t>(value));
+            else return static_cast<uint64_t>(value);
+        };
+
+        // fnv-1a over count values, for arrays whose contents matter more than where they are.
+        template<typename T>
+        [[nodiscard]] inline uint64_t hashValues(const T* values, size_t count) noexcept {
+            if (!values) return 0;
+
+            const auto* bytes = reinterpret_cast<const unsigned char*>(values);
+            uint64_t h = 0xcbf29ce484222325ull;
+            for (size_t i = 0; i < count * sizeof(T); i++) {
+                h ^= bytes[i];
+                h *= 0x100000001b3ull;
+            }
+            return h;
+        }
+    }
+}
@@ -1,9 +1,11 @@
 #include "graphics.hpp"
+#include "kat/graphics/render_stats.hpp"
 
 namespace kat::graphics {
     void clear(const glm::vec4 &color) {
         glClearColor(color.r, color.g, color.b, color.a);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+        gbl::renderStats.clear();
     }
 
     void polygonMode(PolygonMode mode) {
@@ -0,0 +1,361 @@
+#include "atlas.hpp"
+
+#include "kat/assets.hpp"
+#include "kat/io/file.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace kat {
+
+    RectPacker::RectPacker(const glm::uvec2 &size) : m_Size(size), m_Free{ { 0, 0, size.x, size.y } } {}
+
+    std::optional<glm::uvec2> RectPacker::insert(const glm::uvec2 &size) {
+        const Rect* best = nullptr;
+        uint32_t bestShort = std::numeric_limits<uint32_t>::max();
+        uint32_t bestLong = std::numeric_limits<uint32_t>::max();
+
+        for (const auto& free : m_Free) {
+            if (free.w < size.x || free.h < size.y) continue;
+
+            uint32_t dx = free.w - size.x, dy = free.h - size.y;
+            uint32_t shortSide = std::min(dx, dy), longSide = std::max(dx, dy);
+            if (shortSide < bestShort || (shortSide == bestShort && longSide < bestLong)) {
+                best = &free;
+                bestShort = shortSide;
+                bestLong = longSide;
+            }
+        }
+
+        if (!best) return std::nullopt;
+        Rect placed{ best->x, best->y, size.x, size.y };
+
+        // every free rect overlapping the placed one is replaced by the (up to four) maximal rects around it.
+        std::vector<Rect> split;
+        split.reserve(m_Free.size() + 4);
+
+        for (const auto& free : m_Free) {
+            bool overlaps = placed.x < free.x + free.w && free.x < placed.x + placed.w &&
+                            placed.y < free.y + free.h && free.y < placed.y + placed.h;
+            if (!overlaps) {
+                split.push_back(free);
+                continue;
+            }
+
+            if (placed.x > free.x)
+                split.push_back({ free.x, free.y, placed.x - free.x, free.h });
+            if (placed.x + placed.w < free.x + free.w)
+                split.push_back({ placed.x + placed.w, free.y, free.x + free.w - placed.x - placed.w, free.h });
+            if (placed.y > free.y)
+                split.push_back({ free.x, free.y, free.w, placed.y - free.y });
+            if (placed.y + placed.h < free.y + free.h)
+                split.push_back({ free.x, placed.y + placed.h, free.w, free.y + free.h - placed.y - placed.h });
+        }
+
+        // drop rects contained in another one, of two equal rects the first is kept.
+        auto contains = [](const Rect& a, const Rect& b) {
+            return b.x >= a.x && b.y >= a.y && b.x + b.w <= a.x + a.w && b.y + b.h <= a.y + a.h;
+        };
+
+        m_Free.clear();
+        for (size_t i = 0; i < split.size(); i++) {
+            bool contained = false;
+            for (size_t j = 0; j < split.size() && !contained; j++) {
+                contained = i != j && contains(split[j], split[i]) && (j < i || split[j] != split[i]);
+            }
+
+            if (!contained) m_Free.push_back(split[i]);
+        }
+
+        m_Used += static_cast<uint64_t>(size.x) * size.y;
+        return glm::uvec2{ placed.x, placed.y };
+    }
+
+    const glm::uvec2 &RectPacker::getSize() const noexcept {
+        return m_Size;
+    }
+
+    uint64_t RectPacker::getUsedArea() const noexcept {
+        return m_Used;
+    }
+
+    float RectPacker::getOccupancy() const noexcept {
+        return static_cast<float>(static_cast<double>(m_Used) / (static_cast<double>(m_Size.x) * m_Size.y));
+    }
+
+    AtlasPacker::AtlasPacker() : AtlasPacker(Config{}) {}
+
+    AtlasPacker::AtlasPacker(const Config &config) : m_Config(config) {}
+
+    std::optional<AtlasPacker::Placement> AtlasPacker::add(const glm::uvec2 &size, std::span<const uint8_t> rgba) {
+        if (size.x == 0 || size.y == 0 || rgba.size() < static_cast<size_t>(size.x) * size.y * 4) {
+            spdlog::error("Atlas sprite of {}x{} has no or too few pixels", size.x, size.y);
+            return std::nullopt;
+        }
+
+        auto pixel = [&](uint32_t x, uint32_t y) { return &rgba[(static_cast<size_t>(y) * size.x + x) * 4]; };
+
+        glm::uvec2 min{ 0, 0 }, max = size;
+        if (m_Config.trim) {
+            min = size;
+            max = { 0, 0 };
+
+            for (uint32_t y = 0; y < size.y; y++) {
+                for (uint32_t x = 0; x < size.x; x++) {
+                    if (pixel(x, y)[3] == 0) continue;
+                    min = glm::min(min, glm::uvec2{ x, y });
+                    max = glm::max(max, glm::uvec2{ x + 1, y + 1 });
+                }
+            }
+
+            // nothing visible, keep a single transparent pixel so the sprite still has a region.
+            if (max.x == 0) {
+                min = { 0, 0 };
+                max = { 1, 1 };
+            }
+        }
+
+        glm::uvec2 trimmed = max - min;
+
+        // FNV-1a over the trimmed pixels. a 64 bit collision between two sprites of one atlas isn't worth guarding.
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&](const uint8_t* data, size_t length) {
+            for (size_t i = 0; i < length; i++) {
+                hash ^= data[i];
+                hash *= 1099511628211ull;
+            }
+        };
+
+        mix(reinterpret_cast<const uint8_t*>(&trimmed), sizeof(trimmed));
+        for (uint32_t y = min.y; y < max.y; y++) mix(pixel(min.x, y), static_cast<size_t>(trimmed.x) * 4);
+
+        if (auto it = m_Hashes.find(hash); it != m_Hashes.end()) {
+            Sprite sprite = m_Sprites[it->second];
+            sprite.offset = min;
+            sprite.sourceSize = size;
+
+            m_Sprites.push_back(sprite);
+            m_Duplicates++;
+
+            Placement placement;
+            placement.sprite = static_cast<uint32_t>(m_Sprites.size() - 1);
+            placement.duplicate = true;
+            return placement;
+        }
+
+        uint32_t padding = m_Config.padding;
+        glm::uvec2 outer = trimmed + 2u * padding;
+        if (outer.x > m_Config.pageSize.x || outer.y > m_Config.pageSize.y) {
+            spdlog::error("Atlas sprite of {}x{} doesn't fit a {}x{} page", size.x, size.y, m_Config.pageSize.x, m_Config.pageSize.y);
+            return std::nullopt;
+        }
+
+        std::optional<glm::uvec2> position;
+        uint32_t page = 0;
+        for (; page < m_Pages.size() && !position; page++) position = m_Pages[page].insert(outer);
+
+        if (position) {
+            page--;
+        } else {
+            m_Pages.emplace_back(m_Config.pageSize);
+            position = m_Pages.back().insert(outer);
+        }
+
+        Placement placement;
+        placement.position = *position;
+        placement.size = outer;
+        placement.pixels.resize(static_cast<size_t>(outer.x) * outer.y * 4);
+
+        for (uint32_t y = 0; y < outer.y; y++) {
+            for (uint32_t x = 0; x < outer.x; x++) {
+                int sx = static_cast<int>(x) - static_cast<int>(padding);
+                int sy = static_cast<int>(y) - static_cast<int>(padding);
+
+                bool inside = sx >= 0 && sy >= 0 && sx < static_cast<int>(trimmed.x) && sy < static_cast<int>(trimmed.y);
+                if (!inside && !m_Config.extrude) continue;
+
+                sx = std::clamp(sx, 0, static_cast<int>(trimmed.x) - 1);
+                sy = std::clamp(sy, 0, static_cast<int>(trimmed.y) - 1);
+                std::copy_n(pixel(min.x + sx, min.y + sy), 4, &placement.pixels[(static_cast<size_t>(y) * outer.x + x) * 4]);
+            }
+        }
+
+        glm::uvec2 bottomLeft = *position + padding;
+        m_Sprites.push_back({ page, bottomLeft, bottomLeft + trimmed, min, size });
+
+        placement.sprite = static_cast<uint32_t>(m_Sprites.size() - 1);
+        m_Hashes.emplace(hash, placement.sprite);
+        return placement;
+    }
+
+    const AtlasPacker::Config &AtlasPacker::getConfig() const noexcept {
+        return m_Config;
+    }
+
+    const AtlasPacker::Sprite &AtlasPacker::getSprite(uint32_t sprite) const {
+        return m_Sprites[sprite];
+    }
+
+    size_t AtlasPacker::getSpriteCount() const noexcept {
+        return m_Sprites.size();
+    }
+
+    size_t AtlasPacker::getDuplicateCount() const noexcept {
+        return m_Duplicates;
+    }
+
+    size_t AtlasPacker::getPageCount() const noexcept {
+        return m_Pages.size();
+    }
+
+    float AtlasPacker::getOccupancy(uint32_t page) const {
+        return m_Pages[page].getOccupancy();
+    }
+
+    void AtlasPacker::logReport() const {
+        if (m_Pages.empty()) return;
+
+        double used = 0.0;
+        for (const auto& page : m_Pages) used += static_cast<double>(page.getUsedArea());
+        double area = static_cast<double>(m_Config.pageSize.x) * m_Config.pageSize.y * static_cast<double>(m_Pages.size());
+
+        spdlog::info("Packed {} sprites ({} duplicates) onto {} {}x{} pages, {:.1f}% occupied",
+                     m_Sprites.size(), m_Duplicates, m_Pages.size(), m_Config.pageSize.x, m_Config.pageSize.y,
+                     100.0 * used / area);
+
+        for (size_t i = 0; i < m_Pages.size(); i++) {
+            spdlog::debug("  page {}: {:.1f}%", i, 100.0f * m_Pages[i].getOccupancy());
+        }
+
+        // every unique sprite would otherwise be its own texture, and a batch break whenever it changes.
+        spdlog::info("Textures to bind for all sprites: {} -> {}", m_Sprites.size() - m_Duplicates, m_Pages.size());
+    }
+
+    TextureAtlas::TextureAtlas(const AtlasPacker::Config &config) : m_Packer(config) {}
+
+    std::shared_ptr<TextureAtlas> TextureAtlas::load(const std::filesystem::path &path) {
+        auto blob = io::read(path);
+        if (!blob) {
+            spdlog::error("Atlas {} is missing", path.string());
+            return nullptr;
+        }
+
+        std::istringstream in{ std::string(blob.getString()) };
+
+        std::string magic;
+        int version = 0;
+        in >> magic >> version;
+        if (magic != "katlas" || version != 1) {
+            spdlog::error("{} is not a version 1 atlas", path.string());
+            return nullptr;
+        }
+
+        auto atlas = create();
+
+        std::string kind;
+        while (in >> kind) {
+            if (kind == "page") {
+                std::string file;
+                in >> file;
+                atlas->m_Pages.push_back(gbl::assets->texture(path.parent_path() / file, 4));
+            } else if (kind == "sprite") {
+                uint32_t page = 0;
+                Entry entry;
+                auto& [region, offset, sourceSize] = entry;
+
+                in >> page >> region.bottomLeft.x >> region.bottomLeft.y >> region.topRight.x >> region.topRight.y
+                   >> offset.x >> offset.y >> sourceSize.x >> sourceSize.y;
+
+                std::string name;
+                std::getline(in >> std::ws, name);
+
+                if (!in || page >= atlas->m_Pages.size()) break;
+
+                region.texture = atlas->m_Pages[page];
+                atlas->m_Names[name] = static_cast<Handle>(atlas->m_Entries.size());
+                atlas->m_Entries.push_back(std::move(entry));
+            } else {
+                in.setstate(std::ios::failbit);
+                break;
+            }
+        }
+
+        if (!in.eof()) {
+            spdlog::error("Atlas {} is corrupt", path.string());
+            return nullptr;
+        }
+
+        atlas->m_PageBase = atlas->m_Pages.size();
+        return atlas;
+    }
+
+    std::optional<TextureAtlas::Handle> TextureAtlas::add(const std::string &name, const glm::uvec2 &size, std::span<const uint8_t> rgba) {
+        auto placement = m_Packer.add(size, rgba);
+        if (!placement) return std::nullopt;
+
+        const auto& sprite = m_Packer.getSprite(placement->sprite);
+        size_t page = m_PageBase + sprite.page;
+
+        while (m_Pages.size() <= page) {
+            const auto& pageSize = m_Packer.getConfig().pageSize;
+            auto texture = Texture2D::create(pageSize, TextureFormat::RGBA8);
+            glClearTexImage(texture->getHandle(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            m_Pages.push_back(std::move(texture));
+        }
+
+        if (!placement->duplicate) m_Pages[page]->subImage(placement->position, placement->size, placement->pixels.data());
+
+        auto handle = static_cast<Handle>(m_Entries.size());
+        m_Entries.push_back({ m_Pages[page]->getRegion(sprite.bottomLeft, sprite.topRight), sprite.offset, sprite.sourceSize });
+        m_Names[name] = handle;
+
+        return handle;
+    }
+
+    std::optional<TextureAtlas::Handle> TextureAtlas::add(const std::string &name, const Texture2D::Region &region) {
+        if (!region.texture->isReady()) {
+            spdlog::error("Can't add {} to an atlas before its texture finished loading", name);
+            return std::nullopt;
+        }
+
+        glm::uvec2 size = region.topRight - region.bottomLeft;
+        std::vector<uint8_t> pixels(static_cast<size_t>(size.x) * size.y * 4);
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glGetTextureSubImage(region.texture->getHandle(), 0,
+                             static_cast<int>(region.bottomLeft.x), static_cast<int>(region.bottomLeft.y), 0,
+                             static_cast<int>(size.x), static_cast<int>(size.y), 1,
+                             GL_RGBA, GL_UNSIGNED_BYTE, static_cast<int>(pixels.size()), pixels.data());
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+        return add(name, size, pixels);
+    }
+
+    std::optional<TextureAtlas::Handle> TextureAtlas::find(const std::string &name) const {
+        auto it = m_Names.find(name);
+        if (it == m_Names.end()) return std::nullopt;
+        return it->second;
+    }
+
+    const TextureAtlas::Entry &TextureAtlas::get(Handle handle) const {
+        return m_Entries[handle];
+    }
+
+    const Texture2D::Region &TextureAtlas::getRegion(Handle handle) const {
+        return m_Entries[handle].region;
+    }
+
+    const std::vector<std::shared_ptr<Texture2D>> &TextureAtlas::getPages() const noexcept {
+        return m_Pages;
+    }
+
+    size_t TextureAtlas::getCount() const noexcept {
+        return m_Entries.size();
+    }
+
+    void TextureAtlas::logReport() const {
+        if (m_PageBase > 0) spdlog::info("Atlas has {} cooked pages", m_PageBase);
+        m_Packer.logReport();
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "kat/engine.hpp"
+#include "kat/graphics/texture.hpp"
+
+#include <optional>
+#include <span>
+#include <unordered_map>
+
+namespace kat {
+
+    // MaxRects bin packing with the best short side fit heuristic. Doesn't touch GL, the cooker uses it too.
+    class RectPacker {
+    public:
+        explicit RectPacker(const glm::uvec2& size);
+
+        // bottom left corner of the placed rect, empty when it doesn't fit anywhere.
+        std::optional<glm::uvec2> insert(const glm::uvec2& size);
+
+        [[nodiscard]] const glm::uvec2& getSize() const noexcept;
+        [[nodiscard]] uint64_t getUsedArea() const noexcept;
+        [[nodiscard]] float getOccupancy() const noexcept;
+
+    private:
+        struct Rect {
+            uint32_t x, y, w, h;
+
+            bool operator==(const Rect&) const = default;
+        };
+
+        glm::uvec2 m_Size;
+        std::vector<Rect> m_Free;
+        uint64_t m_Used = 0;
+    };
+
+    // Decides where sprites go in an atlas, without owning any pixels of its own.
+    //
+    // Sprites are RGBA8, rows bottom to top like everything uploaded to GL. Fully transparent borders are trimmed
+    // off, sprites whose trimmed pixels hash the same share one spot, and every placed sprite is surrounded by
+    // padding filled with its own edge pixels so Nearest and Linear sampling at the edges never bleed.
+    class AtlasPacker {
+    public:
+        struct Config {
+            glm::uvec2 pageSize = { 2048, 2048 };
+            uint32_t padding = 1;
+            bool extrude = true;    // fill the padding with edge pixels instead of leaving it transparent
+            bool trim = true;
+        };
+
+        struct Sprite {
+            uint32_t page;
+            glm::uvec2 bottomLeft;      // of the trimmed pixels within the page
+            glm::uvec2 topRight;
+            glm::uvec2 offset;          // of the trimmed pixels within the source image
+            glm::uvec2 sourceSize;
+        };
+
+        // what to write into the page, padding included. duplicates have nothing to write.
+        struct Placement {
+            uint32_t sprite;
+            bool duplicate = false;
+            glm::uvec2 position{};
+            glm::uvec2 size{};
+            std::vector<uint8_t> pixels;
+        };
+
+        AtlasPacker();
+        explicit AtlasPacker(const Config& config);
+
+        // empty when the sprite is larger than a page.
+        std::optional<Placement> add(const glm::uvec2& size, std::span<const uint8_t> rgba);
+
+        [[nodiscard]] const Config& getConfig() const noexcept;
+        [[nodiscard]] const Sprite& getSprite(uint32_t sprite) const;
+        [[nodiscard]] size_t getSpriteCount() const noexcept;
+        [[nodiscard]] size_t getDuplicateCount() const noexcept;
+        [[nodiscard]] size_t getPageCount() const noexcept;
+        [[nodiscard]] float getOccupancy(uint32_t page) const;
+
+        // occupancy, and how many texture binds packing saves when each unique sprite was its own texture.
+        void logReport() const;
+
+    private:
+        Config m_Config;
+        std::vector<RectPacker> m_Pages;
+        std::vector<Sprite> m_Sprites;
+        std::unordered_map<uint64_t, uint32_t> m_Hashes;
+        size_t m_Duplicates = 0;
+    };
+
+    // Packs sprites into a few large textures at runtime, e.g. for generated glyphs or portraits, or loads an atlas
+    // made by the cooker. Sprites are never moved once placed, so handles and regions stay valid for the atlas'
+    // lifetime.
+    class TextureAtlas {
+    public:
+        using Handle = uint32_t;
+
+        struct Entry {
+            Texture2D::Region region;   // of the trimmed pixels
+            glm::uvec2 offset;          // of the trimmed pixels within the source image
+            glm::uvec2 sourceSize;
+        };
+
+        inline static std::shared_ptr<TextureAtlas> create() {
+            return create(AtlasPacker::Config{});
+        };
+
+        inline static std::shared_ptr<TextureAtlas> create(const AtlasPacker::Config& config) {
+            return std::shared_ptr<TextureAtlas>(new TextureAtlas(config));
+        };
+
+        // a .katlas written by the cooker, empty on failure. sprites added later go onto new pages. it is text:
+        //
+        //   katlas 1
+        //   page <png, relative to the .katlas>
+        //   sprite <page> <bottom left x y> <top right x y> <offset x y> <source size x y> <name, to the line end>
+        static std::shared_ptr<TextureAtlas> load(const std::filesystem::path& path);
+
+        // GL thread. empty when the sprite is larger than a page.
+        std::optional<Handle> add(const std::string& name, const glm::uvec2& size, std::span<const uint8_t> rgba);
+
+        // copies a region of another texture in, which reads it back from the GPU. meant for load time.
+        std::optional<Handle> add(const std::string& name, const Texture2D::Region& region);
+
+        [[nodiscard]] std::optional<Handle> find(const std::string& name) const;
+        [[nodiscard]] const Entry& get(Handle handle) const;
+        [[nodiscard]] const Texture2D::Region& getRegion(Handle handle) const;
+
+        [[nodiscard]] const std::vector<std::shared_ptr<Texture2D>>& getPages() const noexcept;
+        [[nodiscard]] size_t getCount() const noexcept;
+
+        void logReport() const;
+
+    private:
+        explicit TextureAtlas(const AtlasPacker::Config& config);
+
+        AtlasPacker m_Packer;
+        size_t m_PageBase = 0;  // cooked pages come first, the packer only knows about the ones after them
+
+        std::vector<std::shared_ptr<Texture2D>> m_Pages;
+        std::vector<Entry> m_Entries;
+        std::unordered_map<std::string, Handle> m_Names;
+    };
+}
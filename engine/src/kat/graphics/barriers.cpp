@@ -0,0 +1,46 @@
+#include "barriers.hpp"
+
+#include <bit>
+
+namespace kat {
+    void BarrierTracker::written(ResourceKind kind, unsigned int handle) {
+        m_Writes[keyOf(kind, handle)] = ++m_Epoch;
+    }
+
+    void BarrierTracker::require(ResourceKind kind, unsigned int handle, BarrierUsage usage) {
+        auto bit = static_cast<GLbitfield>(usage);
+        size_t index = std::countr_zero(bit);
+
+        // nothing was written since this bit was last issued, which is the common case.
+        if (m_BarrierEpochs[index] >= m_Epoch) {
+            m_Stats.skipped++;
+            return;
+        }
+
+        auto it = m_Writes.find(keyOf(kind, handle));
+        if (it == m_Writes.end() || it->second <= m_BarrierEpochs[index]) {
+            m_Stats.skipped++;
+            return;
+        }
+
+        glMemoryBarrier(bit);
+        m_BarrierEpochs[index] = m_Epoch;
+        m_Stats.barriers++;
+    }
+
+    void BarrierTracker::forget(ResourceKind kind, unsigned int handle) {
+        m_Writes.erase(keyOf(kind, handle));
+    }
+
+    const BarrierTracker::Stats &BarrierTracker::getStats() const noexcept {
+        return m_Stats;
+    }
+
+    void BarrierTracker::resetStats() {
+        m_Stats = Stats{};
+    }
+
+    uint64_t BarrierTracker::keyOf(ResourceKind kind, unsigned int handle) {
+        return (static_cast<uint64_t>(kind) << 32) | handle;
+    }
+}
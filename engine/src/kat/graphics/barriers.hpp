@@ -0,0 +1,78 @@
+#pragma once
+
+#include "kat/engine.hpp"
+
+#include <array>
+#include <unordered_map>
+
+namespace kat {
+
+    enum class Access {
+        Read = GL_READ_ONLY,
+        Write = GL_WRITE_ONLY,
+        ReadWrite = GL_READ_WRITE
+    };
+
+    constexpr bool reads(Access access) { return access != Access::Write; }
+    constexpr bool writes(Access access) { return access != Access::Read; }
+
+    // How a resource is consumed after a shader wrote to it, each one is a glMemoryBarrier bit.
+    enum class BarrierUsage : GLbitfield {
+        VertexAttrib = GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT,
+        ElementArray = GL_ELEMENT_ARRAY_BARRIER_BIT,
+        Uniform = GL_UNIFORM_BARRIER_BIT,
+        TextureFetch = GL_TEXTURE_FETCH_BARRIER_BIT,
+        ImageAccess = GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+        Command = GL_COMMAND_BARRIER_BIT,
+        PixelBuffer = GL_PIXEL_BUFFER_BARRIER_BIT,
+        TextureUpdate = GL_TEXTURE_UPDATE_BARRIER_BIT,
+        BufferUpdate = GL_BUFFER_UPDATE_BARRIER_BIT,
+        Framebuffer = GL_FRAMEBUFFER_BARRIER_BIT,
+        TransformFeedback = GL_TRANSFORM_FEEDBACK_BARRIER_BIT,
+        AtomicCounter = GL_ATOMIC_COUNTER_BARRIER_BIT,
+        Storage = GL_SHADER_STORAGE_BARRIER_BIT,
+        ClientMappedBuffer = GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT,
+        QueryBuffer = GL_QUERY_BUFFER_BARRIER_BIT
+    };
+
+    enum class ResourceKind {
+        Buffer, Texture
+    };
+
+    // Inserts the minimal glMemoryBarrier between an incoherent (shader storage / image) write and its next consumer.
+    //
+    // Writes and barriers are stamped with a running epoch. A consumer only needs a barrier for its bit when the
+    // resource was written after the last time that bit was issued, since a barrier covers every write before it.
+    class BarrierTracker {
+    public:
+        static constexpr size_t BARRIER_BITS = 16;
+
+        struct Stats {
+            size_t barriers = 0;     // glMemoryBarrier calls
+            size_t skipped = 0;      // consumers which were already covered
+        };
+
+        void written(ResourceKind kind, unsigned int handle);
+        void require(ResourceKind kind, unsigned int handle, BarrierUsage usage);
+
+        // for when a GL name gets deleted, so its reuse doesn't inherit a pending write.
+        void forget(ResourceKind kind, unsigned int handle);
+
+        [[nodiscard]] const Stats& getStats() const noexcept;
+        void resetStats();
+
+    private:
+        static uint64_t keyOf(ResourceKind kind, unsigned int handle);
+
+        uint64_t m_Epoch = 0;
+        std::unordered_map<uint64_t, uint64_t> m_Writes;
+        std::array<uint64_t, BARRIER_BITS> m_BarrierEpochs{};
+
+        Stats m_Stats;
+    };
+
+    namespace gbl {
+        // GL thread only.
+        inline BarrierTracker barriers;
+    }
+}
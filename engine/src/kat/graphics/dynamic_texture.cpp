@@ -0,0 +1,203 @@
+#include "dynamic_texture.hpp"
+
+#include <cstring>
+
+namespace kat {
+    namespace {
+        // all dynamic textures together, a few frames of painting at most.
+        constexpr size_t STAGING_CAPACITY = 4 * 1024 * 1024;
+
+        PixelDataType uploadTypeOf(TextureFormat format) {
+            if (auto type = pixelDataTypeOf(format)) return *type;
+            throw std::invalid_argument("dynamic textures need 8 bit or 32F colour formats");
+        }
+
+        DynamicTexture2D::Rect unite(const DynamicTexture2D::Rect& a, const DynamicTexture2D::Rect& b) {
+            return { glm::min(a.min, b.min), glm::max(a.max, b.max) };
+        }
+
+        // overlapping or sharing an edge.
+        bool touches(const DynamicTexture2D::Rect& a, const DynamicTexture2D::Rect& b) {
+            return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+        }
+
+        // texels the union uploads that neither rect needed (overlap counted once).
+        int64_t wasteOf(const DynamicTexture2D::Rect& a, const DynamicTexture2D::Rect& b) {
+            auto lo = glm::max(a.min, b.min), hi = glm::min(a.max, b.max);
+            uint64_t overlap = lo.x < hi.x && lo.y < hi.y ? static_cast<uint64_t>(hi.x - lo.x) * (hi.y - lo.y) : 0;
+            return static_cast<int64_t>(unite(a, b).getArea()) - static_cast<int64_t>(a.getArea() + b.getArea() - overlap);
+        }
+    }
+
+    uint64_t DynamicTexture2D::Rect::getArea() const noexcept {
+        return static_cast<uint64_t>(max.x - min.x) * (max.y - min.y);
+    }
+
+    DynamicTexture2D::DynamicTexture2D(const glm::uvec2 &size, TextureFormat format)
+            : m_Size(size), m_Format(format), m_DataType(uploadTypeOf(format)), m_TexelSize(bytesPerPixel(format)),
+              m_Pixels(static_cast<size_t>(size.x) * size.y * m_TexelSize) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        m_Texture = Texture2D::create(size, format, m_Pixels.data(), m_DataType);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+
+    std::span<std::byte> DynamicTexture2D::getPixels() noexcept {
+        return m_Pixels;
+    }
+
+    void DynamicTexture2D::write(const glm::uvec2 &offset, const glm::uvec2 &size, const void *data) {
+        auto rect = clip(offset, size);
+        if (!rect) return;
+
+        auto* src = static_cast<const std::byte*>(data);
+        size_t rowBytes = (rect->max.x - rect->min.x) * m_TexelSize;
+        for (uint32_t y = rect->min.y; y < rect->max.y; y++) {
+            const std::byte* row = src + ((y - offset.y) * static_cast<size_t>(size.x) + (rect->min.x - offset.x)) * m_TexelSize;
+            std::memcpy(&m_Pixels[(y * static_cast<size_t>(m_Size.x) + rect->min.x) * m_TexelSize], row, rowBytes);
+        }
+
+        markDirty(rect->min, rect->max - rect->min);
+    }
+
+    void DynamicTexture2D::fill(const glm::uvec2 &offset, const glm::uvec2 &size, const void *texel) {
+        auto rect = clip(offset, size);
+        if (!rect) return;
+
+        for (uint32_t y = rect->min.y; y < rect->max.y; y++) {
+            std::byte* row = &m_Pixels[(y * static_cast<size_t>(m_Size.x) + rect->min.x) * m_TexelSize];
+            for (uint32_t x = rect->min.x; x < rect->max.x; x++, row += m_TexelSize) std::memcpy(row, texel, m_TexelSize);
+        }
+
+        markDirty(rect->min, rect->max - rect->min);
+    }
+
+    void DynamicTexture2D::setTexel(const glm::uvec2 &position, const void *texel) {
+        write(position, glm::uvec2(1, 1), texel);
+    }
+
+    void DynamicTexture2D::markDirty(const glm::uvec2 &offset, const glm::uvec2 &size) {
+        auto clipped = clip(offset, size);
+        if (!clipped) return;
+
+        // swallow whatever the new rect touches, as long as the union doesn't upload more than the two apart.
+        Rect rect = *clipped;
+        for (bool merged = true; merged;) {
+            merged = false;
+            for (auto it = m_Dirty.begin(); it != m_Dirty.end(); ++it) {
+                if (touches(*it, rect) && wasteOf(*it, rect) <= 0) {
+                    rect = unite(*it, rect);
+                    m_Dirty.erase(it);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+        m_Dirty.push_back(rect);
+
+        // over the cap, merge the pair that grows the upload the least. fewer calls beat a few extra texels.
+        while (m_Dirty.size() > MAX_DIRTY_RECTS) {
+            size_t first = 0, second = 1;
+            int64_t best = std::numeric_limits<int64_t>::max();
+            for (size_t i = 0; i < m_Dirty.size(); i++) {
+                for (size_t j = i + 1; j < m_Dirty.size(); j++) {
+                    auto waste = wasteOf(m_Dirty[i], m_Dirty[j]);
+                    if (waste < best) {
+                        best = waste;
+                        first = i;
+                        second = j;
+                    }
+                }
+            }
+
+            m_Dirty[first] = unite(m_Dirty[first], m_Dirty[second]);
+            m_Dirty.erase(m_Dirty.begin() + static_cast<ptrdiff_t>(second));
+        }
+    }
+
+    void DynamicTexture2D::markAllDirty() {
+        m_Dirty.clear();
+        m_Dirty.push_back({ glm::uvec2(0), m_Size });
+    }
+
+    void DynamicTexture2D::flush() {
+        if (m_Dirty.empty()) return;
+
+        s_Staging->retire();
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (const auto& rect : m_Dirty) upload(rect);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        s_Staging->fence();
+
+        m_Stats.flushes++;
+        m_Stats.rects += m_Dirty.size();
+        m_Dirty.clear();
+    }
+
+    void DynamicTexture2D::upload(const Rect &rect) {
+        glm::uvec2 size = rect.max - rect.min;
+        size_t rowBytes = size.x * m_TexelSize;
+        size_t stride = m_Size.x * m_TexelSize;
+        const std::byte* first = &m_Pixels[rect.min.y * stride + rect.min.x * m_TexelSize];
+
+        m_Stats.bytes += rowBytes * size.y;
+
+        auto staged = s_Staging->allocate(rowBytes * size.y);
+        if (!staged) {
+            // ring is full of earlier frames still in flight, let the driver copy out of the shadow.
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<int>(m_Size.x));
+            m_Texture->subImage(rect.min, size, first, m_DataType);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+            m_Stats.directUploads++;
+            return;
+        }
+
+        auto* dst = static_cast<std::byte*>(staged->pointer);
+        if (rowBytes == stride) {
+            std::memcpy(dst, first, rowBytes * size.y);
+        } else {
+            for (uint32_t y = 0; y < size.y; y++) std::memcpy(dst + y * rowBytes, first + y * stride, rowBytes);
+        }
+
+        // with an unpack buffer bound the pointer is an offset into it.
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s_Staging->getHandle());
+        m_Texture->subImage(rect.min, size, reinterpret_cast<const void*>(staged->offset), m_DataType);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    std::optional<DynamicTexture2D::Rect> DynamicTexture2D::clip(const glm::uvec2 &offset, const glm::uvec2 &size) const {
+        Rect rect{ glm::min(offset, m_Size), glm::min(offset + size, m_Size) };
+        if (rect.min.x >= rect.max.x || rect.min.y >= rect.max.y) return std::nullopt;
+        return rect;
+    }
+
+    const std::shared_ptr<Texture2D> &DynamicTexture2D::getTexture() const noexcept {
+        return m_Texture;
+    }
+
+    const glm::uvec2 &DynamicTexture2D::getSize() const noexcept {
+        return m_Size;
+    }
+
+    TextureFormat DynamicTexture2D::getFormat() const noexcept {
+        return m_Format;
+    }
+
+    const std::vector<DynamicTexture2D::Rect> &DynamicTexture2D::getDirtyRects() const noexcept {
+        return m_Dirty;
+    }
+
+    const DynamicTexture2D::Stats &DynamicTexture2D::getStats() const noexcept {
+        return m_Stats;
+    }
+
+    void DynamicTexture2D::init() {
+        s_Staging = std::make_unique<StagingRing>(STAGING_CAPACITY);
+    }
+
+    void DynamicTexture2D::cleanup() {
+        s_Staging = nullptr;
+    }
+}
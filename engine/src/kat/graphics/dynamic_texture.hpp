@@ -0,0 +1,84 @@
+#pragma once
+
+#include "kat/engine.hpp"
+#include "kat/graphics/staging.hpp"
+#include "kat/graphics/texture.hpp"
+
+#include <optional>
+#include <span>
+
+namespace kat {
+
+    // A texture edited on the CPU every so often, e.g. fog of war, a minimap, painted decals or a light map.
+    //
+    // Edits go to a CPU copy and mark the rectangles they touch. Overlapping and neighbouring rectangles are merged
+    // as they come in, and the set is capped at a handful, so flush() only sends the changed regions over the bus and
+    // in a few calls. Uploads go through a staging ring shared by all dynamic textures.
+    //
+    // Editing and flushing aren't synchronised, keep both on the thread owning the GL context.
+    class DynamicTexture2D {
+    public:
+        static constexpr size_t MAX_DIRTY_RECTS = 8;
+
+        struct Rect {
+            glm::uvec2 min;
+            glm::uvec2 max;     // exclusive
+
+            [[nodiscard]] uint64_t getArea() const noexcept;
+        };
+
+        struct Stats {
+            size_t flushes = 0;
+            size_t rects = 0;
+            size_t bytes = 0;
+            size_t directUploads = 0;  // the staging ring was full, the rect went through client memory
+        };
+
+        // 8 bit formats (RGBA8, RGB8, RG8, R8, R8UI) and the 32F ones, everything starts zeroed.
+        inline static std::shared_ptr<DynamicTexture2D> create(const glm::uvec2& size, TextureFormat format = TextureFormat::RGBA8) {
+            return std::shared_ptr<DynamicTexture2D>(new DynamicTexture2D(size, format));
+        };
+
+        // rows bottom to top, tightly packed. mark what you change through this with markDirty.
+        [[nodiscard]] std::span<std::byte> getPixels() noexcept;
+
+        // data is tightly packed rows of size.x texels. clipped to the texture.
+        void write(const glm::uvec2& offset, const glm::uvec2& size, const void* data);
+        void fill(const glm::uvec2& offset, const glm::uvec2& size, const void* texel);
+        void setTexel(const glm::uvec2& position, const void* texel);
+
+        void markDirty(const glm::uvec2& offset, const glm::uvec2& size);
+        void markAllDirty();
+
+        // uploads the dirty rects, once per frame before the texture is drawn. GL thread.
+        void flush();
+
+        [[nodiscard]] const std::shared_ptr<Texture2D>& getTexture() const noexcept;
+        [[nodiscard]] const glm::uvec2& getSize() const noexcept;
+        [[nodiscard]] TextureFormat getFormat() const noexcept;
+        [[nodiscard]] const std::vector<Rect>& getDirtyRects() const noexcept;
+        [[nodiscard]] const Stats& getStats() const noexcept;
+
+        static void init();
+        static void cleanup();
+
+    private:
+        DynamicTexture2D(const glm::uvec2& size, TextureFormat format);
+
+        // clipped to the texture, empty when nothing is left.
+        [[nodiscard]] std::optional<Rect> clip(const glm::uvec2& offset, const glm::uvec2& size) const;
+        void upload(const Rect& rect);
+
+        glm::uvec2 m_Size;
+        TextureFormat m_Format;
+        PixelDataType m_DataType;
+        size_t m_TexelSize;
+
+        std::vector<std::byte> m_Pixels;
+        std::vector<Rect> m_Dirty;
+        std::shared_ptr<Texture2D> m_Texture;
+        Stats m_Stats;
+
+        static inline std::unique_ptr<StagingRing> s_Staging;
+    };
+}
@@ -0,0 +1,76 @@
+#include "gpu_culling.hpp"
+
+#include <algorithm>
+
+namespace kat {
+    constexpr unsigned int CULL_GROUP_SIZE = 256;
+
+    GpuCuller::GpuCuller(const std::shared_ptr<StaticBatcher> &batcher, std::vector<Instance> instances)
+            : m_Batcher(batcher), m_InstanceCount(instances.size()) {
+        m_CullShader = std::make_unique<ComputeShader>(embed::shaders::culling::computeSrc);
+        m_DrawShader = kat::GraphicsShader::createUnique(
+                { std::pair{ ShaderType::Vertex, embed::shaders::culling::vertexSrc },
+                  std::pair{ ShaderType::Fragment, embed::shaders::culling::fragmentSrc }});
+
+        // group instances by mesh, each group becomes one indirect command owning that range of the visible list.
+        std::stable_sort(instances.begin(), instances.end(), [](const Instance& a, const Instance& b) {
+            return a.mesh < b.mesh;
+        });
+
+        for (size_t i = 0; i < instances.size(); i++) {
+            if (i == 0 || instances[i].mesh != instances[i - 1].mesh) {
+                const auto& record = m_Batcher->getRecord(instances[i].mesh);
+                m_CommandTemplate.push_back({record.indexCount, 0, record.firstIndex, record.baseVertex, static_cast<uint32_t>(i)});
+            }
+            instances[i].mesh = static_cast<uint32_t>(m_CommandTemplate.size() - 1);
+        }
+
+        m_Instances = std::make_unique<StorageBuffer>(std::max<size_t>(instances.size(), 1) * sizeof(Instance), instances.data(), BufferUsage::StaticDraw);
+        m_Visible = std::make_unique<StorageBuffer>(std::max<size_t>(instances.size(), 1) * sizeof(uint32_t), nullptr, BufferUsage::DynamicCopy);
+        m_Commands = std::make_unique<IndirectBuffer>(std::max<size_t>(m_CommandTemplate.size(), 1) * sizeof(DrawElementsIndirectCommand),
+                                                      m_CommandTemplate.data(), BufferUsage::DynamicDraw);
+
+        m_VertexArray = std::make_unique<VertexArray>();
+        m_VertexArray->bindVertexBuffer(m_Batcher->getVertexBuffer(), StandardVertex::ATTRIBUTES);
+        m_VertexArray->bindElementBuffer(m_Batcher->getIndexBuffer());
+        m_VertexArray->bindInstanceBuffer(m_Visible->getHandle());
+    }
+
+    void GpuCuller::cull(const glm::vec4 &cameraRect) {
+        if (m_InstanceCount == 0) return;
+
+        m_Commands->subData(m_CommandTemplate);
+
+        m_CullShader->bindStorageBuffer(0, *m_Instances, Access::Read);
+        m_CullShader->bindStorageBuffer(1, *m_Commands, Access::ReadWrite);
+        m_CullShader->bindStorageBuffer(2, *m_Visible, Access::Write);
+        m_CullShader->setVec4f("uCameraRect", cameraRect);
+        m_CullShader->setUnsignedInt("uInstanceCount", static_cast<unsigned int>(m_InstanceCount));
+
+        // the barriers for reading the commands as indirect args and the visible list as an instanced attribute
+        // are inserted by the draw.
+        m_CullShader->dispatch(static_cast<unsigned int>((m_InstanceCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE), 1, 1);
+    }
+
+    void GpuCuller::draw(const std::shared_ptr<Texture2D> &texture) {
+        if (m_InstanceCount == 0) return;
+
+        // the batcher may have grown into new buffers since the last frame.
+        m_VertexArray->replaceVertexBuffer(0, m_Batcher->getVertexBuffer()->getHandle(), sizeof(StandardVertex));
+        m_VertexArray->bindElementBuffer(m_Batcher->getIndexBuffer());
+
+        m_DrawShader->bind();
+        m_DrawShader->bindTexture("uTexture", 0, texture);
+        m_DrawShader->bindStorageBuffer(0, *m_Instances);
+
+        m_VertexArray->multiDrawElementsIndirect(m_Batcher->getPrimitive(), *m_Commands, m_CommandTemplate.size());
+    }
+
+    size_t GpuCuller::getInstanceCount() const noexcept {
+        return m_InstanceCount;
+    }
+
+    size_t GpuCuller::getCommandCount() const noexcept {
+        return m_CommandTemplate.size();
+    }
+}
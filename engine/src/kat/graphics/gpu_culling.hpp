@@ -0,0 +1,107 @@
+#pragma once
+
+#include "kat/engine.hpp"
+#include "kat/graphics/mesh.hpp"
+#include "kat/graphics/shader.hpp"
+#include "kat/graphics/static_batch.hpp"
+#include "kat/graphics/texture.hpp"
+
+namespace kat {
+
+    namespace embed::shaders::culling {
+        // one invocation per instance, visible ones are appended to their command's range of the visible list.
+        const std::string computeSrc = "#version 430 core\n"
+                                       "layout(local_size_x = 256) in;\n"
+                                       "struct Instance { vec4 bounds; vec4 uvRect; uint command; uint layer; uint pad0; uint pad1; };\n"
+                                       "struct Command { uint count; uint instanceCount; uint firstIndex; int baseVertex; uint baseInstance; };\n"
+                                       "layout(std430, binding = 0) readonly buffer Instances { Instance instances[]; };\n"
+                                       "layout(std430, binding = 1) buffer Commands { Command commands[]; };\n"
+                                       "layout(std430, binding = 2) writeonly buffer Visible { uint visible[]; };\n"
+                                       "uniform vec4 uCameraRect;\n"
+                                       "uniform uint uInstanceCount;\n"
+                                       "void main() {\n"
+                                       "    uint i = gl_GlobalInvocationID.x;\n"
+                                       "    if (i >= uInstanceCount) return;\n"
+                                       "    vec4 b = instances[i].bounds;\n"
+                                       "    if (b.z < uCameraRect.x || b.x > uCameraRect.z || b.w < uCameraRect.y || b.y > uCameraRect.w) return;\n"
+                                       "    uint c = instances[i].command;\n"
+                                       "    uint slot = atomicAdd(commands[c].instanceCount, 1u);\n"
+                                       "    visible[commands[c].baseInstance + slot] = i;\n"
+                                       "}";
+
+        // the instance index comes in through an instanced attribute, which honours baseInstance without needing
+        // shader draw parameters.
+        const std::string vertexSrc = "#version 430 core\n"
+                                      "layout(location=0) in vec3 vPosition;\n"
+                                      "layout(location=1) in vec2 vTexCoord;\n"
+                                      "layout(location=2) in vec4 vTint;\n"
+                                      "layout(location=3) in vec3 vNormal;\n"
+                                      "layout(location=4) in uint vInstance;\n"
+                                      "struct Instance { vec4 bounds; vec4 uvRect; uint command; uint layer; uint pad0; uint pad1; };\n"
+                                      "layout(std430, binding = 0) readonly buffer Instances { Instance instances[]; };\n"
+                                      "out vec2 fUV;\n"
+                                      "uniform mat4 uTransform;\n"
+                                      "void main() {\n"
+                                      "    Instance inst = instances[vInstance];\n"
+                                      "    vec2 world = mix(inst.bounds.xy, inst.bounds.zw, vPosition.xy);\n"
+                                      "    gl_Position = uTransform * vec4(world, vPosition.z, 1.0);\n"
+                                      "    fUV = mix(inst.uvRect.xy, inst.uvRect.zw, vTexCoord);\n"
+                                      "}";
+
+        const std::string fragmentSrc = "#version 430 core\n"
+                                        "in vec2 fUV;\n"
+                                        "out vec4 colorOut;\n"
+                                        "uniform sampler2D uTexture;\n"
+                                        "void main() {\n"
+                                        "    colorOut = texture(uTexture, fUV);\n"
+                                        "}";
+    }
+
+    // GPU driven culling for large amounts of static decorations. Instances are uploaded once, then each frame a
+    // compute pass tests them against the camera rect and writes the visible ones, plus the instance counts of the
+    // indirect draws, without the CPU ever looking at an instance.
+    //
+    // Instance geometry comes from a StaticBatcher. A mesh's unit square ([0, 1] on x and y) is stretched over the
+    // instance bounds, and its texture coordinates over the instance uv rect.
+    class GpuCuller {
+    public:
+
+        // matches the std430 layout in the shaders.
+        struct Instance {
+            glm::vec4 bounds; // world space min.xy, max.xy
+            glm::vec4 uvRect; // min uv, max uv
+            uint32_t mesh;    // StaticBatcher handle, replaced with the command index on upload
+            uint32_t layer = 0;
+            uint32_t pad0 = 0;
+            uint32_t pad1 = 0;
+        };
+
+        GpuCuller(const std::shared_ptr<StaticBatcher>& batcher, std::vector<Instance> instances);
+
+        // cameraRect is min.xy, max.xy in world space.
+        void cull(const glm::vec4& cameraRect);
+
+        // draws whatever the last cull left visible.
+        void draw(const std::shared_ptr<Texture2D>& texture);
+
+        [[nodiscard]] size_t getInstanceCount() const noexcept;
+        [[nodiscard]] size_t getCommandCount() const noexcept;
+
+    private:
+        std::shared_ptr<StaticBatcher> m_Batcher;
+
+        std::unique_ptr<ComputeShader> m_CullShader;
+        std::unique_ptr<GraphicsShader> m_DrawShader;
+
+        std::unique_ptr<StorageBuffer> m_Instances;
+        std::unique_ptr<StorageBuffer> m_Visible;
+        std::unique_ptr<IndirectBuffer> m_Commands;
+
+        // commands with zeroed instance counts, re-uploaded before each cull.
+        std::vector<DrawElementsIndirectCommand> m_CommandTemplate;
+
+        std::unique_ptr<VertexArray> m_VertexArray;
+
+        size_t m_InstanceCount;
+    };
+}
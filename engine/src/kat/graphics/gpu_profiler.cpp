@@ -0,0 +1,217 @@
+#include "gpu_profiler.hpp"
+
+#include "kat/util/clock.hpp"
+
+#include <algorithm>
+
+namespace kat {
+    GpuProfiler::Zone::Zone(const char *name) : m_Profiler(gbl::gpuProfiler.get()), m_Index(NO_ZONE) {
+        if (m_Profiler) m_Index = m_Profiler->begin(name);
+    }
+
+    GpuProfiler::Zone::~Zone() {
+        if (m_Profiler) m_Profiler->end(m_Index);
+    }
+
+    GpuProfiler::GpuProfiler() : GpuProfiler(Config{}) {}
+
+    GpuProfiler::GpuProfiler(const Config &config) : m_Config(config), m_Frames(std::max<size_t>(config.frames, 2)) {
+        m_Config.maxZones = std::max<size_t>(m_Config.maxZones, 1);
+        m_Config.window = std::max<size_t>(m_Config.window, 1);
+
+        for (auto& frame : m_Frames) {
+            frame.queries.resize(m_Config.maxZones * 2);
+            frame.names.resize(m_Config.maxZones);
+            frame.ended.resize(m_Config.maxZones);
+            glCreateQueries(GL_TIMESTAMP, static_cast<int>(frame.queries.size()), frame.queries.data());
+        }
+
+        if (profiler::isEnabled()) m_Track.emplace("gpu");
+    }
+
+    GpuProfiler::~GpuProfiler() {
+        for (auto& frame : m_Frames) glDeleteQueries(static_cast<int>(frame.queries.size()), frame.queries.data());
+    }
+
+    size_t GpuProfiler::begin(const char *name) {
+        if (!m_Open) open();
+
+        Frame& frame = m_Frames[m_Current];
+        if (frame.zones == m_Config.maxZones) {
+            m_Stats.overflowed++;
+            return NO_ZONE;
+        }
+
+        size_t zone = frame.zones++;
+        frame.names[zone] = name;
+        frame.ended[zone] = false;
+        frame.last = frame.queries[zone * 2];
+        glQueryCounter(frame.last, GL_TIMESTAMP);
+        return zone;
+    }
+
+    void GpuProfiler::end(size_t zone) {
+        if (zone == NO_ZONE || !m_Open) return;
+
+        Frame& frame = m_Frames[m_Current];
+        if (zone >= frame.zones || frame.ended[zone]) return;
+
+        frame.ended[zone] = true;
+        frame.last = frame.queries[zone * 2 + 1];
+        glQueryCounter(frame.last, GL_TIMESTAMP);
+    }
+
+    void GpuProfiler::endFrame() {
+        if (m_Open) {
+            Frame& frame = m_Frames[m_Current];
+
+            // a zone left open still needs its end written, or the frame would never become available.
+            for (size_t i = 0; i < frame.zones; i++) {
+                if (!frame.ended[i]) end(i);
+            }
+
+            frame.pending = true;
+            frame.number = m_FrameNumber;
+            m_Current = (m_Current + 1) % m_Frames.size();
+            m_Open = false;
+        }
+        m_FrameNumber++;
+
+        // oldest first, the GPU finishes them in order.
+        for (size_t i = 0; i < m_Frames.size(); i++) {
+            Frame& frame = m_Frames[(m_Current + i) % m_Frames.size()];
+            if (!frame.pending) continue;
+            if (!isAvailable(frame)) break;
+
+            resolve(frame);
+        }
+    }
+
+    util::FrameStats::Summary GpuProfiler::getPass(std::string_view name) const {
+        auto it = std::find_if(m_Passes.begin(), m_Passes.end(), [&](const Pass& p) { return p.name == name; });
+        if (it == m_Passes.end()) return {};
+
+        size_t count = static_cast<size_t>(std::min<uint64_t>(it->written, it->ring.size()));
+        return util::FrameStats::summarize({ it->ring.begin(), it->ring.begin() + static_cast<ptrdiff_t>(count) });
+    }
+
+    std::vector<std::string_view> GpuProfiler::getPassNames() const {
+        std::vector<std::string_view> names;
+        for (const auto& pass : m_Passes) names.emplace_back(pass.name);
+        return names;
+    }
+
+    const GpuProfiler::Stats &GpuProfiler::getStats() const noexcept {
+        return m_Stats;
+    }
+
+    void GpuProfiler::logStats() const {
+        for (const auto& pass : m_Passes) {
+            auto summary = getPass(pass.name);
+            spdlog::info("gpu {}: {:.3f}ms mean, p50 {:.3f} / p95 {:.3f} / p99 {:.3f} / max {:.3f}ms (last {})", pass.name,
+                         summary.mean * 1000.0, summary.p50 * 1000.0, summary.p95 * 1000.0, summary.p99 * 1000.0,
+                         summary.max * 1000.0, summary.count);
+        }
+
+        spdlog::info("gpu profiler: {} frames, {} resolved, {} dropped, {} zones over the limit, up to {} frames late",
+                     m_Stats.frames, m_Stats.resolved, m_Stats.dropped, m_Stats.overflowed, m_Stats.longestLatency);
+    }
+
+    void GpuProfiler::open() {
+        Frame& frame = m_Frames[m_Current];
+
+        // every set is still in flight, give up on the oldest rather than wait for it.
+        if (frame.pending) {
+            frame.pending = false;
+            m_Stats.dropped++;
+        }
+
+        // the current gpu time next to the cpu's, so the frame's timestamps can be moved onto the cpu timeline.
+        int64_t gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        auto cpuNow = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        frame.offset = cpuNow - gpuNow;
+        frame.zones = 0;
+        frame.last = 0;
+        m_Open = true;
+        m_Stats.frames++;
+    }
+
+    bool GpuProfiler::isAvailable(const Frame &frame) const {
+        if (frame.zones == 0) return true;
+
+        int available = 0;
+        glGetQueryObjectiv(frame.last, GL_QUERY_RESULT_AVAILABLE, &available);
+        return available != 0;
+    }
+
+    void GpuProfiler::resolve(Frame &frame) {
+        frame.pending = false;
+        m_Stats.resolved++;
+        m_Stats.longestLatency = std::max(m_Stats.longestLatency, m_FrameNumber - frame.number);
+        if (frame.zones == 0) return;
+
+        std::vector<uint64_t> times(frame.zones * 2);
+        for (size_t i = 0; i < times.size(); i++) glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &times[i]);
+
+        // per name, so a pass drawn in several pieces counts once per frame.
+        std::vector<std::pair<const char*, uint64_t>> totals;
+        uint64_t first = times[0], last = times[1];
+        for (size_t i = 0; i < frame.zones; i++) {
+            uint64_t duration = times[i * 2 + 1] - std::min(times[i * 2], times[i * 2 + 1]);
+            first = std::min(first, times[i * 2]);
+            last = std::max(last, times[i * 2 + 1]);
+
+            auto it = std::find_if(totals.begin(), totals.end(), [&](const auto& t) { return std::string_view(t.first) == frame.names[i]; });
+            if (it == totals.end()) totals.emplace_back(frame.names[i], duration);
+            else it->second += duration;
+        }
+
+        for (const auto& [name, duration] : totals) {
+            Pass& pass = passOf(name);
+            pass.ring[pass.written++ % pass.ring.size()] = static_cast<float>(static_cast<double>(duration) * 1e-9);
+        }
+        gbl::clock.getStats().record(util::FramePhase::Gpu, static_cast<double>(last - first) * 1e-9);
+
+        if (!m_Track) return;
+
+        // begins and ends by time, parents opening before and closing after their children.
+        struct Boundary {
+            uint64_t time;
+            bool begin;
+            size_t zone;
+        };
+
+        std::vector<Boundary> boundaries;
+        for (size_t i = 0; i < frame.zones; i++) {
+            boundaries.push_back({ times[i * 2], true, i });
+            boundaries.push_back({ std::max(times[i * 2], times[i * 2 + 1]), false, i });
+        }
+        std::sort(boundaries.begin(), boundaries.end(), [](const Boundary& a, const Boundary& b) {
+            if (a.time != b.time) return a.time < b.time;
+            if (a.begin != b.begin) return !a.begin;
+            return a.begin ? a.zone < b.zone : a.zone > b.zone;
+        });
+
+        for (const auto& b : boundaries) {
+            auto time = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(static_cast<int64_t>(b.time) + frame.offset));
+            m_Track->record(frame.names[b.zone], b.begin ? profiler::EventType::Begin : profiler::EventType::End, time);
+        }
+    }
+
+    GpuProfiler::Pass &GpuProfiler::passOf(std::string_view name) {
+        auto it = std::find_if(m_Passes.begin(), m_Passes.end(), [&](const Pass& p) { return p.name == name; });
+        if (it != m_Passes.end()) return *it;
+
+        return m_Passes.emplace_back(Pass{ std::string(name), std::vector<float>(m_Config.window), 0 });
+    }
+
+    void GpuProfiler::init() {
+        gbl::gpuProfiler = std::make_unique<GpuProfiler>();
+    }
+
+    void GpuProfiler::cleanup() {
+        gbl::gpuProfiler.reset();
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "kat/engine.hpp"
+#include "kat/util/frame_stats.hpp"
+#include "kat/util/profiler.hpp"
+
+#include <chrono>
+#include <optional>
+
+// Times the enclosed GL commands on the GPU, when gbl::gpuProfiler exists. names must outlive the profiler.
+#define KAT_GPU_SCOPE(name) ::kat::GpuProfiler::Zone KAT_PROFILE_CONCAT(katGpuZone, __LINE__)(name)
+
+namespace kat {
+
+    // GPU time per render pass from timestamp queries.
+    //
+    // Zones put a timestamp before and after their commands. Each frame's queries live in one of a few sets which are
+    // only read once the GPU has written them, a couple of frames later, so nothing ever waits on the GPU. When every
+    // set is still in flight the oldest frame is dropped instead. Finished frames go into per-pass statistics, the
+    // gpu phase of gbl::clock's frame stats, and, with KAT_PROFILE, onto a "gpu" track of the CPU profiler's timeline.
+    class GpuProfiler {
+    public:
+        struct Config {
+            size_t frames = 4;      // query sets in flight
+            size_t maxZones = 32;   // per frame, more are ignored
+            size_t window = 256;    // recent frames kept per pass
+        };
+
+        struct Stats {
+            uint64_t frames = 0;        // with at least one zone
+            uint64_t resolved = 0;
+            uint64_t dropped = 0;       // overwritten before the GPU got to them
+            uint64_t overflowed = 0;    // zones past maxZones
+            uint64_t longestLatency = 0; // in frames
+        };
+
+        class Zone {
+        public:
+            explicit Zone(const char* name);
+            ~Zone();
+
+            Zone(const Zone&) = delete;
+            Zone& operator=(const Zone&) = delete;
+
+        private:
+            GpuProfiler* m_Profiler;
+            size_t m_Index;
+        };
+
+        static constexpr size_t NO_ZONE = static_cast<size_t>(-1);
+
+        GpuProfiler();
+        explicit GpuProfiler(const Config& config);
+        ~GpuProfiler();
+
+        GpuProfiler(const GpuProfiler&) = delete;
+        GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+        // NO_ZONE when the frame is full. GL thread, ends in reverse order of begins.
+        size_t begin(const char* name);
+        void end(size_t zone);
+
+        // closes the frame and reads back every finished one, non-blocking. runs after every present.
+        void endFrame();
+
+        // one frame's total for each name, over the last window frames it appeared in.
+        [[nodiscard]] util::FrameStats::Summary getPass(std::string_view name) const;
+        [[nodiscard]] std::vector<std::string_view> getPassNames() const;
+
+        [[nodiscard]] const Stats& getStats() const noexcept;
+        void logStats() const;
+
+        static void init();
+        static void cleanup();
+
+    private:
+        struct Frame {
+            std::vector<unsigned int> queries;  // begin and end per zone
+            std::vector<const char*> names;
+            std::vector<bool> ended;
+            size_t zones = 0;
+
+            // timestamps complete in issue order, so the frame is available once the last one issued is. with nested
+            // zones that is an outer end, not the end of the last zone begun.
+            unsigned int last = 0;
+
+            // cpu time minus gpu time when the frame started, to put timestamps on the cpu timeline.
+            int64_t offset = 0;
+            uint64_t number = 0;
+            bool pending = false;
+        };
+
+        struct Pass {
+            std::string name;
+            std::vector<float> ring;
+            uint64_t written = 0;
+        };
+
+        void open();
+        [[nodiscard]] bool isAvailable(const Frame& frame) const;
+        void resolve(Frame& frame);
+        Pass& passOf(std::string_view name);
+
+        Config m_Config;
+        std::vector<Frame> m_Frames;
+        size_t m_Current = 0;
+        bool m_Open = false;
+        uint64_t m_FrameNumber = 0;
+
+        std::vector<Pass> m_Passes;
+        std::optional<profiler::Track> m_Track;    // only in profiled builds
+        Stats m_Stats;
+    };
+
+    namespace gbl {
+        // created once a GL context exists, see gbl::setup
+        inline std::unique_ptr<GpuProfiler> gpuProfiler;
+    }
+}
@@ -1,4 +1,11 @@
 #include "mesh.hpp"
+#include "kat/graphics/static_batch.hpp"
+#include "kat/graphics/barriers.hpp"
+#include "kat/graphics/render_stats.hpp"
+#include "kat/util/profiler.hpp"
+
+#include <algorithm>
+#include <cassert>
 
 namespace kat {
 #pragma clang diagnostic push
@@ -14,6 +21,7 @@ namespace kat {
 #pragma clang diagnostic pop
 
     Buffer::~Buffer() {
+        gbl::barriers.forget(ResourceKind::Buffer, m_Handle);
         glDeleteBuffers(1, &m_Handle);
     }
 
@@ -27,10 +35,17 @@ namespace kat {
 
     void Buffer::data(size_t size, const void *data_, BufferUsage usage) const {
         glNamedBufferData(m_Handle, static_cast<int>(size), data_, static_cast<unsigned int>(usage));
+        if (data_) gbl::renderStats.bufferUpload(size);
     }
 
     void Buffer::subData(size_t size, const void *data, size_t offset) const {
+        gbl::barriers.require(ResourceKind::Buffer, m_Handle, BarrierUsage::BufferUpdate);
         glNamedBufferSubData(m_Handle, static_cast<int>(offset), static_cast<int>(size), data);
+        gbl::renderStats.bufferUpload(size);
+    }
+
+    void Buffer::bindStorage(unsigned int binding) const {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, m_Handle);
     }
 
     VertexBuffer::VertexBuffer(size_t size, const void *data, BufferUsage usage) : Buffer(size, data, usage) {}
@@ -49,6 +64,22 @@ namespace kat {
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Handle);
     }
 
+    StorageBuffer::StorageBuffer() = default;
+
+    StorageBuffer::StorageBuffer(size_t size, const void *data, BufferUsage usage) : Buffer(size, data, usage) {}
+
+    void StorageBuffer::bind() {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_Handle);
+    }
+
+    IndirectBuffer::IndirectBuffer() = default;
+
+    IndirectBuffer::IndirectBuffer(size_t size, const void *data, BufferUsage usage) : Buffer(size, data, usage) {}
+
+    void IndirectBuffer::bind() {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_Handle);
+    }
+
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "cppcoreguidelines-pro-type-member-init"
     VertexArray::VertexArray() {
@@ -68,23 +99,24 @@ namespace kat {
         return m_Handle;
     }
 
-    void VertexArray::bindElementBuffer(unsigned int buffer) const {
+    void VertexArray::bindElementBuffer(unsigned int buffer) {
+        m_ElementBuffer = buffer;
         glVertexArrayElementBuffer(m_Handle, buffer);
     }
 
-    void VertexArray::bindElementBuffer(const IndexBuffer *buffer) const {
+    void VertexArray::bindElementBuffer(const IndexBuffer *buffer) {
         bindElementBuffer(buffer->getHandle());
     }
 
-    void VertexArray::bindElementBuffer(const std::shared_ptr<IndexBuffer> &buffer) const {
+    void VertexArray::bindElementBuffer(const std::shared_ptr<IndexBuffer> &buffer) {
         bindElementBuffer(buffer->getHandle());
     }
 
-    void VertexArray::bindElementBuffer(const std::unique_ptr<IndexBuffer> &buffer) const {
+    void VertexArray::bindElementBuffer(const std::unique_ptr<IndexBuffer> &buffer) {
         bindElementBuffer(buffer->getHandle());
     }
 
-    void VertexArray::bindElementBuffer(const IndexBuffer &buffer) const {
+    void VertexArray::bindElementBuffer(const IndexBuffer &buffer) {
         bindElementBuffer(buffer.getHandle());
     }
 
@@ -99,6 +131,7 @@ namespace kat {
             glEnableVertexArrayAttrib(m_Handle, m_NextAttrib++);
         }
 
+        m_BoundBuffers.push_back(buffer);
         glVertexArrayVertexBuffer(m_Handle, m_NextBinding++, buffer, static_cast<int>(bufferOffset), static_cast<int>(stride));
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
@@ -136,10 +169,22 @@ namespace kat {
             glEnableVertexArrayAttrib(m_Handle, m_NextAttrib++);
         }
 
+        m_BoundBuffers.push_back(buffer);
         glVertexArrayVertexBuffer(m_Handle, m_NextBinding++, buffer, static_cast<int>(bufferOffset), static_cast<int>(offset));
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
+    void VertexArray::bindInstanceBuffer(unsigned int buffer, size_t components, unsigned int divisor, size_t bufferOffset) {
+        glVertexArrayAttribIFormat(m_Handle, m_NextAttrib, static_cast<int>(components), GL_UNSIGNED_INT, 0);
+        glVertexArrayAttribBinding(m_Handle, m_NextAttrib, m_NextBinding);
+        glEnableVertexArrayAttrib(m_Handle, m_NextAttrib++);
+
+        m_BoundBuffers.push_back(buffer);
+        glVertexArrayVertexBuffer(m_Handle, m_NextBinding, buffer, static_cast<int>(bufferOffset),
+                                  static_cast<int>(components * sizeof(unsigned int)));
+        glVertexArrayBindingDivisor(m_Handle, m_NextBinding++, divisor);
+    }
+
     void VertexArray::bindVertexBuffer(const VertexBuffer *buffer, const std::vector<size_t> &attributes, size_t bufferOffset) {
         bindVertexBuffer(buffer->getHandle(), attributes, bufferOffset);
     }
@@ -158,23 +203,67 @@ namespace kat {
         bindVertexBuffer(buffer.getHandle(), attributes, bufferOffset);
     }
 
+    void VertexArray::replaceVertexBuffer(unsigned int binding, unsigned int buffer, size_t stride, size_t bufferOffset) {
+        assert(binding < m_BoundBuffers.size());
+        m_BoundBuffers[binding] = buffer;
+        glVertexArrayVertexBuffer(m_Handle, binding, buffer, static_cast<int>(bufferOffset), static_cast<int>(stride));
+    }
+
+    std::optional<unsigned int> VertexArray::findBinding(unsigned int buffer) const {
+        auto it = std::find(m_BoundBuffers.begin(), m_BoundBuffers.end(), buffer);
+        if (it == m_BoundBuffers.end()) return std::nullopt;
+        return static_cast<unsigned int>(it - m_BoundBuffers.begin());
+    }
+
     void VertexArray::bind() const {
+        gbl::renderStats.vertexArrayBind();
         glBindVertexArray(m_Handle);
     }
 
+    void VertexArray::requireBarriers() const {
+        for (unsigned int buffer : m_BoundBuffers) {
+            gbl::barriers.require(ResourceKind::Buffer, buffer, BarrierUsage::VertexAttrib);
+        }
+
+        if (m_ElementBuffer) gbl::barriers.require(ResourceKind::Buffer, m_ElementBuffer, BarrierUsage::ElementArray);
+    }
+
     void VertexArray::drawElements(PrimitiveMode mode, size_t count, size_t offset) const {
+        requireBarriers();
         bind();
         glDrawElements(static_cast<unsigned int>(mode), static_cast<int>(count), GL_UNSIGNED_INT,
                 reinterpret_cast<const void*>(offset * sizeof(unsigned int)));
+        gbl::renderStats.draw(0, count);
+    }
+
+    void VertexArray::drawElementsBaseVertex(PrimitiveMode mode, size_t count, size_t offset, int baseVertex) const {
+        requireBarriers();
+        bind();
+        glDrawElementsBaseVertex(static_cast<unsigned int>(mode), static_cast<int>(count), GL_UNSIGNED_INT,
+                reinterpret_cast<const void*>(offset * sizeof(unsigned int)), baseVertex);
+        gbl::renderStats.draw(0, count);
+    }
+
+    void VertexArray::multiDrawElementsIndirect(PrimitiveMode mode, const IndirectBuffer &buffer, size_t drawCount, size_t offset) const {
+        requireBarriers();
+        gbl::barriers.require(ResourceKind::Buffer, buffer.getHandle(), BarrierUsage::Command);
+        bind();
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer.getHandle());
+        glMultiDrawElementsIndirect(static_cast<unsigned int>(mode), GL_UNSIGNED_INT,
+                reinterpret_cast<const void*>(offset), static_cast<int>(drawCount), sizeof(DrawElementsIndirectCommand));
+        gbl::renderStats.drawIndirect(drawCount);
     }
 
     void VertexArray::drawArrays(PrimitiveMode mode, size_t count, size_t offset) const {
+        requireBarriers();
         bind();
         glDrawArrays(static_cast<unsigned int>(mode), static_cast<int>(offset), static_cast<int>(count));
+        gbl::renderStats.draw(count, 0);
     }
 
     Mesh::Mesh(const std::vector<StandardVertex> &vertices, PrimitiveMode primitive) : m_Count(vertices.size()),
                m_Primitive(primitive), m_Offset(0) {
+        KAT_PROFILE_SCOPE("build mesh");
         m_VertexBuffers = { createBuffer<VertexBuffer>(vertices) };
         m_VertexArray = std::make_shared<VertexArray>();
         m_VertexArray->bindVertexBuffer(m_VertexBuffers[0], StandardVertex::ATTRIBUTES);
@@ -182,6 +271,7 @@ namespace kat {
 
     Mesh::Mesh(const std::vector<StandardVertex> &vertices, const std::vector<unsigned int> &indices,
                PrimitiveMode primitive) : m_Count(indices.size()), m_Primitive(primitive), m_Offset(0) {
+        KAT_PROFILE_SCOPE("build mesh");
         m_VertexBuffers = { createBuffer<VertexBuffer>(vertices) };
         m_IndexBuffer = createBuffer<IndexBuffer>(indices);
         m_VertexArray = std::make_shared<VertexArray>();
@@ -189,6 +279,16 @@ namespace kat {
         m_VertexArray->bindElementBuffer(m_IndexBuffer);
     }
 
+    Mesh::Mesh(const std::vector<TileVertex> &vertices, const std::vector<unsigned int> &indices,
+               PrimitiveMode primitive) : m_Count(indices.size()), m_Offset(0), m_Primitive(primitive) {
+        KAT_PROFILE_SCOPE("build mesh");
+        m_VertexBuffers = { createBuffer<VertexBuffer>(vertices) };
+        m_IndexBuffer = createBuffer<IndexBuffer>(indices);
+        m_VertexArray = std::make_shared<VertexArray>();
+        m_VertexArray->bindVertexBuffer(m_VertexBuffers[0], TileVertex::ATTRIBUTES);
+        m_VertexArray->bindElementBuffer(m_IndexBuffer);
+    }
+
     Mesh::Mesh(size_t vertexCount, const std::shared_ptr<VertexArray> &vertexArray,
                const std::vector<std::shared_ptr<VertexBuffer>> &vertexBuffers, size_t offset,
                PrimitiveMode primitive) : m_Count(vertexCount), m_VertexArray(vertexArray),
@@ -204,6 +304,14 @@ namespace kat {
 
     }
 
+    Mesh::Mesh(const std::shared_ptr<StaticBatcher> &batcher, const std::vector<StandardVertex> &vertices,
+               const std::vector<unsigned int> &indices, uint32_t material)
+               : m_VertexArray(batcher->getVertexArray()), m_Count(indices.size()), m_Primitive(batcher->getPrimitive()),
+                 m_Batcher(batcher) {
+        m_BatchHandle = batcher->add(vertices, indices, material);
+        m_Offset = batcher->getRecord(m_BatchHandle).firstIndex;
+    }
+
     Mesh::~Mesh() = default;
 
     void Mesh::render() {
@@ -227,13 +335,47 @@ namespace kat {
     }
 
     void Mesh::render(PrimitiveMode primitiveMode, size_t count, size_t offset) {
-        if (m_IndexBuffer) {
+        if (m_Batcher) {
+            m_VertexArray->drawElementsBaseVertex(primitiveMode, count, offset, m_Batcher->getRecord(m_BatchHandle).baseVertex);
+        } else if (m_IndexBuffer) {
             m_VertexArray->drawElements(primitiveMode, count, offset);
         } else {
             m_VertexArray->drawArrays(primitiveMode, count, offset);
         }
     }
 
+    const std::shared_ptr<VertexArray> &Mesh::getVertexArray() const noexcept {
+        return m_VertexArray;
+    }
+
+    PrimitiveMode Mesh::getPrimitive() const noexcept {
+        return m_Primitive;
+    }
+
+    size_t Mesh::getCount() const noexcept {
+        return m_Count;
+    }
+
+    size_t Mesh::getOffset() const noexcept {
+        return m_Offset;
+    }
+
+    bool Mesh::isIndexed() const noexcept {
+        return m_IndexBuffer != nullptr || m_Batcher != nullptr;
+    }
+
+    bool Mesh::isBatched() const noexcept {
+        return m_Batcher != nullptr;
+    }
+
+    uint32_t Mesh::getBatchHandle() const noexcept {
+        return m_BatchHandle;
+    }
+
+    const std::shared_ptr<StaticBatcher> &Mesh::getBatcher() const noexcept {
+        return m_Batcher;
+    }
+
     std::unique_ptr<Mesh> Mesh::createQuad(const glm::vec2 &bottomLeft, const glm::vec2 &topRight,
                                            const std::pair<glm::vec2, glm::vec2> &uvPair) {
         std::vector<StandardVertex> vertices = {
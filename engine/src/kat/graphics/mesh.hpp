@@ -49,6 +49,9 @@ namespace kat {
             subData(data.size() * sizeof(T), data.data(), offset);
         }
 
+        // any buffer can back a shader storage block, whatever it was created as.
+        void bindStorage(unsigned int binding) const;
+
     protected:
         unsigned int m_Handle;
     };
@@ -72,6 +75,35 @@ namespace kat {
         void bind() override;
     };
 
+    class IndirectBuffer : public Buffer {
+    public:
+
+        IndirectBuffer();
+
+        IndirectBuffer(size_t size, const void *data, BufferUsage usage);
+
+        void bind() override;
+    };
+
+    class StorageBuffer : public Buffer {
+    public:
+
+        StorageBuffer();
+
+        StorageBuffer(size_t size, const void *data, BufferUsage usage);
+
+        void bind() override;
+    };
+
+    // matches the layout glMultiDrawElementsIndirect reads.
+    struct DrawElementsIndirectCommand {
+        uint32_t count;
+        uint32_t instanceCount;
+        uint32_t firstIndex;
+        int32_t baseVertex;
+        uint32_t baseInstance;
+    };
+
     template<typename T>
     concept easy_buffer = requires(size_t size, const void* data, BufferUsage usage) {
         { T(size, data, usage) } -> std::same_as<T>;
@@ -121,11 +153,11 @@ namespace kat {
         [[nodiscard]] unsigned int getHandle() const noexcept;
 
 
-        void bindElementBuffer(unsigned int buffer) const;
-        void bindElementBuffer(const IndexBuffer* buffer) const;
-        void bindElementBuffer(const std::shared_ptr<IndexBuffer>& buffer) const;
-        void bindElementBuffer(const std::unique_ptr<IndexBuffer>& buffer) const;
-        void bindElementBuffer(const IndexBuffer& buffer) const;
+        void bindElementBuffer(unsigned int buffer);
+        void bindElementBuffer(const IndexBuffer* buffer);
+        void bindElementBuffer(const std::shared_ptr<IndexBuffer>& buffer);
+        void bindElementBuffer(const std::unique_ptr<IndexBuffer>& buffer);
+        void bindElementBuffer(const IndexBuffer& buffer);
 
         // These are more specific on vertex format, allowing for custom stride & offsets. requires more effort and caution though.
         void bindVertexBuffer(unsigned int buffer, const std::vector<VertexAttribute>& attributes, size_t stride, size_t bufferOffset = 0);
@@ -134,6 +166,9 @@ namespace kat {
         void bindVertexBuffer(const std::unique_ptr<VertexBuffer>& buffer, const std::vector<VertexAttribute>& attributes, size_t stride, size_t bufferOffset = 0);
         void bindVertexBuffer(const VertexBuffer& buffer, const std::vector<VertexAttribute>& attributes, size_t stride, size_t bufferOffset = 0);
 
+        // A single integer attribute advancing once per divisor instances, e.g. indices into a storage buffer.
+        void bindInstanceBuffer(unsigned int buffer, size_t components = 1, unsigned int divisor = 1, size_t bufferOffset = 0);
+
         // These assume a packed vertex format
         void bindVertexBuffer(unsigned int buffer, const std::vector<size_t>& attributes, size_t bufferOffset = 0);
         void bindVertexBuffer(const VertexBuffer* buffer, const std::vector<size_t>& attributes, size_t bufferOffset = 0);
@@ -141,16 +176,32 @@ namespace kat {
         void bindVertexBuffer(const std::unique_ptr<VertexBuffer>& buffer, const std::vector<size_t>& attributes, size_t bufferOffset = 0);
         void bindVertexBuffer(const VertexBuffer& buffer, const std::vector<size_t>& attributes, size_t bufferOffset = 0);
 
+        // swaps the buffer behind an existing binding, keeping its attribute layout.
+        void replaceVertexBuffer(unsigned int binding, unsigned int buffer, size_t stride, size_t bufferOffset = 0);
+
+        // the binding a buffer was bound to, if it is.
+        [[nodiscard]] std::optional<unsigned int> findBinding(unsigned int buffer) const;
+
         void bind() const;
 
         void drawElements(PrimitiveMode mode, size_t count, size_t offset = 0) const;
+        void drawElementsBaseVertex(PrimitiveMode mode, size_t count, size_t offset, int baseVertex) const;
         void drawArrays(PrimitiveMode mode, size_t count, size_t offset = 0) const;
 
+        // draws drawCount DrawElementsIndirectCommands read from buffer, starting at the byte offset.
+        void multiDrawElementsIndirect(PrimitiveMode mode, const IndirectBuffer& buffer, size_t drawCount, size_t offset = 0) const;
+
     private:
+        // a shader may have written the buffers we are about to read.
+        void requireBarriers() const;
+
         unsigned int m_Handle;
 
         unsigned int m_NextAttrib = 0;
         unsigned int m_NextBinding = 0;
+
+        std::vector<unsigned int> m_BoundBuffers; // by binding
+        unsigned int m_ElementBuffer = 0;
     };
 
     struct StandardVertex {
@@ -164,15 +215,34 @@ namespace kat {
         };
     };
 
+    // for Texture2DArray textures, see TileMeshBuilder. the layer is a float so it goes through the packed layout,
+    // it is exact well past any layer count GL allows.
+    struct TileVertex {
+        glm::vec3 position;
+        glm::vec2 texCoords;
+        float layer;
+        glm::vec4 tint{ 1.0f };
+
+        inline static const std::vector<size_t> ATTRIBUTES = {
+                3, 2, 1, 4
+        };
+    };
+
+
+    class StaticBatcher;
 
     class Mesh {
     public:
 
         explicit Mesh(const std::vector<StandardVertex>& vertices, PrimitiveMode primitive = PrimitiveMode::Triangles);
         Mesh(const std::vector<StandardVertex>& vertices, const std::vector<unsigned int> &indices, PrimitiveMode primitive = PrimitiveMode::Triangles);
+        Mesh(const std::vector<TileVertex>& vertices, const std::vector<unsigned int> &indices, PrimitiveMode primitive = PrimitiveMode::Triangles);
         Mesh(size_t vertexCount, const std::shared_ptr<VertexArray>& vertexArray, const std::vector<std::shared_ptr<VertexBuffer>>& vertexBuffers, size_t offset = 0, PrimitiveMode primitive = PrimitiveMode::Triangles);
         Mesh(size_t indexCount, const std::shared_ptr<VertexArray>& vertexArray, const std::vector<std::shared_ptr<VertexBuffer>>& vertexBuffers, const std::shared_ptr<IndexBuffer>& indexBuffer, size_t offset = 0, PrimitiveMode primitive = PrimitiveMode::Triangles);
 
+        // opts into a StaticBatcher, the geometry lives in the batcher's shared buffers instead of its own.
+        Mesh(const std::shared_ptr<StaticBatcher>& batcher, const std::vector<StandardVertex>& vertices, const std::vector<unsigned int> &indices, uint32_t material = 0);
+
         ~Mesh();
 
         void render();
@@ -182,6 +252,16 @@ namespace kat {
         void render(size_t count);
         void render(size_t count, size_t offset);
 
+        [[nodiscard]] const std::shared_ptr<VertexArray>& getVertexArray() const noexcept;
+        [[nodiscard]] PrimitiveMode getPrimitive() const noexcept;
+        [[nodiscard]] size_t getCount() const noexcept;
+        [[nodiscard]] size_t getOffset() const noexcept;
+        [[nodiscard]] bool isIndexed() const noexcept;
+
+        [[nodiscard]] bool isBatched() const noexcept;
+        [[nodiscard]] uint32_t getBatchHandle() const noexcept;
+        [[nodiscard]] const std::shared_ptr<StaticBatcher>& getBatcher() const noexcept;
+
         static std::unique_ptr<Mesh> createQuad(const glm::vec2& bottomLeft, const glm::vec2& topRight, const std::pair<glm::vec2, glm::vec2>& uvPair);
     private:
 
@@ -194,6 +274,9 @@ namespace kat {
 
         PrimitiveMode m_Primitive;
 
+        std::shared_ptr<StaticBatcher> m_Batcher;
+        uint32_t m_BatchHandle = 0;
+
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,281 @@
+#include "palette.hpp"
+
+#include "kat/io/file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace kat {
+    namespace {
+        constexpr char INDEXED_MAGIC[4] = { 'K', 'I', 'D', 'X' };
+        constexpr uint32_t INDEXED_VERSION = 1;
+
+        // fully transparent pixels all become the same colour.
+        uint32_t packColor(const uint8_t* p) {
+            if (p[3] == 0) return 0;
+            return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+        }
+
+        glm::u8vec4 unpackColor(uint32_t c) {
+            return glm::u8vec4(c & 0xff, (c >> 8) & 0xff, (c >> 16) & 0xff, c >> 24);
+        }
+
+        struct Bucket {
+            uint32_t color;
+            uint32_t count;
+        };
+
+        // unique colours sorted by value, so palettes come out the same on every run.
+        std::vector<Bucket> histogram(const glm::uvec2& size, std::span<const uint8_t> rgba) {
+            std::unordered_map<uint32_t, uint32_t> counts;
+            size_t pixels = static_cast<size_t>(size.x) * size.y;
+            for (size_t i = 0; i < pixels; i++) counts[packColor(&rgba[i * 4])]++;
+
+            std::vector<Bucket> buckets;
+            buckets.reserve(counts.size());
+            for (const auto& [color, count] : counts) buckets.push_back({ color, count });
+
+            std::sort(buckets.begin(), buckets.end(), [](const Bucket& a, const Bucket& b) { return a.color < b.color; });
+            return buckets;
+        }
+
+        IndexedImage assign(const glm::uvec2& size, std::span<const uint8_t> rgba,
+                            const std::unordered_map<uint32_t, uint8_t>& lookup, std::vector<glm::u8vec4> palette) {
+            IndexedImage image;
+            image.size = size;
+            image.palette = std::move(palette);
+            image.indices.resize(static_cast<size_t>(size.x) * size.y);
+
+            for (size_t i = 0; i < image.indices.size(); i++) image.indices[i] = lookup.at(packColor(&rgba[i * 4]));
+            return image;
+        }
+    }
+
+    Palette::Palette(uint32_t rows) : m_Rows(rows), m_Colors(static_cast<size_t>(MAX_COLORS) * rows, glm::u8vec4(0)) {
+        m_Texture = Texture2D::create(glm::uvec2(MAX_COLORS, rows), TextureFormat::RGBA8, m_Colors.data(), PixelDataType::UnsignedByte);
+        m_Texture->setFilter(TextureFilter::Nearest);
+        m_Texture->setWrapMode(WrapMode::ClampToEdge);
+    }
+
+    void Palette::setRow(uint32_t row, std::span<const glm::u8vec4> colors) {
+        if (row >= m_Rows) {
+            spdlog::error("Palette row {} is out of range, it has {}", row, m_Rows);
+            return;
+        }
+
+        size_t count = std::min<size_t>(colors.size(), MAX_COLORS);
+        std::copy_n(colors.begin(), count, m_Colors.begin() + static_cast<ptrdiff_t>(row * MAX_COLORS));
+        m_Texture->subImage(glm::uvec2(0, row), glm::uvec2(count, 1), &m_Colors[row * MAX_COLORS]);
+    }
+
+    void Palette::setColor(uint32_t row, uint8_t index, const glm::u8vec4 &color) {
+        if (row >= m_Rows) {
+            spdlog::error("Palette row {} is out of range, it has {}", row, m_Rows);
+            return;
+        }
+
+        m_Colors[row * MAX_COLORS + index] = color;
+        m_Texture->subImage(glm::uvec2(index, row), glm::uvec2(1, 1), &m_Colors[row * MAX_COLORS + index]);
+    }
+
+    std::span<const glm::u8vec4> Palette::getRow(uint32_t row) const {
+        if (row >= m_Rows) return {};
+        return std::span(m_Colors).subspan(row * MAX_COLORS, MAX_COLORS);
+    }
+
+    uint32_t Palette::getRowCount() const noexcept {
+        return m_Rows;
+    }
+
+    const std::shared_ptr<Texture2D> &Palette::getTexture() const noexcept {
+        return m_Texture;
+    }
+
+    std::optional<IndexedImage> IndexedImage::fromRGBA(const glm::uvec2 &size, std::span<const uint8_t> rgba, uint32_t maxColors) {
+        auto buckets = histogram(size, rgba);
+        if (buckets.size() > std::min(maxColors, Palette::MAX_COLORS)) return std::nullopt;
+
+        std::unordered_map<uint32_t, uint8_t> lookup;
+        std::vector<glm::u8vec4> palette;
+        for (const auto& bucket : buckets) {
+            lookup[bucket.color] = static_cast<uint8_t>(palette.size());
+            palette.push_back(unpackColor(bucket.color));
+        }
+
+        return assign(size, rgba, lookup, std::move(palette));
+    }
+
+    IndexedImage IndexedImage::quantize(const glm::uvec2 &size, std::span<const uint8_t> rgba, uint32_t maxColors) {
+        maxColors = std::clamp(maxColors, 1u, Palette::MAX_COLORS);
+        if (auto exact = fromRGBA(size, rgba, maxColors)) return std::move(*exact);
+
+        auto buckets = histogram(size, rgba);
+
+        struct Box {
+            size_t begin, end;
+            int channel;    // widest
+            uint32_t range;
+        };
+
+        auto makeBox = [&](size_t begin, size_t end) {
+            glm::u8vec4 lo(255), hi(0);
+            for (size_t i = begin; i < end; i++) {
+                auto c = unpackColor(buckets[i].color);
+                lo = glm::min(lo, c);
+                hi = glm::max(hi, c);
+            }
+
+            Box box{ begin, end, 0, 0 };
+            for (int c = 0; c < 4; c++) {
+                if (static_cast<uint32_t>(hi[c] - lo[c]) > box.range) {
+                    box.range = hi[c] - lo[c];
+                    box.channel = c;
+                }
+            }
+            return box;
+        };
+
+        std::vector<Box> boxes{ makeBox(0, buckets.size()) };
+        while (boxes.size() < maxColors) {
+            auto widest = std::max_element(boxes.begin(), boxes.end(), [](const Box& a, const Box& b) { return a.range < b.range; });
+            if (widest->range == 0) break;
+
+            Box box = *widest;
+            auto first = buckets.begin() + static_cast<ptrdiff_t>(box.begin);
+            auto last = buckets.begin() + static_cast<ptrdiff_t>(box.end);
+            std::sort(first, last, [c = box.channel](const Bucket& a, const Bucket& b) {
+                return unpackColor(a.color)[c] < unpackColor(b.color)[c];
+            });
+
+            // split at the pixel weighted median, leaving at least one colour on each side.
+            uint64_t total = 0, running = 0;
+            for (size_t i = box.begin; i < box.end; i++) total += buckets[i].count;
+
+            size_t split = box.begin + 1;
+            for (size_t i = box.begin; i < box.end - 1; i++) {
+                running += buckets[i].count;
+                split = i + 1;
+                if (running * 2 >= total) break;
+            }
+
+            *widest = makeBox(box.begin, split);
+            boxes.push_back(makeBox(split, box.end));
+        }
+
+        std::unordered_map<uint32_t, uint8_t> lookup;
+        std::vector<glm::u8vec4> palette;
+        for (const auto& box : boxes) {
+            glm::dvec4 sum(0.0);
+            uint64_t count = 0;
+            for (size_t i = box.begin; i < box.end; i++) {
+                sum += glm::dvec4(unpackColor(buckets[i].color)) * static_cast<double>(buckets[i].count);
+                count += buckets[i].count;
+                lookup[buckets[i].color] = static_cast<uint8_t>(palette.size());
+            }
+
+            palette.push_back(glm::u8vec4(glm::round(sum / static_cast<double>(count))));
+        }
+
+        return assign(size, rgba, lookup, std::move(palette));
+    }
+
+    std::vector<std::byte> IndexedImage::encode() const {
+        IndexedHeader header{};
+        std::memcpy(header.magic, INDEXED_MAGIC, sizeof(header.magic));
+        header.version = INDEXED_VERSION;
+        header.width = size.x;
+        header.height = size.y;
+        header.colors = static_cast<uint32_t>(palette.size());
+
+        std::vector<std::byte> bytes(sizeof(header) + palette.size() * 4 + indices.size());
+        std::memcpy(bytes.data(), &header, sizeof(header));
+        std::memcpy(bytes.data() + sizeof(header), palette.data(), palette.size() * 4);
+        std::memcpy(bytes.data() + sizeof(header) + palette.size() * 4, indices.data(), indices.size());
+        return bytes;
+    }
+
+    std::optional<IndexedImage> IndexedImage::decode(std::span<const std::byte> bytes) {
+        IndexedHeader header{};
+        if (bytes.size() < sizeof(header)) return std::nullopt;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+
+        size_t pixels = static_cast<size_t>(header.width) * header.height;
+        if (std::memcmp(header.magic, INDEXED_MAGIC, sizeof(header.magic)) != 0 || header.version != INDEXED_VERSION ||
+            header.colors > Palette::MAX_COLORS || bytes.size() != sizeof(header) + header.colors * 4 + pixels) {
+            return std::nullopt;
+        }
+
+        IndexedImage image;
+        image.size = { header.width, header.height };
+        image.palette.resize(header.colors);
+        image.indices.resize(pixels);
+
+        std::memcpy(image.palette.data(), bytes.data() + sizeof(header), header.colors * 4);
+        std::memcpy(image.indices.data(), bytes.data() + sizeof(header) + header.colors * 4, pixels);
+        return image;
+    }
+
+    std::shared_ptr<IndexedTexture> IndexedTexture::create(const IndexedImage &image, uint32_t paletteRows) {
+        auto texture = std::shared_ptr<IndexedTexture>(new IndexedTexture());
+
+        // one byte per texel, rows aren't 4 byte aligned.
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        texture->m_Indices = Texture2D::create(image.size, TextureFormat::R8UI, image.indices.data(), PixelDataType::UnsignedByte);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        texture->m_Indices->setFilter(TextureFilter::Nearest);
+
+        texture->m_Palette = Palette::create(std::max(paletteRows, 1u));
+        for (uint32_t row = 0; row < texture->m_Palette->getRowCount(); row++) texture->m_Palette->setRow(row, image.palette);
+
+        return texture;
+    }
+
+    std::shared_ptr<IndexedTexture> IndexedTexture::load(const std::filesystem::path &path, uint32_t paletteRows) {
+        auto blob = io::read(path);
+        if (!blob) {
+            spdlog::error("Indexed texture {} is missing", path.string());
+            return nullptr;
+        }
+
+        auto image = IndexedImage::decode(blob.getBytes());
+        if (!image) {
+            spdlog::error("{} is not a version {} indexed texture", path.string(), INDEXED_VERSION);
+            return nullptr;
+        }
+
+        return create(*image, paletteRows);
+    }
+
+    void IndexedTexture::bind(GraphicsShader &shader, uint32_t paletteRow) const {
+        shader.bindTexture("uIndices", 0, *m_Indices);
+        shader.bindTexture("uPalette", 1, *m_Palette->getTexture());
+        shader.setInteger("uPaletteRow", static_cast<int>(paletteRow));
+    }
+
+    const std::shared_ptr<Texture2D> &IndexedTexture::getIndices() const noexcept {
+        return m_Indices;
+    }
+
+    const std::shared_ptr<Palette> &IndexedTexture::getPalette() const noexcept {
+        return m_Palette;
+    }
+
+    const glm::uvec2 &IndexedTexture::getSize() const noexcept {
+        return m_Indices->getSize();
+    }
+
+    GraphicsShader &IndexedTexture::getShader() {
+        return *s_Shader;
+    }
+
+    void IndexedTexture::init() {
+        s_Shader = GraphicsShader::createUnique(
+                { std::pair{ ShaderType::Vertex, embed::shaders::indexed::vertexSrc },
+                  std::pair{ ShaderType::Fragment, embed::shaders::indexed::fragmentSrc }});
+    }
+
+    void IndexedTexture::cleanup() {
+        s_Shader = nullptr;
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "kat/engine.hpp"
+#include "kat/graphics/shader.hpp"
+#include "kat/graphics/texture.hpp"
+
+#include <optional>
+#include <span>
+
+namespace kat {
+
+    namespace embed::shaders::indexed {
+        const std::string vertexSrc = "#version 430 core\n"
+                                      "layout(location=0) in vec3 vPosition;\n"
+                                      "layout(location=1) in vec2 vTexCoord;\n"
+                                      "layout(location=2) in vec4 vTint;\n"
+                                      "layout(location=3) in vec3 vNormal;\n"
+                                      "out vec2 fUV;\n"
+                                      "uniform mat4 uTransform;\n"
+                                      "void main() {\n"
+                                      "    gl_Position = uTransform * vec4(vPosition, 1.0);\n"
+                                      "    fUV = vTexCoord;\n"
+                                      "}";
+
+        const std::string fragmentSrc = "#version 430 core\n"
+                                        "in vec2 fUV;\n"
+                                        "out vec4 colorOut;\n"
+                                        "uniform usampler2D uIndices;\n"
+                                        "uniform sampler2D uPalette;\n"
+                                        "uniform int uPaletteRow;\n"
+                                        "void main() {\n"
+                                        "    uint index = texture(uIndices, fUV).r;\n"
+                                        "    colorOut = texelFetch(uPalette, ivec2(int(index), uPaletteRow), 0);\n"
+                                        "}";
+    }
+
+    // Rows of up to 256 colours in a small RGBA8 texture, each row a variant of the same palette (day and night,
+    // team colours, a damage flash). Switching variants is a uniform, recolouring one uploads a single row.
+    class Palette {
+    public:
+        static constexpr uint32_t MAX_COLORS = 256;
+
+        inline static std::shared_ptr<Palette> create(uint32_t rows = 1) {
+            return std::shared_ptr<Palette>(new Palette(rows));
+        };
+
+        // colors past the given ones keep their value. rows past getRowCount are rejected.
+        void setRow(uint32_t row, std::span<const glm::u8vec4> colors);
+        void setColor(uint32_t row, uint8_t index, const glm::u8vec4& color);
+
+        // empty for rows past getRowCount.
+        [[nodiscard]] std::span<const glm::u8vec4> getRow(uint32_t row) const;
+        [[nodiscard]] uint32_t getRowCount() const noexcept;
+        [[nodiscard]] const std::shared_ptr<Texture2D>& getTexture() const noexcept;
+
+    private:
+        explicit Palette(uint32_t rows);
+
+        uint32_t m_Rows;
+        std::vector<glm::u8vec4> m_Colors; // cpu copy, MAX_COLORS per row
+        std::shared_ptr<Texture2D> m_Texture;
+    };
+
+    // An image as 8 bit indices into its own palette, rows bottom to top.
+    struct IndexedImage {
+        glm::uvec2 size{};
+        std::vector<uint8_t> indices;
+        std::vector<glm::u8vec4> palette;
+
+        // exact, empty when the image uses more than maxColors colours. fully transparent pixels count as one.
+        static std::optional<IndexedImage> fromRGBA(const glm::uvec2& size, std::span<const uint8_t> rgba, uint32_t maxColors = Palette::MAX_COLORS);
+
+        // median cut down to maxColors, exact when the image already fits.
+        static IndexedImage quantize(const glm::uvec2& size, std::span<const uint8_t> rgba, uint32_t maxColors = Palette::MAX_COLORS);
+
+        // the .kidx format the cooker writes: IndexedHeader, palette as RGBA8, indices.
+        [[nodiscard]] std::vector<std::byte> encode() const;
+        static std::optional<IndexedImage> decode(std::span<const std::byte> bytes);
+    };
+
+    struct IndexedHeader {
+        char magic[4];          // KIDX
+        uint32_t version;
+        uint32_t width;
+        uint32_t height;
+        uint32_t colors;
+        uint32_t reserved[3];
+    };
+
+    static_assert(sizeof(IndexedHeader) == 32);
+
+    // An R8UI index texture with the palette it is drawn through, a quarter of the memory and upload of RGBA8.
+    // Always sampled Nearest, integer textures can't be filtered.
+    class IndexedTexture {
+    public:
+        // the image's palette becomes row 0 and is copied into the other rows, ready to be recoloured.
+        static std::shared_ptr<IndexedTexture> create(const IndexedImage& image, uint32_t paletteRows = 1);
+
+        // a .kidx, empty on failure.
+        static std::shared_ptr<IndexedTexture> load(const std::filesystem::path& path, uint32_t paletteRows = 1);
+
+        // binds the indices and palette on units 0 and 1 of the shader, uIndices / uPalette / uPaletteRow.
+        void bind(GraphicsShader& shader, uint32_t paletteRow = 0) const;
+
+        [[nodiscard]] const std::shared_ptr<Texture2D>& getIndices() const noexcept;
+        [[nodiscard]] const std::shared_ptr<Palette>& getPalette() const noexcept;
+        [[nodiscard]] const glm::uvec2& getSize() const noexcept;
+
+        // draws StandardVertex meshes, see embed::shaders::indexed.
+        [[nodiscard]] static GraphicsShader& getShader();
+
+        static void init();
+        static void cleanup();
+
+    private:
+        IndexedTexture() = default;
+
+        std::shared_ptr<Texture2D> m_Indices;
+        std::shared_ptr<Palette> m_Palette;
+
+        static inline std::unique_ptr<GraphicsShader> s_Shader;
+    };
+}
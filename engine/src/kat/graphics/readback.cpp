@@ -0,0 +1,164 @@
+#include "readback.hpp"
+
+#include "kat/os.hpp"
+
+namespace kat {
+    ReadbackRing::ReadbackRing() : ReadbackRing(Config{}) {}
+
+    ReadbackRing::ReadbackRing(const Config &config) : m_Slots(std::max<size_t>(config.slots, 1)) {}
+
+    ReadbackRing::~ReadbackRing() {
+        for (auto& slot : m_Slots) {
+            if (slot.sync) glDeleteSync(slot.sync);
+            if (slot.buffer) {
+                glUnmapNamedBuffer(slot.buffer);
+                glDeleteBuffers(1, &slot.buffer);
+            }
+        }
+    }
+
+    bool ReadbackRing::read(const Framebuffer &framebuffer, size_t attachment, Callback callback) {
+        const auto& texture = framebuffer.getColorAttachment(attachment);
+        if (!texture) {
+            spdlog::error("Framebuffer {} has no colour attachment {} to read back", framebuffer.getHandle(), attachment);
+            return false;
+        }
+
+        return read(framebuffer, attachment, glm::uvec2(0), texture->getSize(), std::move(callback));
+    }
+
+    bool ReadbackRing::read(const Framebuffer &framebuffer, size_t attachment, const glm::uvec2 &offset,
+                            const glm::uvec2 &size, Callback callback) {
+        const auto& texture = framebuffer.getColorAttachment(attachment);
+        if (!texture) {
+            spdlog::error("Framebuffer {} has no colour attachment {} to read back", framebuffer.getHandle(), attachment);
+            return false;
+        }
+
+        return read(framebuffer.getHandle(), GL_COLOR_ATTACHMENT0 + static_cast<unsigned int>(attachment), offset, size,
+                    texture->getFormat(), std::move(callback));
+    }
+
+    bool ReadbackRing::readDefault(Callback callback) {
+        const auto& window = *gbl::activeWindow;
+        return read(window.getDefaultFramebuffer(), window.isHeadless() ? GL_COLOR_ATTACHMENT0 : GL_BACK, glm::uvec2(0),
+                    glm::uvec2(window.getSize()), TextureFormat::RGBA8, std::move(callback));
+    }
+
+    bool ReadbackRing::read(unsigned int framebuffer, unsigned int buffer, const glm::uvec2 &offset,
+                            const glm::uvec2 &size, TextureFormat format, Callback callback) {
+        auto dataType = pixelDataTypeOf(format);
+        if (!dataType) {
+            spdlog::error("Can't read back texture format {}", static_cast<int>(format));
+            return false;
+        }
+
+        m_Stats.requested++;
+
+        auto free = std::find_if(m_Slots.begin(), m_Slots.end(), [](const Slot& s) { return s.sync == nullptr; });
+        if (free == m_Slots.end()) {
+            m_Stats.dropped++;
+            return false;
+        }
+
+        Slot& slot = *free;
+        size_t bytes = static_cast<size_t>(size.x) * size.y * bytesPerPixel(format);
+        reserve(slot, bytes);
+
+        int previous = 0;
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous);
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+        glNamedFramebufferReadBuffer(framebuffer, buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+        // with a pack buffer bound this only queues the copy, the pointer is an offset into the buffer.
+        glReadnPixels(static_cast<int>(offset.x), static_cast<int>(offset.y), static_cast<int>(size.x), static_cast<int>(size.y),
+                      glFormatOf(format), static_cast<unsigned int>(*dataType), static_cast<int>(bytes), nullptr);
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<unsigned int>(previous));
+
+        slot.sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.size = size;
+        slot.format = format;
+        slot.frame = m_Frame;
+        slot.callback = std::move(callback);
+
+        m_InFlight.push_back(static_cast<size_t>(free - m_Slots.begin()));
+        return true;
+    }
+
+    void ReadbackRing::reserve(Slot &slot, size_t bytes) {
+        if (slot.capacity >= bytes) return;
+
+        if (slot.buffer) {
+            glUnmapNamedBuffer(slot.buffer);
+            glDeleteBuffers(1, &slot.buffer);
+        }
+
+        // coherent, so once the fence signalled the pixels are visible through the mapping as is.
+        constexpr GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        glCreateBuffers(1, &slot.buffer);
+        glNamedBufferStorage(slot.buffer, static_cast<GLsizeiptr>(bytes), nullptr, flags | GL_CLIENT_STORAGE_BIT);
+        slot.mapped = static_cast<std::byte*>(glMapNamedBufferRange(slot.buffer, 0, static_cast<GLsizeiptr>(bytes), flags));
+        slot.capacity = bytes;
+    }
+
+    void ReadbackRing::deliver(Slot &slot) {
+        glDeleteSync(slot.sync);
+        slot.sync = nullptr;
+
+        size_t bytes = static_cast<size_t>(slot.size.x) * slot.size.y * bytesPerPixel(slot.format);
+        m_Stats.completed++;
+        m_Stats.bytes += bytes;
+        m_Stats.longestLatency = std::max(m_Stats.longestLatency, m_Frame - slot.frame);
+
+        auto callback = std::move(slot.callback);
+        slot.callback = nullptr;
+        if (callback) callback({ slot.size, slot.format, std::span<const std::byte>(slot.mapped, bytes), slot.frame });
+    }
+
+    void ReadbackRing::poll() {
+        m_Frame++;
+
+        // reads complete in the order they were issued, stop at the first one still running.
+        while (!m_InFlight.empty()) {
+            Slot& slot = m_Slots[m_InFlight.front()];
+            auto status = glClientWaitSync(slot.sync, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+
+            m_InFlight.pop_front();
+            deliver(slot);
+        }
+    }
+
+    void ReadbackRing::finish() {
+        while (!m_InFlight.empty()) {
+            Slot& slot = m_Slots[m_InFlight.front()];
+            glClientWaitSync(slot.sync, GL_SYNC_FLUSH_COMMANDS_BIT, std::numeric_limits<uint64_t>::max());
+
+            m_InFlight.pop_front();
+            deliver(slot);
+        }
+    }
+
+    size_t ReadbackRing::getPendingCount() const noexcept {
+        return m_InFlight.size();
+    }
+
+    const ReadbackRing::Stats &ReadbackRing::getStats() const noexcept {
+        return m_Stats;
+    }
+
+    void ReadbackRing::init() {
+        gbl::readback = std::make_unique<ReadbackRing>();
+    }
+
+    void ReadbackRing::cleanup() {
+        gbl::readback.reset();
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "kat/engine.hpp"
+#include "kat/graphics/render_target.hpp"
+#include "kat/graphics/texture.hpp"
+
+#include <deque>
+#include <functional>
+#include <span>
+
+namespace kat {
+
+    // Reads framebuffers back without stalling, for screenshots, golden images, picking and capture.
+    //
+    // read() packs the pixels into one of a few persistently mapped pixel buffers and fences it, poll() runs after
+    // every present and hands out whatever the GPU has finished, usually a frame or two later. When every buffer is
+    // still in flight the read is dropped rather than waited on, so capturing each frame never costs frame rate.
+    class ReadbackRing {
+    public:
+        struct Config {
+            size_t slots = 4;
+        };
+
+        // rows bottom to top, tightly packed. pixels only live for the duration of the callback.
+        struct Readback {
+            glm::uvec2 size;
+            TextureFormat format;
+            std::span<const std::byte> pixels;
+            uint64_t frame;     // poll() count when it was requested
+        };
+
+        using Callback = std::function<void(const Readback&)>;
+
+        struct Stats {
+            size_t requested = 0;
+            size_t completed = 0;
+            size_t dropped = 0;         // every slot was busy
+            size_t bytes = 0;
+            uint64_t longestLatency = 0; // in frames
+        };
+
+        ReadbackRing();
+        explicit ReadbackRing(const Config& config);
+        ~ReadbackRing();
+
+        ReadbackRing(const ReadbackRing&) = delete;
+        ReadbackRing& operator=(const ReadbackRing&) = delete;
+
+        // a colour attachment, whole or a region. false if dropped or the format can't be read back. GL thread.
+        bool read(const Framebuffer& framebuffer, size_t attachment, Callback callback);
+        bool read(const Framebuffer& framebuffer, size_t attachment, const glm::uvec2& offset, const glm::uvec2& size, Callback callback);
+
+        // the window's back buffer (or the headless offscreen one) as RGBA8, before it is swapped.
+        bool readDefault(Callback callback);
+
+        // delivers finished reads, non-blocking. GL thread.
+        void poll();
+
+        // waits for and delivers every read in flight. GL thread.
+        void finish();
+
+        [[nodiscard]] size_t getPendingCount() const noexcept;
+        [[nodiscard]] const Stats& getStats() const noexcept;
+
+        static void init();
+        static void cleanup();
+
+    private:
+        struct Slot {
+            unsigned int buffer = 0;
+            std::byte* mapped = nullptr;
+            size_t capacity = 0;
+
+            GLsync sync = nullptr;
+            glm::uvec2 size{};
+            TextureFormat format = TextureFormat::RGBA8;
+            uint64_t frame = 0;
+            Callback callback;
+        };
+
+        bool read(unsigned int framebuffer, unsigned int buffer, const glm::uvec2& offset, const glm::uvec2& size,
+                  TextureFormat format, Callback callback);
+        void reserve(Slot& slot, size_t bytes);
+        void deliver(Slot& slot);
+
+        std::vector<Slot> m_Slots;
+        std::deque<size_t> m_InFlight;  // slot indices in request order
+        uint64_t m_Frame = 0;
+        Stats m_Stats;
+    };
+
+    namespace gbl {
+        // created once a GL context exists, see gbl::setup
+        inline std::unique_ptr<ReadbackRing> readback;
+    }
+}
@@ -0,0 +1,184 @@
+#include "render_queue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+
+namespace kat {
+    constexpr uint64_t maskBits(uint64_t value, unsigned int bits) {
+        return value & ((uint64_t(1) << bits) - 1);
+    }
+
+    uint64_t quantizeDepth(float depth, unsigned int bits) {
+        double d = std::clamp(static_cast<double>(depth), 0.0, 1.0);
+        return static_cast<uint64_t>(d * static_cast<double>((uint64_t(1) << bits) - 1));
+    }
+
+    RenderQueue::RenderQueue(std::string textureUniform, std::string regionUniform, std::string layerUniform)
+            : m_TextureUniform(std::move(textureUniform)), m_RegionUniform(std::move(regionUniform)),
+              m_LayerUniform(std::move(layerUniform)) {
+    }
+
+    void RenderQueue::setLayerTranslucent(uint8_t layer, bool translucent) {
+        m_Translucent.set(layer, translucent);
+    }
+
+    bool RenderQueue::isLayerTranslucent(uint8_t layer) const {
+        return m_Translucent.test(layer);
+    }
+
+    uint64_t RenderQueue::makeKey(uint8_t layer, float depth, const DrawCommand &command) const {
+        uint64_t key = static_cast<uint64_t>(layer) << 56;
+
+        if (isLayerTranslucent(layer)) {
+            // back to front, so invert depth.
+            key |= (maskBits(~quantizeDepth(depth, 24), 24)) << 32;
+            return key;
+        }
+
+        uint64_t shader = command.shader ? command.shader->getHandle() : 0;
+        uint64_t texture = command.texture ? command.texture->getHandle() : 0;
+        uint64_t vertexArray = command.mesh ? command.mesh->getVertexArray()->getHandle() : 0;
+
+        key |= maskBits(shader, 12) << 44;
+        key |= maskBits(texture, 12) << 32;
+        key |= maskBits(vertexArray, 12) << 20;
+        key |= quantizeDepth(depth, 20);
+        return key;
+    }
+
+    void RenderQueue::push(uint8_t layer, float depth, GraphicsShader *shader, ITexture *texture, Mesh *mesh,
+                           const glm::mat4 &transform) {
+        push(layer, depth, DrawCommand{shader, texture, mesh, transform});
+    }
+
+    void RenderQueue::push(uint8_t layer, float depth, const DrawCommand &command) {
+        // submit binds the shader and draws the mesh unconditionally, a null texture just leaves the unit alone.
+        if (!command.shader || !command.mesh) {
+            spdlog::error("RenderQueue draws need a shader and a mesh, dropping one on layer {}", layer);
+            return;
+        }
+
+        m_Entries.push_back({makeKey(layer, depth, command), static_cast<uint32_t>(m_Commands.size())});
+        m_Commands.push_back(command);
+        m_Sorted = false;
+    }
+
+    void RenderQueue::sort() {
+        m_Stats = Stats{};
+        m_Stats.commands = m_Commands.size();
+        m_Stats.stateChangesUnsorted = countStateChanges(m_Commands, m_Entries, nullptr);
+
+        // LSD radix sort, 8 bits per pass. passes where every key shares the same byte are skipped, which is most of
+        // them when a frame only touches a few layers and shaders.
+        m_Scratch.resize(m_Entries.size());
+        for (unsigned int shift = 0; shift < 64; shift += 8) {
+            std::array<size_t, 256> counts{};
+            for (const auto& e : m_Entries) counts[(e.key >> shift) & 0xff]++;
+
+            if (std::find(counts.begin(), counts.end(), m_Entries.size()) != counts.end()) continue;
+
+            size_t total = 0;
+            for (auto& c : counts) {
+                size_t n = c;
+                c = total;
+                total += n;
+            }
+
+            for (const auto& e : m_Entries) m_Scratch[counts[(e.key >> shift) & 0xff]++] = e;
+            std::swap(m_Entries, m_Scratch);
+        }
+
+        m_Stats.stateChangesSorted = countStateChanges(m_Commands, m_Entries, &m_Stats);
+        m_Sorted = true;
+    }
+
+    void RenderQueue::submit() {
+        if (!m_Sorted) sort();
+
+        const GraphicsShader* shader = nullptr;
+        ITexture* texture = nullptr;
+        bool hasRegion = false, hasLayer = false;
+        std::optional<glm::vec4> region;
+        std::optional<float> arrayLayer;
+
+        for (const auto& e : m_Entries) {
+            const auto& command = m_Commands[e.command];
+
+            if (command.shader != shader) {
+                shader = command.shader;
+                shader->bind(false);
+                shader->setInteger(m_TextureUniform, 0);
+
+                hasRegion = shader->getUniformLocation(m_RegionUniform) >= 0;
+                hasLayer = shader->getUniformLocation(m_LayerUniform) >= 0;
+                region.reset();
+                arrayLayer.reset();
+            }
+
+            // uniforms stick to the program, so only changes are uploaded.
+            if (hasRegion && region != command.region) {
+                region = command.region;
+                shader->setVec4f(m_RegionUniform, command.region);
+            }
+
+            if (hasLayer && arrayLayer != command.layer) {
+                arrayLayer = command.layer;
+                shader->setFloat(m_LayerUniform, command.layer);
+            }
+
+            if (command.texture != texture) {
+                texture = command.texture;
+                if (texture) texture->bindUnit(0);
+            }
+
+            shader->applyDefaults(command.transform);
+            command.mesh->render();
+        }
+    }
+
+    void RenderQueue::clear() {
+        m_Commands.clear();
+        m_Entries.clear();
+        m_Sorted = false;
+    }
+
+    void RenderQueue::flush() {
+        sort();
+        submit();
+        clear();
+    }
+
+    size_t RenderQueue::size() const noexcept {
+        return m_Commands.size();
+    }
+
+    const RenderQueue::Stats &RenderQueue::getStats() const noexcept {
+        return m_Stats;
+    }
+
+    size_t RenderQueue::countStateChanges(const std::vector<DrawCommand> &commands, const std::vector<SortEntry> &order,
+                                          Stats *breakdown) {
+        const GraphicsShader* shader = nullptr;
+        const ITexture* texture = nullptr;
+        const VertexArray* vertexArray = nullptr;
+
+        size_t shaders = 0, textures = 0, vertexArrays = 0;
+        for (const auto& e : order) {
+            const auto& command = commands[e.command];
+            const VertexArray* va = command.mesh ? command.mesh->getVertexArray().get() : nullptr;
+
+            if (command.shader != shader) { shader = command.shader; shaders++; }
+            if (command.texture != texture) { texture = command.texture; textures++; }
+            if (va != vertexArray) { vertexArray = va; vertexArrays++; }
+        }
+
+        if (breakdown) {
+            breakdown->shaderChanges = shaders;
+            breakdown->textureChanges = textures;
+            breakdown->vertexArrayChanges = vertexArrays;
+        }
+
+        return shaders + textures + vertexArrays;
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "kat/engine.hpp"
+#include "kat/graphics/mesh.hpp"
+#include "kat/graphics/shader.hpp"
+#include "kat/graphics/texture.hpp"
+#include "kat/util/transform_stack.hpp"
+
+#include <bitset>
+#include <memory>
+
+namespace kat {
+
+    // Records draws instead of issuing them, then submits them sorted so that state changes are minimised.
+    //
+    // Sort key layout (most significant first):
+    //   opaque layers:      layer:8 | shader:12 | texture:12 | vertex array:12 | depth:20
+    //   translucent layers: layer:8 | depth:24  | 0:32
+    // The radix sort is stable, so translucent draws at the same depth keep painter's (submission) order.
+    // Ids are GL handles truncated to their bit width, a collision only costs an extra state change.
+    //
+    // Shaders declaring the region uniform (a vec4, min uv in xy and max uv in zw) get each draw's region, and those
+    // declaring the layer uniform (a float) its array layer. That's how sprites of one atlas page or one texture array
+    // share a quad and a texture bind.
+    class RenderQueue {
+    public:
+
+        struct DrawCommand {
+            GraphicsShader* shader;
+            ITexture* texture;
+            Mesh* mesh;
+            glm::mat4 transform;
+            glm::vec4 region = { 0.0f, 0.0f, 1.0f, 1.0f };
+            float layer = 0.0f;
+        };
+
+        struct Stats {
+            size_t commands = 0;
+
+            // state changes (shader, texture or vertex array) that the draws need in the given order.
+            size_t stateChangesUnsorted = 0;
+            size_t stateChangesSorted = 0;
+
+            size_t shaderChanges = 0;
+            size_t textureChanges = 0;
+            size_t vertexArrayChanges = 0;
+        };
+
+        static constexpr size_t MAX_LAYERS = 256;
+
+        explicit RenderQueue(std::string textureUniform = "uTexture", std::string regionUniform = "uRegion",
+                             std::string layerUniform = "uLayer");
+
+        void setLayerTranslucent(uint8_t layer, bool translucent = true);
+        [[nodiscard]] bool isLayerTranslucent(uint8_t layer) const;
+
+        // depth is expected in [0, 1], higher values are further away and drawn first on translucent layers.
+        // shader and mesh are required, draws missing either are dropped with an error.
+        void push(uint8_t layer, float depth, GraphicsShader* shader, ITexture* texture, Mesh* mesh,
+                  const glm::mat4& transform = kat::transform::getTransform());
+
+        void push(uint8_t layer, float depth, const DrawCommand& command);
+
+        // accepts raw, shared and unique pointers alike.
+        template<typename S, typename T, typename M>
+        void push(uint8_t layer, float depth, const S& shader, const T& texture, const M& mesh,
+                  const glm::mat4& transform = kat::transform::getTransform()) {
+            push(layer, depth, std::to_address(shader), std::to_address(texture), std::to_address(mesh), transform);
+        }
+
+        void sort();
+        void submit();
+        void clear();
+
+        // sort + submit + clear, what you want once per frame.
+        void flush();
+
+        [[nodiscard]] size_t size() const noexcept;
+        [[nodiscard]] const Stats& getStats() const noexcept;
+
+        [[nodiscard]] uint64_t makeKey(uint8_t layer, float depth, const DrawCommand& command) const;
+
+    private:
+        struct SortEntry {
+            uint64_t key;
+            uint32_t command;
+        };
+
+        static size_t countStateChanges(const std::vector<DrawCommand>& commands, const std::vector<SortEntry>& order, Stats* breakdown);
+
+        std::string m_TextureUniform;
+        std::string m_RegionUniform;
+        std::string m_LayerUniform;
+        std::bitset<MAX_LAYERS> m_Translucent;
+
+        std::vector<DrawCommand> m_Commands;
+        std::vector<SortEntry> m_Entries;
+        std::vector<SortEntry> m_Scratch;
+
+        Stats m_Stats;
+        bool m_Sorted = false;
+    };
+}
@@ -0,0 +1,87 @@
+#include "render_stats.hpp"
+
+namespace kat {
+    RenderCounters &RenderCounters::operator+=(const RenderCounters &other) {
+        drawCalls += other.drawCalls;
+        indirectCommands += other.indirectCommands;
+        vertices += other.vertices;
+        indices += other.indices;
+        instances += other.instances;
+        dispatches += other.dispatches;
+
+        programBinds += other.programBinds;
+        vertexArrayBinds += other.vertexArrayBinds;
+        textureBinds += other.textureBinds;
+        framebufferBinds += other.framebufferBinds;
+        uniformUpdates += other.uniformUpdates;
+
+        bufferUploads += other.bufferUploads;
+        bufferBytes += other.bufferBytes;
+        textureUploads += other.textureUploads;
+        textureBytes += other.textureBytes;
+
+        clears += other.clears;
+        return *this;
+    }
+
+    RenderStats::RenderStats() : RenderStats(Config{}) {}
+
+    RenderStats::RenderStats(const Config &config) : m_Config(config), m_LastLog(std::chrono::steady_clock::now()) {}
+
+    void RenderStats::endFrame() {
+        m_LastFrame = m_Current;
+        m_Total += m_Current;
+        m_Current = {};
+        m_Frames++;
+
+        if (m_Config.logInterval <= 0.0) return;
+
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration<double>(now - m_LastLog).count() < m_Config.logInterval) return;
+
+        m_LastLog = now;
+        log();
+    }
+
+    const RenderCounters &RenderStats::getCurrent() const noexcept {
+        return m_Current;
+    }
+
+    const RenderCounters &RenderStats::getLastFrame() const noexcept {
+        return m_LastFrame;
+    }
+
+    const RenderCounters &RenderStats::getTotal() const noexcept {
+        return m_Total;
+    }
+
+    uint64_t RenderStats::getFrameCount() const noexcept {
+        return m_Frames;
+    }
+
+    void RenderStats::log() const {
+        if (m_Frames == 0) return;
+
+        const auto& f = m_LastFrame;
+        double frames = static_cast<double>(m_Frames);
+        auto perFrame = [&](uint64_t total) { return static_cast<double>(total) / frames; };
+
+        spdlog::info("last frame: {} draws ({} indirect commands, {} vertices, {} indices, {} instances), {} dispatches, {} clears",
+                     f.drawCalls, f.indirectCommands, f.vertices, f.indices, f.instances, f.dispatches, f.clears);
+        spdlog::info("last frame: binds {} program / {} vertex array / {} texture / {} framebuffer, {} uniforms, "
+                     "{} buffer uploads ({} bytes), {} texture uploads ({} bytes)", f.programBinds, f.vertexArrayBinds,
+                     f.textureBinds, f.framebufferBinds, f.uniformUpdates, f.bufferUploads, f.bufferBytes,
+                     f.textureUploads, f.textureBytes);
+        spdlog::info("per frame over {}: {:.1f} draws, {:.1f} binds, {:.1f} uniforms, {:.0f} buffer / {:.0f} texture bytes uploaded",
+                     m_Frames, perFrame(m_Total.drawCalls),
+                     perFrame(m_Total.programBinds + m_Total.vertexArrayBinds + m_Total.textureBinds + m_Total.framebufferBinds),
+                     perFrame(m_Total.uniformUpdates), perFrame(m_Total.bufferBytes), perFrame(m_Total.textureBytes));
+    }
+
+    void RenderStats::reset() {
+        m_Current = {};
+        m_LastFrame = {};
+        m_Total = {};
+        m_Frames = 0;
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "kat/engine.hpp"
+
+#include <chrono>
+
+namespace kat {
+
+    // What one frame asked of GL. indirect draws count once per call, their vertices and instances are on the GPU.
+    struct RenderCounters {
+        uint64_t drawCalls = 0;
+        uint64_t indirectCommands = 0;
+        uint64_t vertices = 0;          // non-indexed draws
+        uint64_t indices = 0;
+        uint64_t instances = 0;
+        uint64_t dispatches = 0;
+
+        uint64_t programBinds = 0;
+        uint64_t vertexArrayBinds = 0;
+        uint64_t textureBinds = 0;
+        uint64_t framebufferBinds = 0;
+        uint64_t uniformUpdates = 0;
+
+        uint64_t bufferUploads = 0;
+        uint64_t bufferBytes = 0;
+        uint64_t textureUploads = 0;
+        uint64_t textureBytes = 0;
+
+        uint64_t clears = 0;
+
+        RenderCounters& operator+=(const RenderCounters& other);
+    };
+
+    // Engine-wide counters, bumped from the GL wrappers and rolled over on every present. They're plain increments on
+    // the GL thread, cheap enough to always be on.
+    class RenderStats {
+    public:
+        struct Config {
+            double logInterval = 60.0;  // seconds between periodic logs, 0 to only log by hand
+        };
+
+        RenderStats();
+        explicit RenderStats(const Config& config);
+
+        inline void draw(uint64_t vertices, uint64_t indices, uint64_t instances = 1) {
+            m_Current.drawCalls++;
+            m_Current.vertices += vertices;
+            m_Current.indices += indices;
+            m_Current.instances += instances;
+        };
+
+        inline void drawIndirect(uint64_t commands) {
+            m_Current.drawCalls++;
+            m_Current.indirectCommands += commands;
+        };
+
+        inline void dispatch() { m_Current.dispatches++; };
+        inline void programBind() { m_Current.programBinds++; };
+        inline void vertexArrayBind() { m_Current.vertexArrayBinds++; };
+        inline void textureBind() { m_Current.textureBinds++; };
+        inline void framebufferBind() { m_Current.framebufferBinds++; };
+        inline void uniformUpdate() { m_Current.uniformUpdates++; };
+        inline void clear() { m_Current.clears++; };
+
+        inline void bufferUpload(uint64_t bytes) {
+            m_Current.bufferUploads++;
+            m_Current.bufferBytes += bytes;
+        };
+
+        inline void textureUpload(uint64_t bytes) {
+            m_Current.textureUploads++;
+            m_Current.textureBytes += bytes;
+        };
+
+        // closes the frame, and logs when logInterval passed since the last one. runs after every present.
+        void endFrame();
+
+        // so far this frame, the last complete one, and every frame since the last reset.
+        [[nodiscard]] const RenderCounters& getCurrent() const noexcept;
+        [[nodiscard]] const RenderCounters& getLastFrame() const noexcept;
+        [[nodiscard]] const RenderCounters& getTotal() const noexcept;
+        [[nodiscard]] uint64_t getFrameCount() const noexcept;
+
+        void log() const;
+        void reset();
+
+    private:
+        Config m_Config;
+
+        RenderCounters m_Current;
+        RenderCounters m_LastFrame;
+        RenderCounters m_Total;
+        uint64_t m_Frames = 0;
+
+        std::chrono::steady_clock::time_point m_LastLog;
+    };
+
+    namespace gbl {
+        // GL thread only.
+        inline RenderStats renderStats;
+    }
+}
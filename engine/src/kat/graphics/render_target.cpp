@@ -1,5 +1,6 @@
 #include "render_target.hpp"
 #include "kat/os.hpp"
+#include "kat/graphics/render_stats.hpp"
 
 namespace kat {
     Framebuffer::Framebuffer(const glm::uvec2 &size) : m_Size(size) {
@@ -74,11 +75,13 @@ namespace kat {
     }
 
     void Framebuffer::bind() const {
+        gbl::renderStats.framebufferBind();
         glBindFramebuffer(GL_FRAMEBUFFER, m_Handle);
     }
 
     void Framebuffer::bindDefault() {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        gbl::renderStats.framebufferBind();
+        glBindFramebuffer(GL_FRAMEBUFFER, kat::gbl::activeWindow->getDefaultFramebuffer());
     }
 
     void Framebuffer::bindDefaultViewport() {
@@ -1,7 +1,12 @@
 #include "shader.hpp"
 
+#include <algorithm>
+
 #include <glm/gtc/type_ptr.hpp>
 #include "kat/graphics/texture.hpp"
+#include "kat/graphics/mesh.hpp"
+#include "kat/graphics/render_stats.hpp"
+#include "kat/io/file.hpp"
 #include "kat/util/clock.hpp"
 #include "kat/util/transform_stack.hpp"
 
@@ -59,10 +64,11 @@ namespace kat {
     }
 
 
-    ShaderType getTypeFromSource(const std::string& src) {
-        auto ss = std::stringstream(src);
-        for (std::string line; std::getline(ss, line); ) {
-            std::string stripped = util::strip(line);
+    ShaderType getTypeFromSource(std::string_view src) {
+        // only the lines up to #version are looked at, so this doesn't copy the whole source.
+        for (size_t start = 0, end; start < src.size(); start = end + 1) {
+            end = std::min(src.find('\n', start), src.size());
+            std::string stripped = util::strip(std::string(src.substr(start, end - start)));
             if (stripped.starts_with("#type")) {
                 std::string ty = stripped.substr(6);
                 return getTypeFromName(ty);
@@ -74,28 +80,41 @@ namespace kat {
         return ShaderType::Unknown;
     }
 
+    static io::Blob readSource(const std::filesystem::path &path) {
+        auto blob = io::read(path);
+        if (!blob) spdlog::error("Shader {} is missing", path.string());
+        return blob;
+    }
+
     std::shared_ptr<ShaderModule> ShaderModule::load(const std::filesystem::path &path) {
-        std::string src = util::readFile(path);
-        ShaderType ty = getTypeFromSource(src);
+        auto src = readSource(path);
+        return load(path, src.getString());
+    }
+
+    std::shared_ptr<ShaderModule> ShaderModule::load(const std::filesystem::path &path, std::string_view source) {
+        ShaderType ty = getTypeFromSource(source);
         if (ty == ShaderType::Unknown)
             ty = inferShaderType(path);
         if (ty == ShaderType::Unknown)
             throw std::runtime_error("Failed to infer shader type");
 
-        return std::make_shared<ShaderModule>(ty, src);
+        return std::make_shared<ShaderModule>(ty, source);
     }
 
     std::shared_ptr<ShaderModule> ShaderModule::load(ShaderType type, const std::filesystem::path &path) {
-        return std::make_shared<ShaderModule>(type, util::readFile(path));
+        return std::make_shared<ShaderModule>(type, readSource(path).getString());
     }
 
-    ShaderModule::ShaderModule(ShaderType type, const std::string &source) : m_Type(type) {
+    ShaderModule::ShaderModule(ShaderType type, std::string_view source) : m_Type(type) {
+        KAT_PROFILE_SCOPE("compile shader");
         auto i = source.find("#version"); // cut to the start of the source
-        std::string src = source.substr(i);
+        if (i != std::string_view::npos) source.remove_prefix(i);
 
+        // handed to GL with its length, so mapped files can be compiled in place.
         m_Handle = glCreateShader(static_cast<unsigned int>(m_Type));
-        const char* csrc = src.c_str();
-        glShaderSource(m_Handle, 1, &csrc, nullptr);
+        const char* csrc = source.data();
+        int length = static_cast<int>(source.size());
+        glShaderSource(m_Handle, 1, &csrc, &length);
         glCompileShader(m_Handle);
 
         int status;
@@ -112,33 +131,15 @@ namespace kat {
         }
     }
 
-    ShaderModule::ShaderModule(const std::string &source) {
+    static ShaderType requireTypeFromSource(std::string_view source) {
         ShaderType type = getTypeFromSource(source);
         if (type == ShaderType::Unknown)
             throw std::runtime_error("Failed to infer shader type");
-
-        auto i = source.find("#version"); // cut to the start of the source
-        std::string src = source.substr(i);
-
-        m_Handle = glCreateShader(static_cast<unsigned int>(m_Type));
-        const char* csrc = src.c_str();
-        glShaderSource(m_Handle, 1, &csrc, nullptr);
-        glCompileShader(m_Handle);
-
-        int status;
-        glGetShaderiv(m_Handle, GL_COMPILE_STATUS, &status);
-        if (status != GL_TRUE) {
-            glGetShaderiv(m_Handle, GL_INFO_LOG_LENGTH, &status);
-
-            char* buf = new char[status];
-            glGetShaderInfoLog(m_Handle, status, nullptr, buf);
-
-            spdlog::critical("Failed to compile shader: {}", buf);
-
-            delete[] buf;
-        }
+        return type;
     }
 
+    ShaderModule::ShaderModule(std::string_view source) : ShaderModule(requireTypeFromSource(source), source) {}
+
     ShaderModule::~ShaderModule() {
         glDeleteShader(m_Handle);
     }
@@ -229,6 +230,7 @@ namespace kat {
     }
 
     void GraphicsShader::bind(bool applyDefaults_) const {
+        gbl::renderStats.programBind();
         glUseProgram(m_Handle);
         if (applyDefaults_) applyDefaults();
     }
@@ -237,141 +239,146 @@ namespace kat {
         return glGetUniformLocation(m_Handle, name.c_str());
     }
 
+    int GraphicsShader::updateUniform(const std::string &name) const {
+        gbl::renderStats.uniformUpdate();
+        return getUniformLocation(name);
+    }
+
     void GraphicsShader::setInteger(const std::string &name, int x) const {
-        glProgramUniform1i(m_Handle, getUniformLocation(name), x);
+        glProgramUniform1i(m_Handle, updateUniform(name), x);
     }
 
     void GraphicsShader::setVec2i(const std::string &name, int x, int y) const {
-        glProgramUniform2i(m_Handle, getUniformLocation(name), x, y);
+        glProgramUniform2i(m_Handle, updateUniform(name), x, y);
     }
 
     void GraphicsShader::setVec3i(const std::string &name, int x, int y, int z) const {
-        glProgramUniform3i(m_Handle, getUniformLocation(name), x, y, z);
+        glProgramUniform3i(m_Handle, updateUniform(name), x, y, z);
     }
 
     void GraphicsShader::setVec4i(const std::string &name, int x, int y, int z, int w) const {
-        glProgramUniform4i(m_Handle, getUniformLocation(name), x, y, z, w);
+        glProgramUniform4i(m_Handle, updateUniform(name), x, y, z, w);
     }
 
     void GraphicsShader::setVec2i(const std::string &name, const glm::ivec2 &v) const {
-        glProgramUniform2iv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform2iv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void GraphicsShader::setVec3i(const std::string &name, const glm::ivec3 &v) const {
-        glProgramUniform3iv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform3iv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void GraphicsShader::setVec4i(const std::string &name, const glm::ivec4 &v) const {
-        glProgramUniform4iv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform4iv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void GraphicsShader::setFloat(const std::string &name, float x) const {
-        glProgramUniform1f(m_Handle, getUniformLocation(name), x);
+        glProgramUniform1f(m_Handle, updateUniform(name), x);
     }
 
     void GraphicsShader::setVec2f(const std::string &name, float x, float y) const {
-        glProgramUniform2f(m_Handle, getUniformLocation(name), x, y);
+        glProgramUniform2f(m_Handle, updateUniform(name), x, y);
     }
 
     void GraphicsShader::setVec3f(const std::string &name, float x, float y, float z) const {
-        glProgramUniform3f(m_Handle, getUniformLocation(name), x, y, z);
+        glProgramUniform3f(m_Handle, updateUniform(name), x, y, z);
     }
 
     void GraphicsShader::setVec4f(const std::string &name, float x, float y, float z, float w) const {
-        glProgramUniform4f(m_Handle, getUniformLocation(name), x, y, z, w);
+        glProgramUniform4f(m_Handle, updateUniform(name), x, y, z, w);
     }
 
     void GraphicsShader::setVec2f(const std::string &name, const glm::fvec2 &v) const {
-        glProgramUniform2fv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform2fv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void GraphicsShader::setVec3f(const std::string &name, const glm::fvec3 &v) const {
-        glProgramUniform3fv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform3fv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void GraphicsShader::setVec4f(const std::string &name, const glm::fvec4 &v) const {
-        glProgramUniform4fv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform4fv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void GraphicsShader::setUnsignedInt(const std::string &name, unsigned int x) const {
-        glProgramUniform1ui(m_Handle, getUniformLocation(name), x);
+        glProgramUniform1ui(m_Handle, updateUniform(name), x);
     }
 
     void GraphicsShader::setVec2u(const std::string &name, unsigned int x, unsigned int y) const {
-        glProgramUniform2ui(m_Handle, getUniformLocation(name), x, y);
+        glProgramUniform2ui(m_Handle, updateUniform(name), x, y);
     }
 
     void GraphicsShader::setVec3u(const std::string &name, unsigned int x, unsigned int y, unsigned int z) const {
-        glProgramUniform3ui(m_Handle, getUniformLocation(name), x, y, z);
+        glProgramUniform3ui(m_Handle, updateUniform(name), x, y, z);
     }
 
     void GraphicsShader::setVec4u(const std::string &name, unsigned int x, unsigned int y, unsigned int z, unsigned int w) const {
-        glProgramUniform4ui(m_Handle, getUniformLocation(name), x, y, z, w);
+        glProgramUniform4ui(m_Handle, updateUniform(name), x, y, z, w);
     }
 
     void GraphicsShader::setVec2u(const std::string &name, const glm::uvec2 &v) const {
-        glProgramUniform2uiv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform2uiv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void GraphicsShader::setVec3u(const std::string &name, const glm::uvec3 &v) const {
-        glProgramUniform3uiv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform3uiv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void GraphicsShader::setVec4u(const std::string &name, const glm::uvec4 &v) const {
-        glProgramUniform4uiv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform4uiv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
 
     void GraphicsShader::setMatrix2f(const std::string &name, const glm::mat2 &m) const {
-        glProgramUniformMatrix2fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix2fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void GraphicsShader::setMatrix2x2f(const std::string &name, const glm::mat2x2 &m) const {
-        glProgramUniformMatrix2fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix2fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void GraphicsShader::setMatrix2x3f(const std::string &name, const glm::mat2x3 &m) const {
-        glProgramUniformMatrix2x3fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix2x3fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void GraphicsShader::setMatrix2x4f(const std::string &name, const glm::mat2x4 &m) const {
-        glProgramUniformMatrix2x4fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix2x4fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void GraphicsShader::setMatrix3f(const std::string &name, const glm::mat3 &m) const {
-        glProgramUniformMatrix3fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix3fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void GraphicsShader::setMatrix3x2f(const std::string &name, const glm::mat3x2 &m) const {
-        glProgramUniformMatrix3x2fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix3x2fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void GraphicsShader::setMatrix3x3f(const std::string &name, const glm::mat3x3 &m) const {
-        glProgramUniformMatrix3fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix3fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void GraphicsShader::setMatrix3x4f(const std::string &name, const glm::mat3x4 &m) const {
-        glProgramUniformMatrix3x4fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix3x4fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void GraphicsShader::setMatrix4f(const std::string &name, const glm::mat4 &m) const {
-        glProgramUniformMatrix4fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix4fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void GraphicsShader::setMatrix4x2f(const std::string &name, const glm::mat4x2 &m) const {
-        glProgramUniformMatrix4x2fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix4x2fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void GraphicsShader::setMatrix4x3f(const std::string &name, const glm::mat4x3 &m) const {
-        glProgramUniformMatrix4x3fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix4x3fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void GraphicsShader::setMatrix4x4f(const std::string &name, const glm::mat4x4 &m) const {
-        glProgramUniformMatrix4fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix4fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     std::shared_ptr<ComputeShader> ComputeShader::load(const std::filesystem::path& path) {
-        return std::make_shared<ComputeShader>(util::readFile(path));
+        return std::make_shared<ComputeShader>(readSource(path).getString());
     }
 
     ComputeShader::ComputeShader(const std::shared_ptr<ShaderModule> &module) {
@@ -394,7 +401,7 @@ namespace kat {
         }
     }
 
-    ComputeShader::ComputeShader(const std::string &source) {
+    ComputeShader::ComputeShader(std::string_view source) {
         std::shared_ptr<ShaderModule> module = std::make_shared<ShaderModule>(ShaderType::Compute, source);
 
         m_Handle = glCreateProgram();
@@ -424,165 +431,215 @@ namespace kat {
     }
 
     void ComputeShader::bind() const {
+        gbl::renderStats.programBind();
         glUseProgram(m_Handle);
     }
 
     void ComputeShader::dispatch(unsigned int xGroups, unsigned int yGroups, unsigned int zGroups) const {
+        for (const auto& [binding, b] : m_StorageBindings) {
+            if (reads(b.access)) gbl::barriers.require(ResourceKind::Buffer, b.handle, BarrierUsage::Storage);
+        }
+        for (const auto& [unit, b] : m_ImageBindings) {
+            if (reads(b.access)) gbl::barriers.require(ResourceKind::Texture, b.handle, BarrierUsage::ImageAccess);
+        }
+
         bind();
         glDispatchCompute(xGroups, yGroups, zGroups);
+        gbl::renderStats.dispatch();
+
+        for (const auto& [binding, b] : m_StorageBindings) {
+            if (writes(b.access)) gbl::barriers.written(ResourceKind::Buffer, b.handle);
+        }
+        for (const auto& [unit, b] : m_ImageBindings) {
+            if (writes(b.access)) gbl::barriers.written(ResourceKind::Texture, b.handle);
+        }
+    }
+
+    void ComputeShader::bindStorageBuffer(unsigned int binding, const Buffer &buffer, Access access) {
+        // write after write still needs ordering against the previous dispatch.
+        if (writes(access)) gbl::barriers.require(ResourceKind::Buffer, buffer.getHandle(), BarrierUsage::Storage);
+
+        buffer.bindStorage(binding);
+        m_StorageBindings[binding] = Binding{buffer.getHandle(), access};
+    }
+
+    void ComputeShader::bindImage(unsigned int unit, const ITexture &texture, Access access, TextureFormat format, int level) {
+        if (writes(access)) gbl::barriers.require(ResourceKind::Texture, texture.getHandle(), BarrierUsage::ImageAccess);
+
+        glBindImageTexture(unit, texture.getHandle(), level, GL_FALSE, 0, static_cast<GLenum>(access),
+                           static_cast<GLenum>(glInternalFormatOf(format)));
+        m_ImageBindings[unit] = Binding{texture.getHandle(), access};
     }
 
     int ComputeShader::getUniformLocation(const std::string &name) const {
         return glGetUniformLocation(m_Handle, name.c_str());
     }
 
+    int ComputeShader::updateUniform(const std::string &name) const {
+        gbl::renderStats.uniformUpdate();
+        return getUniformLocation(name);
+    }
+
     void ComputeShader::setInteger(const std::string &name, int x) const {
-        glProgramUniform1i(m_Handle, getUniformLocation(name), x);
+        glProgramUniform1i(m_Handle, updateUniform(name), x);
     }
 
     void ComputeShader::setVec2i(const std::string &name, int x, int y) const {
-        glProgramUniform2i(m_Handle, getUniformLocation(name), x, y);
+        glProgramUniform2i(m_Handle, updateUniform(name), x, y);
     }
 
     void ComputeShader::setVec3i(const std::string &name, int x, int y, int z) const {
-        glProgramUniform3i(m_Handle, getUniformLocation(name), x, y, z);
+        glProgramUniform3i(m_Handle, updateUniform(name), x, y, z);
     }
 
     void ComputeShader::setVec4i(const std::string &name, int x, int y, int z, int w) const {
-        glProgramUniform4i(m_Handle, getUniformLocation(name), x, y, z, w);
+        glProgramUniform4i(m_Handle, updateUniform(name), x, y, z, w);
     }
 
     void ComputeShader::setVec2i(const std::string &name, const glm::ivec2 &v) const {
-        glProgramUniform2iv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform2iv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void ComputeShader::setVec3i(const std::string &name, const glm::ivec3 &v) const {
-        glProgramUniform3iv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform3iv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void ComputeShader::setVec4i(const std::string &name, const glm::ivec4 &v) const {
-        glProgramUniform4iv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform4iv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void ComputeShader::setFloat(const std::string &name, float x) const {
-        glProgramUniform1f(m_Handle, getUniformLocation(name), x);
+        glProgramUniform1f(m_Handle, updateUniform(name), x);
     }
 
     void ComputeShader::setVec2f(const std::string &name, float x, float y) const {
-        glProgramUniform2f(m_Handle, getUniformLocation(name), x, y);
+        glProgramUniform2f(m_Handle, updateUniform(name), x, y);
     }
 
     void ComputeShader::setVec3f(const std::string &name, float x, float y, float z) const {
-        glProgramUniform3f(m_Handle, getUniformLocation(name), x, y, z);
+        glProgramUniform3f(m_Handle, updateUniform(name), x, y, z);
     }
 
     void ComputeShader::setVec4f(const std::string &name, float x, float y, float z, float w) const {
-        glProgramUniform4f(m_Handle, getUniformLocation(name), x, y, z, w);
+        glProgramUniform4f(m_Handle, updateUniform(name), x, y, z, w);
     }
 
     void ComputeShader::setVec2f(const std::string &name, const glm::fvec2 &v) const {
-        glProgramUniform2fv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform2fv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void ComputeShader::setVec3f(const std::string &name, const glm::fvec3 &v) const {
-        glProgramUniform3fv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform3fv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void ComputeShader::setVec4f(const std::string &name, const glm::fvec4 &v) const {
-        glProgramUniform4fv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform4fv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void ComputeShader::setUnsignedInt(const std::string &name, unsigned int x) const {
-        glProgramUniform1ui(m_Handle, getUniformLocation(name), x);
+        glProgramUniform1ui(m_Handle, updateUniform(name), x);
     }
 
     void ComputeShader::setVec2u(const std::string &name, unsigned int x, unsigned int y) const {
-        glProgramUniform2ui(m_Handle, getUniformLocation(name), x, y);
+        glProgramUniform2ui(m_Handle, updateUniform(name), x, y);
     }
 
     void ComputeShader::setVec3u(const std::string &name, unsigned int x, unsigned int y, unsigned int z) const {
-        glProgramUniform3ui(m_Handle, getUniformLocation(name), x, y, z);
+        glProgramUniform3ui(m_Handle, updateUniform(name), x, y, z);
     }
 
     void ComputeShader::setVec4u(const std::string &name, unsigned int x, unsigned int y, unsigned int z, unsigned int w) const {
-        glProgramUniform4ui(m_Handle, getUniformLocation(name), x, y, z, w);
+        glProgramUniform4ui(m_Handle, updateUniform(name), x, y, z, w);
     }
 
     void ComputeShader::setVec2u(const std::string &name, const glm::uvec2 &v) const {
-        glProgramUniform2uiv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform2uiv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void ComputeShader::setVec3u(const std::string &name, const glm::uvec3 &v) const {
-        glProgramUniform3uiv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform3uiv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
     void ComputeShader::setVec4u(const std::string &name, const glm::uvec4 &v) const {
-        glProgramUniform4uiv(m_Handle, getUniformLocation(name), 1, glm::value_ptr(v));
+        glProgramUniform4uiv(m_Handle, updateUniform(name), 1, glm::value_ptr(v));
     }
 
 
     void ComputeShader::setMatrix2f(const std::string &name, const glm::mat2 &m) const {
-        glProgramUniformMatrix2fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix2fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void ComputeShader::setMatrix2x2f(const std::string &name, const glm::mat2x2 &m) const {
-        glProgramUniformMatrix2fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix2fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void ComputeShader::setMatrix2x3f(const std::string &name, const glm::mat2x3 &m) const {
-        glProgramUniformMatrix2x3fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix2x3fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void ComputeShader::setMatrix2x4f(const std::string &name, const glm::mat2x4 &m) const {
-        glProgramUniformMatrix2x4fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix2x4fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void ComputeShader::setMatrix3f(const std::string &name, const glm::mat3 &m) const {
-        glProgramUniformMatrix3fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix3fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void ComputeShader::setMatrix3x2f(const std::string &name, const glm::mat3x2 &m) const {
-        glProgramUniformMatrix3x2fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix3x2fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void ComputeShader::setMatrix3x3f(const std::string &name, const glm::mat3x3 &m) const {
-        glProgramUniformMatrix3fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix3fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void ComputeShader::setMatrix3x4f(const std::string &name, const glm::mat3x4 &m) const {
-        glProgramUniformMatrix3x4fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix3x4fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void ComputeShader::setMatrix4f(const std::string &name, const glm::mat4 &m) const {
-        glProgramUniformMatrix4fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix4fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void ComputeShader::setMatrix4x2f(const std::string &name, const glm::mat4x2 &m) const {
-        glProgramUniformMatrix4x2fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix4x2fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void ComputeShader::setMatrix4x3f(const std::string &name, const glm::mat4x3 &m) const {
-        glProgramUniformMatrix4x3fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix4x3fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     void ComputeShader::setMatrix4x4f(const std::string &name, const glm::mat4x4 &m) const {
-        glProgramUniformMatrix4fv(m_Handle, getUniformLocation(name), 1, false, glm::value_ptr(m));
+        glProgramUniformMatrix4fv(m_Handle, updateUniform(name), 1, false, glm::value_ptr(m));
     }
 
     // Texture extension
     void
     GraphicsShader::bindTexture(const std::string &name, int unit, const std::shared_ptr<Texture2D> &texture) {
-        texture->bindUnit(0);
+        bindTexture(name, unit, *texture);
+    }
+
+    void GraphicsShader::bindTexture(const std::string &name, int unit, ITexture &texture) {
+        texture.bindUnit(unit);
         setInteger(name, unit);
     }
 
+    void GraphicsShader::bindStorageBuffer(unsigned int binding, const Buffer &buffer) const {
+        gbl::barriers.require(ResourceKind::Buffer, buffer.getHandle(), BarrierUsage::Storage);
+        buffer.bindStorage(binding);
+    }
+
     void GraphicsShader::applyDefaults() const {
+        applyDefaults(kat::transform::getTransform());
+    }
+
+    void GraphicsShader::applyDefaults(const glm::mat4 &transform) const {
         if (m_HasTimeUniform) {
             setFloat("uTime", static_cast<float>(kat::gbl::clock.getThisFrame().time_since_epoch().count()));
         }
 
         if (m_HasTransformUniform) {
-            setMatrix4f("uTransform", kat::transform::getTransform());
+            setMatrix4f("uTransform", transform);
         }
     }
 
@@ -1,12 +1,17 @@
 #pragma once
 
 #include "kat/engine.hpp"
+#include "kat/graphics/barriers.hpp"
+#include <map>
 #include <string>
 #include <filesystem>
 
 namespace kat {
     // Forward Decls
+    class ITexture;
     class Texture2D;
+    class Buffer;
+    enum class TextureFormat;
 
     // shader.hpp Decls
 
@@ -27,9 +32,10 @@ namespace kat {
 
         static std::shared_ptr<ShaderModule> load(const std::filesystem::path& path); // infers from extension
         static std::shared_ptr<ShaderModule> load(ShaderType type, const std::filesystem::path& path);
+        static std::shared_ptr<ShaderModule> load(const std::filesystem::path& path, std::string_view source); // already read, path only names it
 
-        ShaderModule(ShaderType type, const std::string& source);
-        ShaderModule(const std::string& source);
+        ShaderModule(ShaderType type, std::string_view source);
+        ShaderModule(std::string_view source);
         ~ShaderModule();
 
         unsigned int operator*() const noexcept;
@@ -118,8 +124,13 @@ namespace kat {
         void setMatrix4x4f(const std::string& name, const glm::mat4x4& m) const;
 
         void bindTexture(const std::string& name, int unit, const std::shared_ptr<Texture2D>& texture);
+        void bindTexture(const std::string& name, int unit, ITexture& texture); // e.g. a Texture2DArray
+
+        // read only, as seen from the graphics pipeline.
+        void bindStorageBuffer(unsigned int binding, const Buffer& buffer) const;
 
         void applyDefaults() const;
+        void applyDefaults(const glm::mat4& transform) const; // for draws recorded with a transform earlier
 
     private:
         bool m_HasTimeUniform;
@@ -128,6 +139,9 @@ namespace kat {
         unsigned int m_Handle;
 
         void scan();
+
+        // getUniformLocation for a set*, counted as a uniform update.
+        [[nodiscard]] int updateUniform(const std::string& name) const;
     };
 
     class ComputeShader {
@@ -136,15 +150,20 @@ namespace kat {
         static std::shared_ptr<ComputeShader> load(const std::filesystem::path& path);
 
         ComputeShader(const std::shared_ptr<ShaderModule>& module);
-        ComputeShader(const std::string& source);
+        ComputeShader(std::string_view source);
 
         unsigned int operator*() const noexcept;
         [[nodiscard]] unsigned int getHandle() const noexcept;
 
         void bind() const;
 
+        // inserts whatever barriers the bound resources need first, and records what the dispatch writes.
         void dispatch(unsigned int xGroups, unsigned int yGroups, unsigned int zGroups) const;
 
+        // bindings are remembered per shader with their access, so rebind if another program used the same slot.
+        void bindStorageBuffer(unsigned int binding, const Buffer& buffer, Access access = Access::ReadWrite);
+        void bindImage(unsigned int unit, const ITexture& texture, Access access, TextureFormat format, int level = 0);
+
         [[nodiscard]] int getUniformLocation(const std::string& name) const;
 
         void setInteger(const std::string& name, int x) const;
@@ -188,7 +207,16 @@ namespace kat {
 
         void bindTexture(const std::string& name, int unit, const std::shared_ptr<Texture2D>& texture);
     private:
+        [[nodiscard]] int updateUniform(const std::string& name) const;
+
+        struct Binding {
+            unsigned int handle;
+            Access access;
+        };
 
         unsigned int m_Handle;
+
+        std::map<unsigned int, Binding> m_StorageBindings;
+        std::map<unsigned int, Binding> m_ImageBindings;
     };
 }
\ No newline at end of file
@@ -17,17 +17,34 @@ namespace kat {
         };
 
         s_SpriteMesh = std::make_unique<kat::Mesh>(vertices, PrimitiveMode::TriangleFan);
+
+        kat::TileMeshBuilder builder;
+        builder.addTile({ -1.0f, -1.0f }, { 1.0f, 1.0f }, 0);
+        s_ArrayMesh = builder.build();
     }
 
     void Sprite::cleanup() {
         s_SpriteShader = nullptr;
         s_SpriteMesh = nullptr;
+        s_ArrayMesh = nullptr;
     }
 
     Sprite::Sprite(const std::shared_ptr<kat::Texture2D> &texture, const glm::vec2 &size)
                  : m_TextureRegion(texture->getFullRegion()), m_Size(size) {
     }
 
+    Sprite::Sprite(const kat::Texture2D::Region &region, const glm::vec2 &size) : m_TextureRegion(region), m_Size(size) {
+    }
+
+    Sprite::Sprite(const std::shared_ptr<kat::Texture2DArray> &array, uint32_t layer, const glm::vec2 &size)
+                 : m_Array(array), m_Layer(layer), m_Size(size) {
+    }
+
+    glm::vec4 Sprite::getRegionUV() const {
+        auto [minUV, maxUV] = m_TextureRegion.getUVPair();
+        return { minUV, maxUV };
+    }
+
     void Sprite::render() {
         kat::graphics::polygonMode(kat::graphics::PolygonMode::Fill);
         kat::transform::push();
@@ -35,10 +52,39 @@ namespace kat {
         kat::transform::translate(m_Position);
         kat::transform::scale(m_Size);
 
-        s_SpriteShader->bind();
-        s_SpriteShader->bindTexture("uTexture", 0, m_TextureRegion.texture);
+        if (m_Array) {
+            auto& shader = kat::TileMeshBuilder::getShader();
+            shader.bind();
+            shader.bindTexture("uTexture", 0, *m_Array);
+            shader.setFloat("uLayer", static_cast<float>(m_Layer));
+
+            s_ArrayMesh->render();
+            shader.setFloat("uLayer", 0.0f);
+        } else {
+            s_SpriteShader->bind();
+            s_SpriteShader->bindTexture("uTexture", 0, m_TextureRegion.texture);
+            s_SpriteShader->setVec4f("uRegion", getRegionUV());
+
+            s_SpriteMesh->render();
+        }
+
+        kat::transform::pop();
+    }
+
+    void Sprite::enqueue(kat::RenderQueue &queue, uint8_t layer, float depth) {
+        kat::transform::push();
+
+        kat::transform::translate(m_Position);
+        kat::transform::scale(m_Size);
 
-        s_SpriteMesh->render();
+        if (m_Array) {
+            queue.push(layer, depth, { .shader = &kat::TileMeshBuilder::getShader(), .texture = m_Array.get(),
+                                       .mesh = s_ArrayMesh.get(), .transform = kat::transform::getTransform(),
+                                       .layer = static_cast<float>(m_Layer) });
+        } else {
+            queue.push(layer, depth, { s_SpriteShader.get(), m_TextureRegion.texture.get(), s_SpriteMesh.get(),
+                                       kat::transform::getTransform(), getRegionUV() });
+        }
 
         kat::transform::pop();
     }
@@ -4,6 +4,8 @@
 #include "kat/graphics/mesh.hpp"
 #include "kat/graphics/texture.hpp"
 #include "kat/graphics/shader.hpp"
+#include "kat/graphics/render_queue.hpp"
+#include "kat/graphics/tiles.hpp"
 #include "kat/util/interfaces.hpp"
 
 namespace kat {
@@ -33,10 +35,9 @@ namespace kat {
                                         "in vec4 fPosition;\n"
                                         "out vec4 colorOut;\n"
                                         "uniform sampler2D uTexture;\n"
-                                        "uniform vec2 uMinUV;\n"
-                                        "uniform vec2 uMaxUV;\n"
+                                        "uniform vec4 uRegion;\n"
                                         "void main() {\n"
-                                        "    vec2 uv = fUV * (uMaxUV - uMinUV) + uMinUV;"
+                                        "    vec2 uv = mix(uRegion.xy, uRegion.zw, fUV);\n"
                                         "    colorOut = texture(uTexture, uv);\n"
                                         "}";
     }
@@ -44,17 +45,27 @@ namespace kat {
     class Sprite : public kat::util::IPositionable<glm::vec2> {
     public:
         Sprite(const std::shared_ptr<kat::Texture2D>& texture, const glm::vec2& size);
+        Sprite(const kat::Texture2D::Region& region, const glm::vec2& size); // e.g. from a TextureAtlas
+
+        // drawn with the tile shader, so sprites of one array share a texture bind whatever their layer.
+        Sprite(const std::shared_ptr<kat::Texture2DArray>& array, uint32_t layer, const glm::vec2& size);
 
         void render();
+        void enqueue(kat::RenderQueue& queue, uint8_t layer, float depth = 0.0f);
 
         static void init();
         static void cleanup();
     private:
 
+        [[nodiscard]] glm::vec4 getRegionUV() const; // for uRegion
+
         kat::Texture2D::Region m_TextureRegion;
+        std::shared_ptr<kat::Texture2DArray> m_Array;
+        uint32_t m_Layer = 0;
         glm::vec2 m_Size;
 
         static inline std::unique_ptr<kat::GraphicsShader> s_SpriteShader;
         static inline std::unique_ptr<kat::Mesh> s_SpriteMesh;
+        static inline std::unique_ptr<kat::Mesh> s_ArrayMesh; // a layer 0 tile quad, the layer comes from uLayer
     };
 }
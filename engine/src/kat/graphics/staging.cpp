@@ -0,0 +1,91 @@
+#include "staging.hpp"
+
+namespace kat {
+    StagingRing::StagingRing(size_t capacity) : m_Capacity(capacity) {
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        glCreateBuffers(1, &m_Handle);
+        glNamedBufferStorage(m_Handle, static_cast<GLsizeiptr>(capacity), nullptr, flags);
+        m_Mapped = static_cast<std::byte*>(glMapNamedBufferRange(m_Handle, 0, static_cast<GLsizeiptr>(capacity), flags));
+    }
+
+    StagingRing::~StagingRing() {
+        for (auto& p : m_Pending) glDeleteSync(p.sync);
+
+        glUnmapNamedBuffer(m_Handle);
+        glDeleteBuffers(1, &m_Handle);
+    }
+
+    std::optional<StagingRing::Allocation> StagingRing::allocate(size_t size, size_t alignment) {
+        if (size == 0 || size > m_Capacity) return std::nullopt;
+
+        std::lock_guard lock(m_Mutex);
+
+        // nothing in flight, so there is no reason to wrap around mid-buffer.
+        if (m_Allocated == m_Retired) m_Head = 0;
+
+        size_t start = (m_Head + alignment - 1) / alignment * alignment;
+        size_t padding = start - m_Head;
+
+        // doesn't fit before the end, skip the tail and start over at the front.
+        if (start + size > m_Capacity) {
+            start = 0;
+            padding = m_Capacity - m_Head;
+        }
+
+        if (m_Allocated - m_Retired + padding + size > m_Capacity) return std::nullopt;
+
+        m_Head = start + size;
+        m_Allocated += padding + size;
+
+        return Allocation{ start, m_Mapped + start, m_Allocated };
+    }
+
+    void StagingRing::fence(uint64_t end) {
+        std::lock_guard lock(m_Mutex);
+        if (end <= m_Fenced) return;
+
+        m_Pending.push_back({ end, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+        m_Fenced = end;
+    }
+
+    void StagingRing::fence() {
+        uint64_t end;
+        {
+            std::lock_guard lock(m_Mutex);
+            end = m_Allocated;
+        }
+        fence(end);
+    }
+
+    void StagingRing::retire() {
+        std::lock_guard lock(m_Mutex);
+
+        while (!m_Pending.empty()) {
+            auto status = glClientWaitSync(m_Pending.front().sync, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+
+            glDeleteSync(m_Pending.front().sync);
+            m_Retired = m_Pending.front().end;
+            m_Pending.pop_front();
+        }
+    }
+
+    bool StagingRing::isRetired(uint64_t end) const {
+        std::lock_guard lock(m_Mutex);
+        return end <= m_Retired;
+    }
+
+    unsigned int StagingRing::getHandle() const noexcept {
+        return m_Handle;
+    }
+
+    size_t StagingRing::getCapacity() const noexcept {
+        return m_Capacity;
+    }
+
+    size_t StagingRing::getUsed() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Allocated - m_Retired;
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "kat/engine.hpp"
+
+#include <deque>
+#include <mutex>
+#include <optional>
+
+namespace kat {
+
+    // A persistently mapped upload buffer, used as a pixel unpack / copy source.
+    //
+    // Space is handed out front to back and reclaimed in the same order once the GPU passed the fence covering it, so
+    // uploads have to be issued in allocation order. Allocating only touches the mapping and may happen on any
+    // thread, fencing and retiring are GL thread only.
+    class StagingRing {
+    public:
+        struct Allocation {
+            size_t offset;
+            void* pointer;
+            uint64_t end;   // pass to fence() once the command reading this was issued
+        };
+
+        explicit StagingRing(size_t capacity);
+        ~StagingRing();
+
+        StagingRing(const StagingRing&) = delete;
+        StagingRing& operator=(const StagingRing&) = delete;
+
+        // empty when the ring is too full right now, or the request is larger than the whole ring.
+        std::optional<Allocation> allocate(size_t size, size_t alignment = 4);
+
+        // everything up to end gets reclaimed after the GL commands issued so far complete.
+        void fence(uint64_t end);
+        void fence();
+
+        // non-blocking, reclaims space behind every signalled fence.
+        void retire();
+
+        [[nodiscard]] bool isRetired(uint64_t end) const;
+
+        [[nodiscard]] unsigned int getHandle() const noexcept;
+        [[nodiscard]] size_t getCapacity() const noexcept;
+        [[nodiscard]] size_t getUsed() const;
+
+    private:
+        struct Pending {
+            uint64_t end;
+            GLsync sync;
+        };
+
+        unsigned int m_Handle = 0;
+        std::byte* m_Mapped = nullptr;
+        size_t m_Capacity;
+
+        // offsets into the ring, and monotonic byte counts (padding included) for tracking what is in use.
+        size_t m_Head = 0;
+        uint64_t m_Allocated = 0;
+        uint64_t m_Fenced = 0;
+        uint64_t m_Retired = 0;
+
+        std::deque<Pending> m_Pending;
+        mutable std::mutex m_Mutex;
+    };
+}
@@ -0,0 +1,158 @@
+#include "static_batch.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace kat {
+    constexpr size_t STANDARD_VERTEX_SIZE = sizeof(StandardVertex);
+
+    StaticBatcher::StaticBatcher() : StaticBatcher(Config{}) {}
+
+    StaticBatcher::StaticBatcher(const Config &config) : m_Primitive(config.primitive),
+                                                         m_VertexCapacity(std::max<size_t>(config.vertexCapacity, 1)),
+                                                         m_IndexCapacity(std::max<size_t>(config.indexCapacity, 1)) {
+        m_VertexBuffer = std::make_shared<VertexBuffer>(m_VertexCapacity * STANDARD_VERTEX_SIZE, nullptr, BufferUsage::StaticDraw);
+        m_IndexBuffer = std::make_shared<IndexBuffer>(m_IndexCapacity * sizeof(unsigned int), nullptr, BufferUsage::StaticDraw);
+        m_IndirectBuffer = std::make_unique<IndirectBuffer>();
+
+        m_VertexArray = std::make_shared<VertexArray>();
+        m_VertexArray->bindVertexBuffer(m_VertexBuffer, StandardVertex::ATTRIBUTES);
+        m_VertexArray->bindElementBuffer(m_IndexBuffer);
+    }
+
+    StaticBatcher::Handle StaticBatcher::add(const std::vector<StandardVertex> &vertices, const std::vector<unsigned int> &indices,
+                                             MaterialId material) {
+        reserve(m_VertexCount + vertices.size(), m_IndexCount + indices.size());
+
+        m_VertexBuffer->subData(vertices.size() * STANDARD_VERTEX_SIZE, vertices.data(), m_VertexCount * STANDARD_VERTEX_SIZE);
+        m_IndexBuffer->subData(indices.size() * sizeof(unsigned int), indices.data(), m_IndexCount * sizeof(unsigned int));
+
+        m_Records.push_back(Record{
+                static_cast<uint32_t>(m_IndexCount),
+                static_cast<uint32_t>(indices.size()),
+                static_cast<int32_t>(m_VertexCount),
+                static_cast<uint32_t>(vertices.size()),
+                material
+        });
+
+        m_VertexCount += vertices.size();
+        m_IndexCount += indices.size();
+
+        return static_cast<Handle>(m_Records.size() - 1);
+    }
+
+    const StaticBatcher::Record &StaticBatcher::getRecord(Handle handle) const {
+        assert(handle < m_Records.size());
+        return m_Records[handle];
+    }
+
+    size_t StaticBatcher::getRecordCount() const noexcept {
+        return m_Records.size();
+    }
+
+    void StaticBatcher::draw(const std::vector<Handle> &visible) {
+        if (visible.empty()) return;
+
+        m_Commands.clear();
+        for (Handle h : visible) {
+            const Record& r = m_Records[h];
+            m_Commands.push_back({r.indexCount, 1, r.firstIndex, r.baseVertex, 0});
+        }
+
+        uploadCommands();
+        m_VertexArray->multiDrawElementsIndirect(m_Primitive, *m_IndirectBuffer, m_Commands.size());
+    }
+
+    void StaticBatcher::draw(const std::vector<Handle> &visible, const std::function<void(MaterialId)> &bindMaterial) {
+        if (visible.empty()) return;
+
+        m_Sorted = visible;
+        std::stable_sort(m_Sorted.begin(), m_Sorted.end(), [this](Handle a, Handle b) {
+            return m_Records[a].material < m_Records[b].material;
+        });
+
+        m_Commands.clear();
+        for (Handle h : m_Sorted) {
+            const Record& r = m_Records[h];
+            m_Commands.push_back({r.indexCount, 1, r.firstIndex, r.baseVertex, 0});
+        }
+
+        // every material's commands go up in one upload, then each material draws its own range of it.
+        uploadCommands();
+
+        size_t start = 0;
+        while (start < m_Sorted.size()) {
+            MaterialId material = m_Records[m_Sorted[start]].material;
+            size_t end = start;
+            while (end < m_Sorted.size() && m_Records[m_Sorted[end]].material == material) end++;
+
+            bindMaterial(material);
+            m_VertexArray->multiDrawElementsIndirect(m_Primitive, *m_IndirectBuffer, end - start,
+                                                     start * sizeof(DrawElementsIndirectCommand));
+            start = end;
+        }
+    }
+
+    const std::shared_ptr<VertexArray> &StaticBatcher::getVertexArray() const noexcept {
+        return m_VertexArray;
+    }
+
+    const std::shared_ptr<VertexBuffer> &StaticBatcher::getVertexBuffer() const noexcept {
+        return m_VertexBuffer;
+    }
+
+    const std::shared_ptr<IndexBuffer> &StaticBatcher::getIndexBuffer() const noexcept {
+        return m_IndexBuffer;
+    }
+
+    PrimitiveMode StaticBatcher::getPrimitive() const noexcept {
+        return m_Primitive;
+    }
+
+    size_t StaticBatcher::getVertexCount() const noexcept {
+        return m_VertexCount;
+    }
+
+    size_t StaticBatcher::getIndexCount() const noexcept {
+        return m_IndexCount;
+    }
+
+    void StaticBatcher::reserve(size_t vertexCount, size_t indexCount) {
+        // the vertex array object stays the same through growth, so meshes pointing at it don't need to know.
+        if (vertexCount > m_VertexCapacity) {
+            while (m_VertexCapacity < vertexCount) m_VertexCapacity *= 2;
+
+            auto buffer = std::make_shared<VertexBuffer>(m_VertexCapacity * STANDARD_VERTEX_SIZE, nullptr, BufferUsage::StaticDraw);
+            glCopyNamedBufferSubData(m_VertexBuffer->getHandle(), buffer->getHandle(), 0, 0,
+                                     static_cast<GLsizeiptr>(m_VertexCount * STANDARD_VERTEX_SIZE));
+
+            auto binding = m_VertexArray->findBinding(m_VertexBuffer->getHandle());
+            assert(binding);
+
+            m_VertexBuffer = buffer;
+            m_VertexArray->replaceVertexBuffer(*binding, m_VertexBuffer->getHandle(), STANDARD_VERTEX_SIZE);
+        }
+
+        if (indexCount > m_IndexCapacity) {
+            while (m_IndexCapacity < indexCount) m_IndexCapacity *= 2;
+
+            auto buffer = std::make_shared<IndexBuffer>(m_IndexCapacity * sizeof(unsigned int), nullptr, BufferUsage::StaticDraw);
+            glCopyNamedBufferSubData(m_IndexBuffer->getHandle(), buffer->getHandle(), 0, 0,
+                                     static_cast<GLsizeiptr>(m_IndexCount * sizeof(unsigned int)));
+            m_IndexBuffer = buffer;
+            m_VertexArray->bindElementBuffer(m_IndexBuffer);
+        }
+    }
+
+    void StaticBatcher::uploadCommands() {
+        size_t size = m_Commands.size() * sizeof(DrawElementsIndirectCommand);
+
+        // orphan on growth, otherwise overwrite in place.
+        if (size > m_IndirectCapacity) {
+            m_IndirectCapacity = std::max(size, m_IndirectCapacity * 2);
+            m_IndirectBuffer->data(m_IndirectCapacity, nullptr, BufferUsage::StreamDraw);
+        }
+
+        m_IndirectBuffer->subData(size, m_Commands.data());
+    }
+}
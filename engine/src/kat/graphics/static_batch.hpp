@@ -0,0 +1,90 @@
+#pragma once
+
+#include "kat/engine.hpp"
+#include "kat/graphics/mesh.hpp"
+
+#include <functional>
+
+namespace kat {
+
+    // Merges static geometry (tile chunks, props) into a few large shared buffers behind a single vertex array, so a
+    // whole visible set can go out as one glMultiDrawElementsIndirect per material instead of a VAO switch per mesh.
+    class StaticBatcher {
+    public:
+        using Handle = uint32_t;
+        using MaterialId = uint32_t;
+
+        // where a mesh lives inside the shared buffers.
+        struct Record {
+            uint32_t firstIndex;
+            uint32_t indexCount;
+            int32_t baseVertex;
+            uint32_t vertexCount;
+            MaterialId material;
+        };
+
+        struct Config {
+            size_t vertexCapacity = 1 << 16;
+            size_t indexCapacity = 1 << 18;
+            PrimitiveMode primitive = PrimitiveMode::Triangles;
+        };
+
+        inline static std::shared_ptr<StaticBatcher> create() {
+            return std::make_shared<StaticBatcher>();
+        };
+
+        inline static std::shared_ptr<StaticBatcher> create(const Config& config) {
+            return std::make_shared<StaticBatcher>(config);
+        };
+
+        StaticBatcher();
+        explicit StaticBatcher(const Config& config);
+
+        StaticBatcher(const StaticBatcher&) = delete;
+        StaticBatcher& operator=(const StaticBatcher&) = delete;
+
+        // indices are relative to the given vertices, they're offset by the record's baseVertex when drawn.
+        Handle add(const std::vector<StandardVertex>& vertices, const std::vector<unsigned int>& indices, MaterialId material = 0);
+
+        [[nodiscard]] const Record& getRecord(Handle handle) const;
+        [[nodiscard]] size_t getRecordCount() const noexcept;
+
+        // one multi draw for every handle in visible, the caller binds the material.
+        void draw(const std::vector<Handle>& visible);
+
+        // groups visible by material, and issues one multi draw per material after calling bindMaterial for it.
+        void draw(const std::vector<Handle>& visible, const std::function<void(MaterialId)>& bindMaterial);
+
+        [[nodiscard]] const std::shared_ptr<VertexArray>& getVertexArray() const noexcept;
+        [[nodiscard]] const std::shared_ptr<VertexBuffer>& getVertexBuffer() const noexcept;
+        [[nodiscard]] const std::shared_ptr<IndexBuffer>& getIndexBuffer() const noexcept;
+        [[nodiscard]] PrimitiveMode getPrimitive() const noexcept;
+
+        [[nodiscard]] size_t getVertexCount() const noexcept;
+        [[nodiscard]] size_t getIndexCount() const noexcept;
+
+    private:
+        void reserve(size_t vertexCount, size_t indexCount);
+        void uploadCommands();
+
+        PrimitiveMode m_Primitive;
+
+        std::shared_ptr<VertexArray> m_VertexArray;
+        std::shared_ptr<VertexBuffer> m_VertexBuffer;
+        std::shared_ptr<IndexBuffer> m_IndexBuffer;
+        std::unique_ptr<IndirectBuffer> m_IndirectBuffer;
+
+        size_t m_VertexCapacity;
+        size_t m_IndexCapacity;
+        size_t m_IndirectCapacity = 0;
+
+        size_t m_VertexCount = 0;
+        size_t m_IndexCount = 0;
+
+        std::vector<Record> m_Records;
+
+        // rebuilt each frame from the visible list.
+        std::vector<DrawElementsIndirectCommand> m_Commands;
+        std::vector<Handle> m_Sorted;
+    };
+}
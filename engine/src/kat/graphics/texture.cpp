@@ -2,11 +2,20 @@
 #include <stb_image.h>
 
 #include "texture.hpp"
+#include "kat/graphics/barriers.hpp"
+#include "kat/graphics/render_stats.hpp"
+#include "kat/graphics/texture_loader.hpp"
+#include "kat/io/file.hpp"
+#include "kat/util/profiler.hpp"
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include <bit>
+
 namespace kat {
     void ITexture::bindUnit(uint32_t unit) {
+        gbl::barriers.require(ResourceKind::Texture, m_Handle, BarrierUsage::TextureFetch);
+        gbl::renderStats.textureBind();
         glActiveTexture(GL_TEXTURE0 + unit);
         bind();
     }
@@ -23,6 +32,7 @@ namespace kat {
 #pragma clang diagnostic pop
 
     ITexture::~ITexture() {
+        gbl::barriers.forget(ResourceKind::Texture, m_Handle);
         glDeleteTextures(1, &m_Handle);
     }
 
@@ -84,6 +94,8 @@ namespace kat {
                 return GL_R8;
             case TextureFormat::R32F:
                 return GL_R32F;
+            case TextureFormat::R8UI:
+                return GL_R8UI;
             case TextureFormat::Depth16:
                 return GL_DEPTH_COMPONENT16;
             case TextureFormat::Depth24:
@@ -113,6 +125,8 @@ namespace kat {
             case TextureFormat::R8:
             case TextureFormat::R32F:
                 return GL_RED;
+            case TextureFormat::R8UI:
+                return GL_RED_INTEGER;
             case TextureFormat::Depth16:
             case TextureFormat::Depth24:
             case TextureFormat::Depth32:
@@ -139,7 +153,65 @@ namespace kat {
         return TextureFormat::RGBA8;
     }
 
-    Texture2D::Texture2D(const glm::uvec2 &size, TextureFormat format) : m_Size(size), ITexture(GL_TEXTURE_2D) {
+    size_t bytesPerPixel(TextureFormat format) {
+        switch (format) {
+            case TextureFormat::RGBA8:
+                return 4;
+            case TextureFormat::RGBA4:
+                return 2;
+            case TextureFormat::RGBA32F:
+                return 16;
+            case TextureFormat::RGB8:
+                return 3;
+            case TextureFormat::RGB4:
+                return 2;
+            case TextureFormat::RGB32F:
+                return 12;
+            case TextureFormat::RG8:
+                return 2;
+            case TextureFormat::RG32F:
+                return 8;
+            case TextureFormat::R8:
+            case TextureFormat::R8UI:
+                return 1;
+            case TextureFormat::R32F:
+                return 4;
+            case TextureFormat::Depth16:
+                return 2;
+            case TextureFormat::Depth24:
+            case TextureFormat::Depth32:
+            case TextureFormat::Depth32F:
+                return 4;
+            case TextureFormat::Stencil:
+                return 1;
+        }
+
+        return 4;
+    }
+
+    std::optional<PixelDataType> pixelDataTypeOf(TextureFormat format) {
+        switch (format) {
+            case TextureFormat::RGBA8:
+            case TextureFormat::RGB8:
+            case TextureFormat::RG8:
+            case TextureFormat::R8:
+            case TextureFormat::R8UI:
+                return PixelDataType::UnsignedByte;
+            case TextureFormat::RGBA32F:
+            case TextureFormat::RGB32F:
+            case TextureFormat::RG32F:
+            case TextureFormat::R32F:
+                return PixelDataType::Float;
+            default:
+                return std::nullopt;
+        }
+    }
+
+    uint32_t fullMipLevels(const glm::uvec2 &size) {
+        return std::bit_width(std::max(std::max(size.x, size.y), 1u));
+    }
+
+    Texture2D::Texture2D(const glm::uvec2 &size, TextureFormat format) : ITexture(GL_TEXTURE_2D), m_Size(size), m_Format(format) {
         glBindTexture(GL_TEXTURE_2D, m_Handle);
         glTexImage2D(GL_TEXTURE_2D, 0, glInternalFormatOf(format),
                 static_cast<int>(size.x), static_cast<int>(size.y), 0,
@@ -149,30 +221,58 @@ namespace kat {
     }
 
     Texture2D::Texture2D(const glm::uvec2 &size, TextureFormat format, const void *data, PixelDataType dataType)
-            : m_Size(size), ITexture(GL_TEXTURE_2D) {
+            : ITexture(GL_TEXTURE_2D), m_Size(size), m_Format(format) {
         glBindTexture(GL_TEXTURE_2D, m_Handle);
         glTexImage2D(GL_TEXTURE_2D, 0, glInternalFormatOf(format),
                 static_cast<int>(size.x), static_cast<int>(size.y), 0,
                 glFormatOf(format), static_cast<unsigned int>(dataType), data);
         glBindTexture(GL_TEXTURE_2D, 0);
+        if (data) gbl::renderStats.textureUpload(static_cast<uint64_t>(size.x) * size.y * bytesPerPixel(format));
 
         setFilter(defaultFilter);
     }
 
+    void Texture2D::respecify(const glm::uvec2 &size, TextureFormat format) {
+        m_Size = size;
+        m_Format = format;
+
+        glBindTexture(GL_TEXTURE_2D, m_Handle);
+        glTexImage2D(GL_TEXTURE_2D, 0, glInternalFormatOf(format),
+                static_cast<int>(size.x), static_cast<int>(size.y), 0,
+                glFormatOf(format), GL_UNSIGNED_BYTE, nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
     void Texture2D::bind() {
         glBindTexture(GL_TEXTURE_2D, m_Handle);
     }
 
-    std::shared_ptr<Texture2D> Texture2D::load(const std::filesystem::path &path) {
-        if (!std::filesystem::exists(path)) spdlog::error("Texture {} is missing", path.string());
+    void Texture2D::subImage(const glm::uvec2 &offset, const glm::uvec2 &size, const void *data, PixelDataType dataType) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTextureSubImage2D(m_Handle, 0, static_cast<int>(offset.x), static_cast<int>(offset.y),
+                            static_cast<int>(size.x), static_cast<int>(size.y),
+                            glFormatOf(m_Format), static_cast<unsigned int>(dataType), data);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        gbl::renderStats.textureUpload(static_cast<uint64_t>(size.x) * size.y * bytesPerPixel(m_Format));
+    }
 
-        stbi_set_flip_vertically_on_load_thread(true);
+    static unsigned char* decode(const std::filesystem::path &path, int& width, int& height, int& nc, int desiredChannels) {
+        auto blob = io::read(path);
+        if (!blob) {
+            spdlog::error("Texture {} is missing", path.string());
+            return nullptr;
+        }
 
-        int width, height, nc;
+        stbi_set_flip_vertically_on_load_thread(true);
+        return stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(blob.getData()), static_cast<int>(blob.getSize()),
+                                     &width, &height, &nc, desiredChannels);
+    }
 
-        auto f = path.string();
+    std::shared_ptr<Texture2D> Texture2D::load(const std::filesystem::path &path) {
+        KAT_PROFILE_SCOPE("load texture");
+        int width = 0, height = 0, nc = 0;
 
-        unsigned char* data = stbi_load(f.c_str(), &width, &height, &nc, 0);
+        unsigned char* data = decode(path, width, height, nc, 0);
 
         auto tex = Texture2D::create(glm::uvec2(width, height), formatForChannels(nc), data, kat::PixelDataType::UnsignedByte);
 
@@ -182,15 +282,10 @@ namespace kat {
     }
 
     std::shared_ptr<Texture2D> Texture2D::load(const std::filesystem::path &path, int desiredChannels) {
-        if (!std::filesystem::exists(path)) spdlog::error("Texture {} is missing", path.string());
-
-        stbi_set_flip_vertically_on_load_thread(true);
-
-        int width, height, nc;
+        KAT_PROFILE_SCOPE("load texture");
+        int width = 0, height = 0, nc = 0;
 
-        auto f = path.string();
-
-        unsigned char* data = stbi_load(f.c_str(), &width, &height, &nc, desiredChannels);
+        unsigned char* data = decode(path, width, height, nc, desiredChannels);
 
         auto tex = Texture2D::create(glm::uvec2(width, height), formatForChannels(desiredChannels), data, kat::PixelDataType::UnsignedByte);
 
@@ -199,10 +294,26 @@ namespace kat {
         return tex;
     }
 
+    std::shared_ptr<Texture2D> Texture2D::loadAsync(const std::filesystem::path &path, int desiredChannels) {
+        return gbl::textures->load(path, desiredChannels);
+    }
+
     const glm::uvec2 &Texture2D::getSize() const noexcept {
         return m_Size;
     }
 
+    TextureFormat Texture2D::getFormat() const noexcept {
+        return m_Format;
+    }
+
+    bool Texture2D::isReady() const noexcept {
+        return m_Ready;
+    }
+
+    bool Texture2D::hasFailed() const noexcept {
+        return m_Failed;
+    }
+
     Texture2D::Region Texture2D::getRegion(glm::uvec2 bottomLeft, glm::uvec2 topRight) {
         return Texture2D::Region(shared_from_this(), bottomLeft, topRight);
     }
@@ -214,4 +325,109 @@ namespace kat {
     std::pair<glm::vec2, glm::vec2> Texture2D::Region::getUVPair() const noexcept {
         return { glm::vec2(bottomLeft) / glm::vec2(texture->getSize()), glm::vec2(topRight) / glm::vec2(texture->getSize()) };
     }
-}
\ No newline at end of file
+
+    Texture2DArray::Texture2DArray(const glm::uvec2 &size, uint32_t layers, TextureFormat format, uint32_t levels)
+            : ITexture(GL_TEXTURE_2D_ARRAY), m_Size(size), m_Layers(layers),
+              m_Levels(levels == 0 ? fullMipLevels(size) : levels), m_Format(format) {
+        glTextureStorage3D(m_Handle, static_cast<int>(m_Levels), glInternalFormatOf(format),
+                           static_cast<int>(size.x), static_cast<int>(size.y), static_cast<int>(layers));
+        glTextureParameteri(m_Handle, GL_TEXTURE_MAX_LEVEL, static_cast<int>(m_Levels) - 1);
+
+        setFilter(m_Levels > 1 && Texture2D::defaultFilter == TextureFilter::Nearest ? TextureFilter::NearestMipmapNearest : Texture2D::defaultFilter,
+                  Texture2D::defaultFilter);
+        setWrapMode(WrapMode::ClampToEdge);
+    }
+
+    std::shared_ptr<Texture2DArray> Texture2DArray::loadTiles(const std::vector<std::filesystem::path> &tilesets, const glm::uvec2 &tileSize,
+                                                              std::vector<uint32_t> *firstLayers, bool mipmaps) {
+        struct Image {
+            std::unique_ptr<unsigned char, decltype(&stbi_image_free)> pixels{ nullptr, stbi_image_free };
+            glm::uvec2 size;
+            glm::uvec2 tiles;
+        };
+
+        if (tileSize.x == 0 || tileSize.y == 0) {
+            spdlog::error("Tiles need a size");
+            return nullptr;
+        }
+
+        // storage is immutable, so every image is decoded before the layer count is known.
+        std::vector<Image> images(tilesets.size());
+        uint32_t layers = 0;
+
+        if (firstLayers) firstLayers->clear();
+        for (size_t i = 0; i < tilesets.size(); i++) {
+            int width = 0, height = 0, nc = 0;
+            images[i].pixels.reset(decode(tilesets[i], width, height, nc, 4));
+            if (!images[i].pixels) return nullptr;
+
+            images[i].size = glm::uvec2(width, height);
+            images[i].tiles = images[i].size / tileSize;
+            if (images[i].tiles * tileSize != images[i].size) {
+                spdlog::warn("Tileset {} isn't a whole number of {}x{} tiles", tilesets[i].string(), tileSize.x, tileSize.y);
+            }
+
+            if (firstLayers) firstLayers->push_back(layers);
+            layers += images[i].tiles.x * images[i].tiles.y;
+        }
+
+        if (layers == 0) return nullptr;
+        auto array = create(tileSize, layers, TextureFormat::RGBA8, mipmaps ? 0 : 1);
+
+        // rows are bottom to top after decoding, tile rows are counted from the top.
+        uint32_t layer = 0;
+        for (const auto& image : images) {
+            for (uint32_t row = 0; row < image.tiles.y; row++) {
+                for (uint32_t column = 0; column < image.tiles.x; column++) {
+                    size_t x = column * tileSize.x;
+                    size_t y = image.size.y - (row + 1) * tileSize.y;
+                    array->subImage(layer++, { 0, 0 }, tileSize, image.pixels.get() + (y * image.size.x + x) * 4,
+                                    PixelDataType::UnsignedByte, image.size.x);
+                }
+            }
+        }
+
+        if (mipmaps) array->generateMipmaps();
+        return array;
+    }
+
+    void Texture2DArray::bind() {
+        glBindTexture(GL_TEXTURE_2D_ARRAY, m_Handle);
+    }
+
+    void Texture2DArray::setLayer(uint32_t layer, const void *data, PixelDataType dataType) {
+        subImage(layer, { 0, 0 }, m_Size, data, dataType);
+    }
+
+    void Texture2DArray::subImage(uint32_t layer, const glm::uvec2 &offset, const glm::uvec2 &size, const void *data,
+                                  PixelDataType dataType, uint32_t rowLength) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<int>(rowLength));
+        glTextureSubImage3D(m_Handle, 0, static_cast<int>(offset.x), static_cast<int>(offset.y), static_cast<int>(layer),
+                            static_cast<int>(size.x), static_cast<int>(size.y), 1,
+                            glFormatOf(m_Format), static_cast<unsigned int>(dataType), data);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        gbl::renderStats.textureUpload(static_cast<uint64_t>(size.x) * size.y * bytesPerPixel(m_Format));
+    }
+
+    void Texture2DArray::generateMipmaps() {
+        glGenerateTextureMipmap(m_Handle);
+    }
+
+    const glm::uvec2 &Texture2DArray::getSize() const noexcept {
+        return m_Size;
+    }
+
+    uint32_t Texture2DArray::getLayerCount() const noexcept {
+        return m_Layers;
+    }
+
+    uint32_t Texture2DArray::getLevelCount() const noexcept {
+        return m_Levels;
+    }
+
+    TextureFormat Texture2DArray::getFormat() const noexcept {
+        return m_Format;
+    }
+}
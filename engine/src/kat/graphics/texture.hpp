@@ -1,6 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <filesystem>
+#include <optional>
 #include "kat/engine.hpp"
 
 namespace kat {
@@ -10,6 +12,7 @@ namespace kat {
         RGB8, RGB4, RGB32F,
         RG8, RG32F,
         R8, R32F,
+        R8UI,   // unnormalized, read with a usampler. see IndexedTexture
         Depth16, Depth24, Depth32, Depth32F,
         Depth = Depth32F,
         Stencil
@@ -41,7 +44,13 @@ namespace kat {
 
     enum class TextureFilter {
         Linear = GL_LINEAR,
-        Nearest = GL_NEAREST
+        Nearest = GL_NEAREST,
+
+        // minification only, for textures with mipmaps.
+        NearestMipmapNearest = GL_NEAREST_MIPMAP_NEAREST,
+        NearestMipmapLinear = GL_NEAREST_MIPMAP_LINEAR,
+        LinearMipmapNearest = GL_LINEAR_MIPMAP_NEAREST,
+        LinearMipmapLinear = GL_LINEAR_MIPMAP_LINEAR
     };
 
     enum class WrapMode {
@@ -80,6 +89,14 @@ namespace kat {
 
     int glInternalFormatOf(TextureFormat format);
     unsigned int glFormatOf(TextureFormat format);
+    TextureFormat formatForChannels(int nc);
+    size_t bytesPerPixel(TextureFormat format);
+
+    // one component type per texel, what colour formats are read and written as. empty for packed and depth formats.
+    std::optional<PixelDataType> pixelDataTypeOf(TextureFormat format);
+    uint32_t fullMipLevels(const glm::uvec2& size);
+
+    class TextureLoader;
 
     class Texture2D : public ITexture, public std::enable_shared_from_this<Texture2D> {
     public:
@@ -114,9 +131,20 @@ namespace kat {
         static std::shared_ptr<Texture2D> load(const std::filesystem::path& path);
         static std::shared_ptr<Texture2D> load(const std::filesystem::path& path, int desiredChannels);
 
+        // returns a 1x1 placeholder right away, the image is decoded on the job system and swapped in by gbl::textures.
+        static std::shared_ptr<Texture2D> loadAsync(const std::filesystem::path& path, int desiredChannels = 0);
+
         void bind() override;
 
+        // overwrites part of level 0, data is tightly packed rows in the texture's format.
+        void subImage(const glm::uvec2& offset, const glm::uvec2& size, const void* data,
+                      PixelDataType dataType = PixelDataType::UnsignedByte);
+
         [[nodiscard]] const glm::uvec2& getSize() const noexcept;
+        [[nodiscard]] TextureFormat getFormat() const noexcept;
+        [[nodiscard]] bool isReady() const noexcept;
+        // only async loads fail, they then stay on the placeholder and never become ready.
+        [[nodiscard]] bool hasFailed() const noexcept;
 
         [[nodiscard]] Region getRegion(glm::uvec2 bottomLeft, glm::uvec2 topRight);
         [[nodiscard]] Region getFullRegion();
@@ -126,6 +154,55 @@ namespace kat {
         Texture2D(const glm::uvec2& size, TextureFormat format);
         Texture2D(const glm::uvec2& size, TextureFormat format, const void* data, PixelDataType dataType);
 
+        // reallocates level 0 without data, the contents are uploaded separately.
+        void respecify(const glm::uvec2& size, TextureFormat format);
+
+        glm::uvec2 m_Size;
+        TextureFormat m_Format;
+        std::atomic<bool> m_Ready = true;
+        std::atomic<bool> m_Failed = false;
+
+        friend class TextureLoader;
+    };
+
+    // Equally sized layers behind one texture, sampled through a sampler2DArray with the layer as third coordinate.
+    // Tiles of every tileset sharing a tile size fit in one, so drawing a map doesn't rebind per tileset.
+    class Texture2DArray : public ITexture {
+    public:
+
+        // levels = 0 allocates the full mip chain.
+        inline static std::shared_ptr<Texture2DArray> create(const glm::uvec2& size, uint32_t layers, TextureFormat format, uint32_t levels = 1) {
+            return std::shared_ptr<Texture2DArray>(new Texture2DArray(size, layers, format, levels));
+        };
+
+        // one RGBA8 layer per tile, tilesets in order and tiles left to right, top to bottom like Tiled numbers them.
+        // firstLayers receives the layer of each tileset's first tile. empty if a tileset can't be loaded.
+        static std::shared_ptr<Texture2DArray> loadTiles(const std::vector<std::filesystem::path>& tilesets, const glm::uvec2& tileSize,
+                                                         std::vector<uint32_t>* firstLayers = nullptr, bool mipmaps = false);
+
+        void bind() override;
+
+        // data is a whole layer of tightly packed rows.
+        void setLayer(uint32_t layer, const void* data, PixelDataType dataType = PixelDataType::UnsignedByte);
+
+        // rowLength is the width of the image data is taken from, 0 when the rows are tightly packed.
+        void subImage(uint32_t layer, const glm::uvec2& offset, const glm::uvec2& size, const void* data,
+                      PixelDataType dataType = PixelDataType::UnsignedByte, uint32_t rowLength = 0);
+
+        // after uploads, when the texture was created with more than one level.
+        void generateMipmaps();
+
+        [[nodiscard]] const glm::uvec2& getSize() const noexcept;
+        [[nodiscard]] uint32_t getLayerCount() const noexcept;
+        [[nodiscard]] uint32_t getLevelCount() const noexcept;
+        [[nodiscard]] TextureFormat getFormat() const noexcept;
+
+    private:
+        Texture2DArray(const glm::uvec2& size, uint32_t layers, TextureFormat format, uint32_t levels);
+
         glm::uvec2 m_Size;
+        uint32_t m_Layers;
+        uint32_t m_Levels;
+        TextureFormat m_Format;
     };
-}
\ No newline at end of file
+}
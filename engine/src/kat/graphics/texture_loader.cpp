@@ -0,0 +1,215 @@
+#include "texture_loader.hpp"
+#include "kat/graphics/render_stats.hpp"
+#include "kat/io/file.hpp"
+#include "kat/util/job_system.hpp"
+#include "kat/util/profiler.hpp"
+
+#include <stb_image.h>
+
+#include <cstring>
+#include <limits>
+
+namespace kat {
+    TextureLoader::TextureLoader() : TextureLoader(Config{}) {}
+
+    TextureLoader::TextureLoader(const Config &config) : m_Config(config) {
+        m_Staging = std::make_unique<StagingRing>(config.stagingCapacity);
+    }
+
+    TextureLoader::~TextureLoader() {
+        std::unique_lock lock(m_Mutex);
+        m_DecodeDone.wait(lock, [this]() { return m_Decoding == 0; });
+
+        for (auto& d : m_Decoded) {
+            if (d.pixels) stbi_image_free(d.pixels);
+        }
+    }
+
+    std::shared_ptr<Texture2D> TextureLoader::load(const std::filesystem::path &path, int desiredChannels) {
+        constexpr uint32_t placeholder = 0;
+
+        auto texture = Texture2D::create(glm::uvec2(1, 1), TextureFormat::RGBA8, &placeholder, PixelDataType::UnsignedByte);
+        texture->m_Ready = false;
+
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Decoding++;
+            m_Stats.requested++;
+        }
+
+        std::weak_ptr<Texture2D> weak = texture;
+        gbl::jobs->submit([this, path, desiredChannels, weak]() { decode(path, desiredChannels, weak); });
+
+        return texture;
+    }
+
+    void TextureLoader::decode(const std::filesystem::path &path, int desiredChannels, const std::weak_ptr<Texture2D> &texture) {
+        KAT_PROFILE_SCOPE("decode texture");
+        auto finished = [this]() {
+            std::lock_guard lock(m_Mutex);
+            m_Decoding--;
+            m_DecodeDone.notify_all();
+        };
+
+        // nobody is waiting for it anymore.
+        if (texture.expired()) return finished();
+
+        stbi_set_flip_vertically_on_load_thread(true);
+
+        int width, height, nc;
+        auto f = path.string();
+
+        // decoded straight out of the mapping, the compressed file is never copied.
+        auto blob = io::read(path);
+        unsigned char* data = nullptr;
+        if (blob) {
+            data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(blob.getData()), static_cast<int>(blob.getSize()),
+                                         &width, &height, &nc, desiredChannels);
+        }
+
+        if (!data) {
+            spdlog::error("Texture {} failed to load: {}", f, blob ? stbi_failure_reason() : "missing");
+            // queued like a decoded image so the GL thread marks it, the texture must not be touched from here.
+            std::lock_guard lock(m_Mutex);
+            m_Stats.failed++;
+            m_Decoded.push_back(Decoded{ .texture = texture, .complete = true, .failed = true });
+            m_Decoding--;
+            m_DecodeDone.notify_all();
+            return;
+        }
+
+        int channels = desiredChannels ? desiredChannels : nc;
+        size_t bytes = static_cast<size_t>(width) * height * channels;
+
+        Decoded* decoded;
+        {
+            // allocating and queueing under one lock keeps the queue in allocation order, which the ring relies on.
+            std::lock_guard lock(m_Mutex);
+            decoded = &m_Decoded.emplace_back(Decoded{ texture, glm::uvec2(width, height), formatForChannels(channels), bytes,
+                                                       m_Staging->allocate(bytes), nullptr });
+        }
+
+        // the mapping is coherent, so the copy can happen here and the GL thread only issues the unpack.
+        if (decoded->staged) {
+            std::memcpy(decoded->staged->pointer, data, bytes);
+            stbi_image_free(data);
+        } else {
+            decoded->pixels = data;
+        }
+
+        {
+            std::lock_guard lock(m_Mutex);
+            decoded->complete = true;
+            m_Decoding--;
+            m_DecodeDone.notify_all();
+        }
+    }
+
+    void TextureLoader::pump() {
+        pump(m_Config.uploadBudget);
+    }
+
+    void TextureLoader::pump(size_t budget) {
+        m_Staging->retire();
+
+        size_t bytes = 0;
+        uint64_t issued = 0;
+
+        while (true) {
+            Decoded decoded;
+            {
+                std::lock_guard lock(m_Mutex);
+                if (m_Decoded.empty() || !m_Decoded.front().complete) break;
+                if (bytes > 0 && bytes + m_Decoded.front().bytes > budget) break;
+
+                decoded = std::move(m_Decoded.front());
+                m_Decoded.pop_front();
+            }
+
+            if (decoded.failed) {
+                if (auto texture = decoded.texture.lock()) texture->m_Failed = true;
+                continue;
+            }
+
+            if (decoded.staged) issued = decoded.staged->end;
+            bytes += decoded.bytes;
+
+            upload(decoded);
+        }
+
+        if (issued) m_Staging->fence(issued);
+
+        while (!m_Landing.empty() && m_Staging->isRetired(m_Landing.front().end)) {
+            m_Landing.front().texture->m_Ready = true;
+            m_Landing.pop_front();
+        }
+    }
+
+    void TextureLoader::upload(Decoded &decoded) {
+        KAT_PROFILE_SCOPE("upload texture");
+        auto texture = decoded.texture.lock();
+        if (!texture) {
+            // staged memory is reclaimed by the next fence either way.
+            if (decoded.pixels) stbi_image_free(decoded.pixels);
+            return;
+        }
+
+        texture->respecify(decoded.size, decoded.format);
+
+        // rows of RGB8 / R8 images are tightly packed.
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        if (decoded.staged) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_Staging->getHandle());
+            glTextureSubImage2D(texture->getHandle(), 0, 0, 0,
+                                static_cast<int>(decoded.size.x), static_cast<int>(decoded.size.y),
+                                glFormatOf(decoded.format), GL_UNSIGNED_BYTE,
+                                reinterpret_cast<const void*>(decoded.staged->offset));
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+            m_Landing.push_back({ texture, decoded.staged->end });
+        } else {
+            glTextureSubImage2D(texture->getHandle(), 0, 0, 0,
+                                static_cast<int>(decoded.size.x), static_cast<int>(decoded.size.y),
+                                glFormatOf(decoded.format), GL_UNSIGNED_BYTE, decoded.pixels);
+            stbi_image_free(decoded.pixels);
+
+            texture->m_Ready = true;
+            m_Stats.directUploads++;
+        }
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        gbl::renderStats.textureUpload(decoded.bytes);
+
+        m_Stats.uploaded++;
+        m_Stats.bytesUploaded += decoded.bytes;
+    }
+
+    void TextureLoader::finish() {
+        {
+            std::unique_lock lock(m_Mutex);
+            m_DecodeDone.wait(lock, [this]() { return m_Decoding == 0; });
+        }
+
+        pump(std::numeric_limits<size_t>::max());
+        glFinish();
+        pump(std::numeric_limits<size_t>::max());
+    }
+
+    size_t TextureLoader::getPendingCount() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Decoding + m_Decoded.size() + m_Landing.size();
+    }
+
+    const TextureLoader::Stats &TextureLoader::getStats() const noexcept {
+        return m_Stats;
+    }
+
+    void TextureLoader::init() {
+        gbl::textures = std::make_unique<TextureLoader>();
+    }
+
+    void TextureLoader::cleanup() {
+        gbl::textures.reset();
+    }
+}
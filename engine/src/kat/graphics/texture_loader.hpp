@@ -0,0 +1,91 @@
+#pragma once
+
+#include "kat/engine.hpp"
+#include "kat/graphics/texture.hpp"
+#include "kat/graphics/staging.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace kat {
+
+    // Loads textures without blocking the frame.
+    //
+    // load() hands out a placeholder texture right away and decodes on the job system, writing the pixels straight
+    // into the staging ring. pump() runs on the GL thread after every present: it issues the pixel unpacks within a
+    // byte budget and flips the texture to ready once the fence behind its upload signalled. Textures which couldn't be
+    // read or decoded keep the placeholder and report hasFailed() instead.
+    class TextureLoader {
+    public:
+        struct Config {
+            size_t stagingCapacity = 32 * 1024 * 1024;
+            size_t uploadBudget = 8 * 1024 * 1024;     // bytes per pump, at least one texture always goes through
+        };
+
+        struct Stats {
+            size_t requested = 0;
+            size_t uploaded = 0;
+            size_t failed = 0;
+            size_t bytesUploaded = 0;
+            size_t directUploads = 0;    // did not fit the staging ring and went through client memory
+        };
+
+        TextureLoader();
+        explicit TextureLoader(const Config& config);
+        ~TextureLoader();
+
+        // GL thread
+        std::shared_ptr<Texture2D> load(const std::filesystem::path& path, int desiredChannels = 0);
+
+        // GL thread
+        void pump();
+
+        // blocks until every requested texture is ready, pumping without a budget. GL thread.
+        void finish();
+
+        [[nodiscard]] size_t getPendingCount() const;
+        [[nodiscard]] const Stats& getStats() const noexcept;
+
+        static void init();
+        static void cleanup();
+
+    private:
+        struct Decoded {
+            std::weak_ptr<Texture2D> texture;
+            glm::uvec2 size{};
+            TextureFormat format = TextureFormat::RGBA8;
+            size_t bytes = 0;
+
+            std::optional<StagingRing::Allocation> staged{};
+            unsigned char* pixels = nullptr;    // only kept when staging failed
+            bool complete = false;              // queued before the copy into the ring finished
+            bool failed = false;                // nothing to upload, the texture is marked failed instead
+        };
+
+        struct Landing {
+            std::shared_ptr<Texture2D> texture;
+            uint64_t end;
+        };
+
+        void decode(const std::filesystem::path& path, int desiredChannels, const std::weak_ptr<Texture2D>& texture);
+        void upload(Decoded& decoded);
+        void pump(size_t budget);
+
+        Config m_Config;
+        std::unique_ptr<StagingRing> m_Staging;
+
+        mutable std::mutex m_Mutex;
+        std::condition_variable m_DecodeDone;
+        std::deque<Decoded> m_Decoded;
+        size_t m_Decoding = 0;
+
+        std::deque<Landing> m_Landing;
+        Stats m_Stats;
+    };
+
+    namespace gbl {
+        // created once a GL context exists, see gbl::setup
+        inline std::unique_ptr<TextureLoader> textures;
+    }
+}
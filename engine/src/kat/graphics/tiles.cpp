@@ -0,0 +1,44 @@
+#include "tiles.hpp"
+
+namespace kat {
+
+    void TileMeshBuilder::addTile(const glm::vec2 &bottomLeft, const glm::vec2 &topRight, uint32_t layer,
+                                  const glm::vec4 &tint, float z) {
+        auto first = static_cast<unsigned int>(m_Vertices.size());
+        auto l = static_cast<float>(layer);
+
+        m_Vertices.push_back({ { bottomLeft.x, bottomLeft.y, z }, { 0.0f, 0.0f }, l, tint });
+        m_Vertices.push_back({ { topRight.x, bottomLeft.y, z }, { 1.0f, 0.0f }, l, tint });
+        m_Vertices.push_back({ { topRight.x, topRight.y, z }, { 1.0f, 1.0f }, l, tint });
+        m_Vertices.push_back({ { bottomLeft.x, topRight.y, z }, { 0.0f, 1.0f }, l, tint });
+
+        m_Indices.insert(m_Indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+    }
+
+    std::unique_ptr<Mesh> TileMeshBuilder::build() const {
+        return std::make_unique<Mesh>(m_Vertices, m_Indices, PrimitiveMode::Triangles);
+    }
+
+    size_t TileMeshBuilder::getTileCount() const noexcept {
+        return m_Vertices.size() / 4;
+    }
+
+    void TileMeshBuilder::clear() {
+        m_Vertices.clear();
+        m_Indices.clear();
+    }
+
+    GraphicsShader &TileMeshBuilder::getShader() {
+        return *s_Shader;
+    }
+
+    void TileMeshBuilder::init() {
+        s_Shader = GraphicsShader::createUnique(
+                { std::pair{ ShaderType::Vertex, embed::shaders::tiles::vertexSrc },
+                  std::pair{ ShaderType::Fragment, embed::shaders::tiles::fragmentSrc }});
+    }
+
+    void TileMeshBuilder::cleanup() {
+        s_Shader = nullptr;
+    }
+}
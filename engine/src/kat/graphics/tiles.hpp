@@ -0,0 +1,64 @@
+#pragma once
+
+#include "kat/engine.hpp"
+#include "kat/graphics/mesh.hpp"
+#include "kat/graphics/shader.hpp"
+
+namespace kat {
+
+    namespace embed::shaders::tiles {
+        const std::string vertexSrc = "#version 430 core\n"
+                                      "layout(location=0) in vec3 vPosition;\n"
+                                      "layout(location=1) in vec2 vTexCoord;\n"
+                                      "layout(location=2) in float vLayer;\n"
+                                      "layout(location=3) in vec4 vTint;\n"
+                                      "out vec2 fUV;\n"
+                                      "flat out float fLayer;\n"
+                                      "out vec4 fTint;\n"
+                                      "uniform mat4 uTransform;\n"
+                                      "uniform float uLayer;\n"
+                                      "void main() {\n"
+                                      "    gl_Position = uTransform * vec4(vPosition, 1.0);\n"
+                                      "    fUV = vTexCoord;\n"
+                                      "    fLayer = vLayer + uLayer;\n"
+                                      "    fTint = vTint;\n"
+                                      "}";
+
+        const std::string fragmentSrc = "#version 430 core\n"
+                                        "in vec2 fUV;\n"
+                                        "flat in float fLayer;\n"
+                                        "in vec4 fTint;\n"
+                                        "out vec4 colorOut;\n"
+                                        "uniform sampler2DArray uTexture;\n"
+                                        "void main() {\n"
+                                        "    colorOut = texture(uTexture, vec3(fUV, fLayer)) * fTint;\n"
+                                        "}";
+    }
+
+    // Collects tile quads into one TileVertex mesh. With the tiles of every tileset in one Texture2DArray, a whole
+    // map chunk is a single draw with a single texture bound, whichever tilesets it mixes.
+    class TileMeshBuilder {
+    public:
+
+        // uv spans the whole layer, which is one tile as laid out by Texture2DArray::loadTiles.
+        void addTile(const glm::vec2& bottomLeft, const glm::vec2& topRight, uint32_t layer,
+                     const glm::vec4& tint = glm::vec4(1.0f), float z = 0.0f);
+
+        [[nodiscard]] std::unique_ptr<Mesh> build() const;
+        [[nodiscard]] size_t getTileCount() const noexcept;
+        void clear();
+
+        // draws TileVertex meshes with the array bound to uTexture. uLayer is added to every vertex's layer, so one quad
+        // built on layer 0 draws any layer. leave it at 0 for built chunks.
+        [[nodiscard]] static GraphicsShader& getShader();
+
+        static void init();
+        static void cleanup();
+
+    private:
+        std::vector<TileVertex> m_Vertices;
+        std::vector<unsigned int> m_Indices;
+
+        static inline std::unique_ptr<GraphicsShader> s_Shader;
+    };
+}
@@ -0,0 +1,138 @@
+#include "headless.hpp"
+
+#ifdef KAT_HEADLESS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstring>
+#endif
+
+namespace kat::headless {
+#ifdef KAT_HEADLESS
+    namespace {
+        #ifndef EGL_PLATFORM_SURFACELESS_MESA
+        #define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+        #endif
+
+        bool hasExtension(const char* extensions, const char* name) {
+            if (!extensions) return false;
+
+            size_t length = std::strlen(name);
+            for (const char* p = std::strstr(extensions, name); p; p = std::strstr(p + length, name)) {
+                if ((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0')) return true;
+            }
+            return false;
+        }
+
+        EGLDisplay openDisplay() {
+            const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+            if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+                auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+                if (getPlatformDisplay) {
+                    EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+                    if (display != EGL_NO_DISPLAY) return display;
+                }
+            }
+
+            return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+
+        GLADapiproc loadProc(const char* name) {
+            return reinterpret_cast<GLADapiproc>(eglGetProcAddress(name));
+        }
+    }
+
+    std::optional<Context> createContext() {
+        EGLDisplay display = openDisplay();
+        EGLint major = 0, minor = 0;
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+            spdlog::error("Failed to initialize an EGL display (error 0x{:x})", eglGetError());
+            return std::nullopt;
+        }
+
+        if (!hasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")) {
+            spdlog::error("EGL {}.{} has no surfaceless contexts", major, minor);
+            eglTerminate(display);
+            return std::nullopt;
+        }
+
+        eglBindAPI(EGL_OPENGL_API);
+
+        const EGLint configAttributes[] = {
+                EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                EGL_SURFACE_TYPE, 0,
+                EGL_NONE
+        };
+
+        EGLConfig config = nullptr;
+        EGLint count = 0;
+        eglChooseConfig(display, configAttributes, &config, 1, &count);
+
+        // 4.6 first, llvmpipe stops at 4.5 and everything the engine calls is in 4.5.
+        EGLContext context = EGL_NO_CONTEXT;
+        for (EGLint version : { 6, 5 }) {
+            const EGLint contextAttributes[] = {
+                    EGL_CONTEXT_MAJOR_VERSION, 4,
+                    EGL_CONTEXT_MINOR_VERSION, version,
+                    EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                    EGL_NONE
+            };
+
+            context = eglCreateContext(display, count > 0 ? config : nullptr, EGL_NO_CONTEXT, contextAttributes);
+            if (context != EGL_NO_CONTEXT) break;
+        }
+
+        if (context == EGL_NO_CONTEXT) {
+            spdlog::error("Failed to create a GL 4.5+ core context through EGL (error 0x{:x})", eglGetError());
+            eglTerminate(display);
+            return std::nullopt;
+        }
+
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context);
+        if (!gladLoadGL(loadProc)) {
+            spdlog::error("Failed to load GL functions through EGL");
+            eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            eglDestroyContext(display, context);
+            eglTerminate(display);
+            return std::nullopt;
+        }
+
+        spdlog::info("Headless GL context: {} on {}", reinterpret_cast<const char*>(glGetString(GL_VERSION)),
+                     reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+        return Context{ display, context };
+    }
+
+    void destroyContext(const Context &context) {
+        eglMakeCurrent(context.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(context.display, context.context);
+        eglTerminate(context.display);
+    }
+
+    void makeCurrent(const Context &context) {
+        eglMakeCurrent(context.display, EGL_NO_SURFACE, EGL_NO_SURFACE, context.context);
+    }
+
+    void release() {
+        EGLDisplay display = eglGetCurrentDisplay();
+        if (display != EGL_NO_DISPLAY) eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+
+    bool isAvailable() noexcept {
+        return true;
+    }
+#else
+    std::optional<Context> createContext() {
+        spdlog::error("Headless rendering needs a build with KAT_HEADLESS");
+        return std::nullopt;
+    }
+
+    void destroyContext(const Context &) {}
+    void makeCurrent(const Context &) {}
+    void release() {}
+
+    bool isAvailable() noexcept {
+        return false;
+    }
+#endif
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "kat/engine.hpp"
+
+#include <optional>
+
+namespace kat::headless {
+
+    // An offscreen GL core context with no surface, through EGL (Mesa's surfaceless platform when it is there, so
+    // llvmpipe works on machines without a display or a GPU). Only available when built with KAT_HEADLESS.
+    struct Context {
+        void* display = nullptr;    // EGLDisplay
+        void* context = nullptr;    // EGLContext
+    };
+
+    // current on the calling thread with glad loaded, empty on failure.
+    std::optional<Context> createContext();
+    void destroyContext(const Context& context);
+
+    void makeCurrent(const Context& context);
+    void release();
+
+    [[nodiscard]] bool isAvailable() noexcept;
+}
@@ -0,0 +1,265 @@
+#include "batch_reader.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef KAT_IO_URING
+#include <atomic>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace kat::io {
+    namespace {
+        struct Pending {
+            int fd = -1;
+            std::vector<std::byte> data;
+            size_t done = 0;
+            bool failed = false;
+        };
+
+        // the kernel caps a single read at about 2 GB.
+        constexpr size_t MAX_READ = size_t(1) << 30;
+
+        void open(const std::filesystem::path& path, Pending& file) {
+#ifdef _WIN32
+            std::ifstream f(path, std::ios::binary | std::ios::ate);
+            if (!f) {
+                file.failed = true;
+                return;
+            }
+
+            file.data.resize(static_cast<size_t>(f.tellg()));
+            f.seekg(0);
+            f.read(reinterpret_cast<char*>(file.data.data()), static_cast<std::streamsize>(file.data.size()));
+            file.done = file.data.size();
+            file.failed = !f;
+#else
+            file.fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat st{};
+            if (file.fd < 0 || fstat(file.fd, &st) != 0) {
+                file.failed = true;
+                return;
+            }
+
+            file.data.resize(static_cast<size_t>(st.st_size));
+#endif
+        }
+
+        void readBlocking(Pending& file) {
+#ifndef _WIN32
+            while (!file.failed && file.done < file.data.size()) {
+                size_t length = std::min(file.data.size() - file.done, MAX_READ);
+                ssize_t n = pread(file.fd, file.data.data() + file.done, length, static_cast<off_t>(file.done));
+
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) file.failed = true;
+                else if (n == 0) file.data.resize(file.done); // shrank since fstat
+                else file.done += static_cast<size_t>(n);
+            }
+#endif
+        }
+    }
+
+#ifdef KAT_IO_URING
+    // just enough of an io_uring to queue plain reads, without liburing.
+    struct BatchReader::Ring {
+        int fd = -1;
+        unsigned int entries = 0;
+
+        void* sqMapping = nullptr;
+        size_t sqMappingSize = 0;
+        void* cqMapping = nullptr;
+        size_t cqMappingSize = 0;
+        io_uring_sqe* sqes = nullptr;
+        size_t sqesSize = 0;
+
+        unsigned* sqTail = nullptr;
+        unsigned* sqMask = nullptr;
+        unsigned* sqArray = nullptr;
+
+        unsigned* cqHead = nullptr;
+        unsigned* cqTail = nullptr;
+        unsigned* cqMask = nullptr;
+        io_uring_cqe* cqes = nullptr;
+
+        static std::unique_ptr<Ring> create(unsigned int queueDepth) {
+            io_uring_params params{};
+            int fd = static_cast<int>(syscall(__NR_io_uring_setup, queueDepth, &params));
+            if (fd < 0) return nullptr;
+
+            auto ring = std::make_unique<Ring>();
+            ring->fd = fd;
+            ring->entries = params.sq_entries;
+
+            ring->sqMappingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            ring->cqMappingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+            bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (single) ring->sqMappingSize = ring->cqMappingSize = std::max(ring->sqMappingSize, ring->cqMappingSize);
+
+            ring->sqMapping = mmap(nullptr, ring->sqMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            if (ring->sqMapping == MAP_FAILED) return nullptr;
+
+            ring->cqMapping = single ? ring->sqMapping
+                                     : mmap(nullptr, ring->cqMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (ring->cqMapping == MAP_FAILED) return nullptr;
+
+            ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqes = mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+            if (sqes == MAP_FAILED) return nullptr;
+            ring->sqes = static_cast<io_uring_sqe*>(sqes);
+
+            auto* sq = static_cast<char*>(ring->sqMapping);
+            ring->sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            ring->sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            ring->sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+            auto* cq = static_cast<char*>(ring->cqMapping);
+            ring->cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            ring->cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            ring->cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+            return ring;
+        }
+
+        ~Ring() {
+            if (sqes) munmap(sqes, sqesSize);
+            if (cqMapping && cqMapping != MAP_FAILED && cqMapping != sqMapping) munmap(cqMapping, cqMappingSize);
+            if (sqMapping && sqMapping != MAP_FAILED) munmap(sqMapping, sqMappingSize);
+            if (fd >= 0) ::close(fd);
+        }
+
+        void queueRead(int file, void* buffer, size_t length, size_t offset, uint64_t userData) {
+            unsigned tail = *sqTail;
+            unsigned index = tail & *sqMask;
+
+            io_uring_sqe& sqe = sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = file;
+            sqe.addr = reinterpret_cast<uint64_t>(buffer);
+            sqe.len = static_cast<uint32_t>(length);
+            sqe.off = offset;
+            sqe.user_data = userData;
+
+            sqArray[index] = index;
+            std::atomic_ref(*sqTail).store(tail + 1, std::memory_order_release);
+        }
+
+        int enter(unsigned int submit, unsigned int wait) const {
+            return static_cast<int>(syscall(__NR_io_uring_enter, fd, submit, wait, IORING_ENTER_GETEVENTS, nullptr, 0));
+        }
+
+        template<typename F>
+        void reap(F&& f) {
+            unsigned head = *cqHead;
+            while (head != std::atomic_ref(*cqTail).load(std::memory_order_acquire)) {
+                const io_uring_cqe& cqe = cqes[head & *cqMask];
+                f(cqe.user_data, cqe.res);
+                head++;
+            }
+            std::atomic_ref(*cqHead).store(head, std::memory_order_release);
+        }
+    };
+#else
+    struct BatchReader::Ring {};
+#endif
+
+    BatchReader::BatchReader(unsigned int queueDepth) {
+#ifdef KAT_IO_URING
+        m_Ring = Ring::create(queueDepth);
+        if (!m_Ring) spdlog::warn("io_uring is unavailable, batched reads fall back to pread");
+#endif
+    }
+
+    BatchReader::~BatchReader() = default;
+
+    bool BatchReader::isUsingUring() const noexcept {
+        return m_Ring != nullptr;
+    }
+
+    std::vector<Blob> BatchReader::read(std::span<const std::filesystem::path> paths) {
+        std::vector<Pending> files(paths.size());
+        for (size_t i = 0; i < paths.size(); i++) open(paths[i], files[i]);
+
+#ifdef KAT_IO_URING
+        if (m_Ring) {
+            std::deque<size_t> queue;
+            for (size_t i = 0; i < files.size(); i++) {
+                if (!files[i].failed && !files[i].data.empty()) queue.push_back(i);
+            }
+
+            // queued: in the submission queue but not taken by the kernel yet.
+            unsigned int queued = 0, inFlight = 0;
+            while (!queue.empty() || queued || inFlight) {
+                while (!queue.empty() && inFlight + queued < m_Ring->entries) {
+                    auto& file = files[queue.front()];
+                    m_Ring->queueRead(file.fd, file.data.data() + file.done,
+                                      std::min(file.data.size() - file.done, MAX_READ), file.done, queue.front());
+                    queue.pop_front();
+                    queued++;
+                }
+
+                int submitted = m_Ring->enter(queued, 1);
+                if (submitted < 0 && errno == EINTR) continue;
+                if (submitted < 0) {
+                    // reads already taken by the kernel may still land in our buffers, so they can't be given up on.
+                    spdlog::critical("io_uring_enter failed: {}", std::strerror(errno));
+                    std::abort();
+                }
+
+                queued -= submitted;
+                inFlight += submitted;
+
+                m_Ring->reap([&](uint64_t index, int result) {
+                    inFlight--;
+                    auto& file = files[index];
+
+                    if (result == -EINTR || result == -EAGAIN) queue.push_back(index);
+                    else if (result < 0) file.failed = true;
+                    else if (result == 0) file.data.resize(file.done);
+                    else {
+                        file.done += static_cast<size_t>(result);
+                        if (file.done < file.data.size()) queue.push_back(index);
+                    }
+                });
+            }
+        }
+#endif
+
+        std::vector<Blob> blobs;
+        blobs.reserve(files.size());
+
+        for (size_t i = 0; i < files.size(); i++) {
+            auto& file = files[i];
+            readBlocking(file);
+
+#ifndef _WIN32
+            if (file.fd >= 0) ::close(file.fd);
+#endif
+            if (file.failed) {
+                spdlog::error("Failed to read {}", paths[i].string());
+                blobs.emplace_back();
+            } else {
+                blobs.emplace_back(std::move(file.data));
+            }
+        }
+
+        return blobs;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "kat/io/file.hpp"
+
+#include <memory>
+
+namespace kat::io {
+
+    // Reads many whole files in one go.
+    //
+    // Built with KAT_IO_URING on linux, every read is queued on an io_uring so the kernel works through them
+    // together and the thread sleeps once per batch instead of once per file. Without it, or when the kernel refuses
+    // to set up a ring, each file is read with a pread loop.
+    class BatchReader {
+    public:
+        explicit BatchReader(unsigned int queueDepth = 64);
+        ~BatchReader();
+
+        BatchReader(const BatchReader&) = delete;
+        BatchReader& operator=(const BatchReader&) = delete;
+
+        // in the order given, a blob is empty when its file couldn't be read.
+        std::vector<Blob> read(std::span<const std::filesystem::path> paths);
+
+        [[nodiscard]] bool isUsingUring() const noexcept;
+
+    private:
+        struct Ring;
+
+        std::unique_ptr<Ring> m_Ring;
+    };
+}
@@ -0,0 +1,175 @@
+#include "file.hpp"
+#include "kat/io/kpak.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace kat::io {
+#ifndef _WIN32
+    static int adviceOf(AccessHint hint) {
+        switch (hint) {
+            case AccessHint::Normal:
+                return MADV_NORMAL;
+            case AccessHint::Sequential:
+                return MADV_SEQUENTIAL;
+            case AccessHint::Random:
+                return MADV_RANDOM;
+            case AccessHint::WillNeed:
+                return MADV_WILLNEED;
+            case AccessHint::DontNeed:
+                return MADV_DONTNEED;
+        }
+        return MADV_NORMAL;
+    }
+#endif
+
+    std::shared_ptr<MappedFile> MappedFile::open(const std::filesystem::path &path, AccessHint hint) {
+        auto file = std::shared_ptr<MappedFile>(new MappedFile());
+
+#ifdef _WIN32
+        HANDLE handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) return nullptr;
+
+        LARGE_INTEGER size;
+        GetFileSizeEx(handle, &size);
+        file->m_Size = static_cast<size_t>(size.QuadPart);
+
+        // empty files can't be mapped, they are just an empty span.
+        if (file->m_Size) {
+            HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) {
+                file->m_Mapping = mapping;
+                file->m_Data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            }
+        }
+        CloseHandle(handle);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return nullptr;
+
+        struct stat st{};
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return nullptr;
+        }
+        file->m_Size = static_cast<size_t>(st.st_size);
+
+        if (file->m_Size) {
+            void* data = mmap(nullptr, file->m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) file->m_Data = static_cast<const std::byte*>(data);
+        }
+        ::close(fd);
+#endif
+
+        if (file->m_Size && !file->m_Data) {
+            spdlog::error("Failed to map {}", path.string());
+            return nullptr;
+        }
+
+        file->advise(hint);
+        return file;
+    }
+
+    MappedFile::~MappedFile() {
+        if (!m_Data) return;
+#ifdef _WIN32
+        UnmapViewOfFile(m_Data);
+        CloseHandle(m_Mapping);
+#else
+        munmap(const_cast<std::byte*>(m_Data), m_Size);
+#endif
+    }
+
+    void MappedFile::advise(AccessHint hint, size_t offset, size_t length) const {
+#ifndef _WIN32
+        if (!m_Data || offset >= m_Size) return;
+
+        // madvise wants a page aligned start.
+        static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t start = offset / page * page;
+        size_t end = length ? std::min(offset + length, m_Size) : m_Size;
+
+        madvise(const_cast<std::byte*>(m_Data) + start, end - start, adviceOf(hint));
+#endif
+    }
+
+    std::span<const std::byte> MappedFile::getBytes() const noexcept {
+        return { m_Data, m_Size };
+    }
+
+    std::string_view MappedFile::getString() const noexcept {
+        return { reinterpret_cast<const char*>(m_Data), m_Size };
+    }
+
+    const std::byte *MappedFile::getData() const noexcept {
+        return m_Data;
+    }
+
+    size_t MappedFile::getSize() const noexcept {
+        return m_Size;
+    }
+
+    Blob::Blob(std::shared_ptr<const void> owner, std::span<const std::byte> bytes)
+            : m_Owner(std::move(owner)), m_Bytes(bytes) {}
+
+    Blob::Blob(std::vector<std::byte> bytes) {
+        auto owned = std::make_shared<std::vector<std::byte>>(std::move(bytes));
+        m_Bytes = *owned;
+        m_Owner = std::move(owned);
+    }
+
+    Blob::operator bool() const noexcept {
+        return m_Owner != nullptr;
+    }
+
+    std::span<const std::byte> Blob::getBytes() const noexcept {
+        return m_Bytes;
+    }
+
+    std::string_view Blob::getString() const noexcept {
+        return { reinterpret_cast<const char*>(m_Bytes.data()), m_Bytes.size() };
+    }
+
+    const std::byte *Blob::getData() const noexcept {
+        return m_Bytes.data();
+    }
+
+    size_t Blob::getSize() const noexcept {
+        return m_Bytes.size();
+    }
+
+    Blob read(const std::filesystem::path &path, AccessHint hint) {
+        if (!gbl::paks.empty()) {
+            auto name = path.generic_string();
+            for (const auto& pak : gbl::paks) {
+                const auto* entry = pak->find(name);
+                if (!entry) continue;
+
+                if (auto view = pak->view(*entry)) return { pak, *view };
+
+                std::vector<std::byte> data(entry->size);
+                if (pak->read(*entry, data)) return Blob(std::move(data));
+
+                spdlog::error("Archive entry {} is corrupt", name);
+            }
+        }
+
+        auto file = MappedFile::open(path, hint);
+        if (!file) return {};
+
+        auto bytes = file->getBytes();
+        return { std::move(file), bytes };
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace kat::io {
+
+    enum class AccessHint {
+        Normal,
+        Sequential,     // read front to back once, read ahead aggressively
+        Random,         // index lookups, don't bother reading ahead
+        WillNeed,       // start paging it in now
+        DontNeed        // done with it for now
+    };
+
+    // A read only, private mapping of a whole file.
+    class MappedFile {
+    public:
+        static std::shared_ptr<MappedFile> open(const std::filesystem::path& path, AccessHint hint = AccessHint::Sequential);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // a hint for the whole file, or for [offset, offset + length) when length isn't 0. a no-op where unsupported.
+        void advise(AccessHint hint, size_t offset = 0, size_t length = 0) const;
+
+        [[nodiscard]] std::span<const std::byte> getBytes() const noexcept;
+        [[nodiscard]] std::string_view getString() const noexcept;
+        [[nodiscard]] const std::byte* getData() const noexcept;
+        [[nodiscard]] size_t getSize() const noexcept;
+
+    private:
+        MappedFile() = default;
+
+        const std::byte* m_Data = nullptr;
+        size_t m_Size = 0;
+        void* m_Mapping = nullptr;  // windows only
+    };
+
+    // Bytes from wherever they came from: a mapped file, a raw archive entry or a decompressed one. Keeps its source
+    // alive, so the span stays valid for as long as the blob does.
+    class Blob {
+    public:
+        Blob() = default;
+        Blob(std::shared_ptr<const void> owner, std::span<const std::byte> bytes);
+        explicit Blob(std::vector<std::byte> bytes);
+
+        explicit operator bool() const noexcept;
+
+        [[nodiscard]] std::span<const std::byte> getBytes() const noexcept;
+        [[nodiscard]] std::string_view getString() const noexcept;
+        [[nodiscard]] const std::byte* getData() const noexcept;
+        [[nodiscard]] size_t getSize() const noexcept;
+
+    private:
+        std::shared_ptr<const void> m_Owner;
+        std::span<const std::byte> m_Bytes;
+    };
+
+    // looks in the mounted archives first, maps the file from disk otherwise. empty when neither has it.
+    Blob read(const std::filesystem::path& path, AccessHint hint = AccessHint::Sequential);
+}
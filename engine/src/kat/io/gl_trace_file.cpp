@@ -0,0 +1,172 @@
+#include "gl_trace_file.hpp"
+#include "kat/io/file.hpp"
+
+#include <cstring>
+
+namespace kat {
+    namespace {
+        constexpr size_t BUFFER_SIZE = 1 << 20;
+
+        size_t padded(size_t size) {
+            return (size + 7) & ~size_t(7);
+        }
+    }
+
+    GlTraceWriter::~GlTraceWriter() {
+        close();
+    }
+
+    bool GlTraceWriter::open(const std::filesystem::path &path, const std::vector<GlTraceFunction> &functions) {
+        close();
+
+        m_File.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_File) {
+            spdlog::error("Can't write GL trace {}", path.string());
+            return false;
+        }
+
+        m_Buffer.reserve(BUFFER_SIZE);
+        m_Records = 0;
+
+        GlTraceHeader header{};
+        std::memcpy(header.magic, GL_TRACE_MAGIC, sizeof(header.magic));
+        header.version = GL_TRACE_VERSION;
+        header.functionCount = static_cast<uint32_t>(functions.size());
+        append(&header, sizeof(header));
+
+        size_t table = 0;
+        for (const auto& f : functions) {
+            uint8_t lengths[2] = { static_cast<uint8_t>(std::min<size_t>(f.name.size(), 255)),
+                                   static_cast<uint8_t>(std::min(f.types.size(), GL_TRACE_MAX_ARGS)) };
+            append(lengths, sizeof(lengths));
+            append(f.name.data(), lengths[0]);
+            append(f.types.data(), lengths[1]);
+            table += sizeof(lengths) + lengths[0] + lengths[1];
+        }
+
+        constexpr std::byte zeros[8]{};
+        append(zeros, padded(table) - table);
+        return true;
+    }
+
+    void GlTraceWriter::close() {
+        if (!m_File.is_open()) return;
+
+        flush();
+        m_File.close();
+    }
+
+    bool GlTraceWriter::isOpen() const noexcept {
+        return m_File.is_open();
+    }
+
+    void GlTraceWriter::write(const GlTraceRecord &record, std::span<const uint64_t> args) {
+        GlTraceRecord r = record;
+        r.argCount = static_cast<uint8_t>(std::min(args.size(), GL_TRACE_MAX_ARGS));
+
+        append(&r, sizeof(r));
+        append(args.data(), r.argCount * sizeof(uint64_t));
+        m_Records++;
+
+        if (m_Buffer.size() >= BUFFER_SIZE) flush();
+    }
+
+    void GlTraceWriter::flush() {
+        if (m_Buffer.empty() || !m_File.is_open()) return;
+
+        m_File.write(reinterpret_cast<const char*>(m_Buffer.data()), static_cast<std::streamsize>(m_Buffer.size()));
+        m_Buffer.clear();
+    }
+
+    uint64_t GlTraceWriter::getRecordCount() const noexcept {
+        return m_Records;
+    }
+
+    void GlTraceWriter::append(const void *data, size_t size) {
+        auto bytes = static_cast<const std::byte*>(data);
+        m_Buffer.insert(m_Buffer.end(), bytes, bytes + size);
+    }
+
+    std::unique_ptr<GlTraceReader> GlTraceReader::open(const std::filesystem::path &path) {
+        auto file = io::MappedFile::open(path, io::AccessHint::Sequential);
+        if (!file) {
+            spdlog::error("GL trace {} is missing", path.string());
+            return nullptr;
+        }
+
+        auto bytes = file->getBytes();
+
+        GlTraceHeader header{};
+        if (bytes.size() < sizeof(header)) {
+            spdlog::error("{} is too short to be a GL trace", path.string());
+            return nullptr;
+        }
+
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (std::memcmp(header.magic, GL_TRACE_MAGIC, sizeof(header.magic)) != 0) {
+            spdlog::error("{} is not a GL trace", path.string());
+            return nullptr;
+        }
+        if (header.version != GL_TRACE_VERSION) {
+            spdlog::error("GL trace {} is version {}, expected {}", path.string(), header.version, GL_TRACE_VERSION);
+            return nullptr;
+        }
+
+        auto reader = std::unique_ptr<GlTraceReader>(new GlTraceReader());
+        reader->m_File = file;
+
+        size_t offset = sizeof(header);
+        for (uint32_t i = 0; i < header.functionCount; i++) {
+            if (offset + 2 > bytes.size()) break;
+
+            auto nameLength = static_cast<size_t>(bytes[offset]);
+            auto argCount = static_cast<size_t>(bytes[offset + 1]);
+            offset += 2;
+
+            if (offset + nameLength + argCount > bytes.size()) break;
+
+            const char* chars = reinterpret_cast<const char*>(bytes.data() + offset);
+            reader->m_Functions.push_back({ std::string(chars, nameLength), std::string(chars + nameLength, argCount) });
+            offset += nameLength + argCount;
+        }
+
+        if (reader->m_Functions.size() != header.functionCount) {
+            spdlog::error("GL trace {} has a truncated function table", path.string());
+            return nullptr;
+        }
+
+        reader->m_Offset = sizeof(header) + padded(offset - sizeof(header));
+        return reader;
+    }
+
+    const std::vector<GlTraceFunction> &GlTraceReader::getFunctions() const noexcept {
+        return m_Functions;
+    }
+
+    std::string_view GlTraceReader::getName(uint16_t function) const noexcept {
+        if (function == GL_TRACE_FRAME) return "frame";
+        if (function >= m_Functions.size()) return "?";
+        return m_Functions[function].name;
+    }
+
+    bool GlTraceReader::next(GlTraceCall &call) {
+        auto bytes = m_File->getBytes();
+
+        GlTraceRecord record{};
+        if (m_Offset + sizeof(record) > bytes.size()) return false;
+        std::memcpy(&record, bytes.data() + m_Offset, sizeof(record));
+
+        size_t argBytes = record.argCount * sizeof(uint64_t);
+        if (record.argCount > GL_TRACE_MAX_ARGS || m_Offset + sizeof(record) + argBytes > bytes.size()) return false;
+
+        call.function = record.function;
+        call.thread = record.thread;
+        call.duration = record.duration;
+        call.time = record.time;
+        call.argCount = record.argCount;
+        std::memcpy(call.args.data(), bytes.data() + m_Offset + sizeof(record), argBytes);
+
+        m_Offset += sizeof(record) + argBytes;
+        return true;
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "kat/core.hpp"
+
+#include <array>
+#include <bit>
+#include <fstream>
+#include <span>
+#include <string_view>
+
+namespace kat {
+    namespace io { class MappedFile; }
+
+    // GL call traces, written by KAT_GL_TRACE builds and read by KatGlTrace. all little endian:
+    //
+    //   GlTraceHeader
+    //   functions            functionCount of: u8 name length, u8 argument count, the name, one type char per argument.
+    //                        padded to 8 bytes
+    //   records              GlTraceRecord followed by argCount u64s, until the end of the file
+    //
+    // Arguments are stored as their bits: integers sign or zero extended, floats and doubles bit for bit, pointers as
+    // addresses. The values behind glUniform*v / glProgramUniform*v pointers are stored as a hash of their bytes
+    // instead, so setting an unchanged vector or matrix can be told apart. A record with function GL_TRACE_FRAME marks
+    // a present.
+
+    static_assert(std::endian::native == std::endian::little, "gl traces are written in host order, which assumes little endian");
+
+    constexpr char GL_TRACE_MAGIC[4] = { 'K', 'G', 'L', 'T' };
+    constexpr uint32_t GL_TRACE_VERSION = 1;
+    constexpr uint16_t GL_TRACE_FRAME = 0xFFFF;
+    constexpr size_t GL_TRACE_MAX_ARGS = 16;
+
+    // argument types in the function table
+    enum class GlArgType : char {
+        Signed = 'i',
+        Unsigned = 'u',
+        Enum = 'e',
+        Bitfield = 'x',
+        Boolean = 'b',
+        Float = 'f',
+        Double = 'd',
+        Pointer = 'p',
+        Hash = 'h'      // of the values pointed to
+    };
+
+    struct GlTraceHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t functionCount;
+        uint32_t reserved;
+    };
+
+    struct GlTraceRecord {
+        uint16_t function;
+        uint8_t argCount;
+        uint8_t thread;         // small per-trace index of the calling thread
+        uint32_t duration;      // in nanoseconds, saturated
+        uint64_t time;          // in nanoseconds since the trace started
+    };
+
+    static_assert(sizeof(GlTraceHeader) == 16);
+    static_assert(sizeof(GlTraceRecord) == 16);
+
+    struct GlTraceFunction {
+        std::string name;
+        std::string types;      // a GlArgType per argument
+    };
+
+    struct GlTraceCall {
+        uint16_t function = 0;
+        uint8_t thread = 0;
+        uint32_t duration = 0;
+        uint64_t time = 0;
+        uint8_t argCount = 0;
+        std::array<uint64_t, GL_TRACE_MAX_ARGS> args{};
+
+        [[nodiscard]] inline bool isFrame() const noexcept { return function == GL_TRACE_FRAME; };
+    };
+
+    // Streams a trace to disk through a buffer. Not synchronised, the caller serialises records.
+    class GlTraceWriter {
+    public:
+        ~GlTraceWriter();
+
+        // false, with an error logged, when the file can't be created.
+        bool open(const std::filesystem::path& path, const std::vector<GlTraceFunction>& functions);
+        void close();
+
+        [[nodiscard]] bool isOpen() const noexcept;
+
+        void write(const GlTraceRecord& record, std::span<const uint64_t> args);
+        void flush();
+
+        [[nodiscard]] uint64_t getRecordCount() const noexcept;
+
+    private:
+        void append(const void* data, size_t size);
+
+        std::ofstream m_File;
+        std::vector<std::byte> m_Buffer;
+        uint64_t m_Records = 0;
+    };
+
+    // Reads a trace front to back, straight out of a mapping.
+    class GlTraceReader {
+    public:
+        // nullptr, with an error logged, when it isn't a trace this build understands.
+        static std::unique_ptr<GlTraceReader> open(const std::filesystem::path& path);
+
+        [[nodiscard]] const std::vector<GlTraceFunction>& getFunctions() const noexcept;
+        [[nodiscard]] std::string_view getName(uint16_t function) const noexcept;
+
+        // false at the end, or at a record cut short by a crash.
+        bool next(GlTraceCall& call);
+
+    private:
+        GlTraceReader() = default;
+
+        std::shared_ptr<io::MappedFile> m_File;
+        std::vector<GlTraceFunction> m_Functions;
+        size_t m_Offset = 0;
+    };
+}
@@ -0,0 +1,309 @@
+#include "kpak.hpp"
+#include "kat/io/file.hpp"
+#include "kat/io/lz4.hpp"
+#include "kat/util/job_system.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+
+namespace kat {
+    std::string normalizePakName(std::string_view name) {
+        std::string s(name);
+        std::replace(s.begin(), s.end(), '\\', '/');
+        while (s.starts_with("./")) s.erase(0, 2);
+        while (s.starts_with('/')) s.erase(0, 1);
+        return s;
+    }
+
+    uint64_t hashPakName(std::string_view name) {
+        // fnv-1a
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (char c : name) {
+            h ^= static_cast<uint8_t>(c);
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    std::shared_ptr<PakArchive> PakArchive::open(const std::filesystem::path &path) {
+        auto pak = std::shared_ptr<PakArchive>(new PakArchive());
+
+        // lookups jump around the index, and entries are read whole when needed.
+        pak->m_File = io::MappedFile::open(path, io::AccessHint::Random);
+        if (!pak->m_File) {
+            spdlog::error("Failed to open archive {}", path.string());
+            return nullptr;
+        }
+
+        pak->m_Data = pak->m_File->getData();
+        pak->m_Size = pak->m_File->getSize();
+
+        auto fits = [&](uint64_t offset, uint64_t size) { return offset <= pak->m_Size && size <= pak->m_Size - offset; };
+
+        if (!fits(0, sizeof(PakHeader))) {
+            spdlog::error("Archive {} is truncated", path.string());
+            return nullptr;
+        }
+
+        const auto* header = reinterpret_cast<const PakHeader*>(pak->m_Data);
+        if (std::memcmp(header->magic, PAK_MAGIC, 4) != 0 || header->version != PAK_VERSION) {
+            spdlog::error("{} is not a version {} archive", path.string(), PAK_VERSION);
+            return nullptr;
+        }
+
+        if (header->blockSize == 0 || header->blockCount > pak->m_Size / sizeof(PakBlock) ||
+            !fits(header->indexOffset, uint64_t(header->entryCount) * sizeof(PakIndexEntry)) ||
+            !fits(header->blocksOffset, header->blockCount * sizeof(PakBlock)) ||
+            !fits(header->namesOffset, header->namesSize)) {
+            spdlog::error("Archive {} is truncated", path.string());
+            return nullptr;
+        }
+
+        pak->m_Header = header;
+        pak->m_Index = { reinterpret_cast<const PakIndexEntry*>(pak->m_Data + header->indexOffset), header->entryCount };
+        pak->m_Blocks = { reinterpret_cast<const PakBlock*>(pak->m_Data + header->blocksOffset), header->blockCount };
+        pak->m_Names = reinterpret_cast<const char*>(pak->m_Data + header->namesOffset);
+
+        // checked once here so reads can trust the index: every entry's blocks exist, cover exactly its size and
+        // stay inside its stored bytes, which stay inside the file.
+        for (const auto& entry : pak->m_Index) {
+            uint64_t blocks = (entry.size + header->blockSize - 1) / header->blockSize;
+            bool valid = entry.blockCount == blocks &&
+                         uint64_t(entry.firstBlock) + entry.blockCount <= pak->m_Blocks.size() &&
+                         fits(entry.offset, entry.storedSize) &&
+                         uint64_t(entry.nameOffset) + entry.nameLength <= header->namesSize;
+
+            for (uint32_t i = 0; valid && i < entry.blockCount; i++) {
+                const auto& b = pak->m_Blocks[entry.firstBlock + i];
+                valid = b.offset <= entry.storedSize && b.storedSize <= entry.storedSize - b.offset &&
+                        (b.codec == PakCodec::Raw || b.codec == PakCodec::LZ4);
+            }
+
+            if (!valid) {
+                spdlog::error("Archive {} has a corrupt index", path.string());
+                return nullptr;
+            }
+        }
+
+        spdlog::debug("Mounted archive {} ({} entries)", path.string(), header->entryCount);
+        return pak;
+    }
+
+    const PakIndexEntry *PakArchive::find(std::string_view name) const {
+        auto normalized = normalizePakName(name);
+        uint64_t hash = hashPakName(normalized);
+
+        auto it = std::lower_bound(m_Index.begin(), m_Index.end(), hash,
+                                   [](const PakIndexEntry& e, uint64_t h) { return e.hash < h; });
+
+        for (; it != m_Index.end() && it->hash == hash; ++it) {
+            if (getName(*it) == normalized) return &*it;
+        }
+
+        return nullptr;
+    }
+
+    std::string_view PakArchive::getName(const PakIndexEntry &entry) const {
+        if (uint64_t(entry.nameOffset) + entry.nameLength > m_Header->namesSize) return {};
+        return { m_Names + entry.nameOffset, entry.nameLength };
+    }
+
+    std::span<const PakIndexEntry> PakArchive::getEntries() const noexcept {
+        return m_Index;
+    }
+
+    std::optional<std::span<const std::byte>> PakArchive::view(const PakIndexEntry &entry) const {
+        if (entry.storedSize != entry.size || entry.offset + entry.size > m_Size) return std::nullopt;
+        if (uint64_t(entry.firstBlock) + entry.blockCount > m_Blocks.size()) return std::nullopt;
+
+        for (uint32_t i = 0; i < entry.blockCount; i++) {
+            if (m_Blocks[entry.firstBlock + i].codec != PakCodec::Raw) return std::nullopt;
+        }
+
+        return std::span<const std::byte>(m_Data + entry.offset, entry.size);
+    }
+
+    bool PakArchive::decodeBlock(const PakIndexEntry &entry, uint32_t block, std::span<std::byte> out) const {
+        // the index was validated on open, this only guards against entries and blocks passed in from elsewhere.
+        uint64_t first = uint64_t(block) * m_Header->blockSize;
+        if (block >= entry.blockCount || uint64_t(entry.firstBlock) + block >= m_Blocks.size() || first >= entry.size) return false;
+        const auto& b = m_Blocks[entry.firstBlock + block];
+
+        uint64_t start = entry.offset + b.offset;
+        if (start > m_Size || b.storedSize > m_Size - start) return false;
+        const std::byte* src = m_Data + start;
+
+        size_t size = static_cast<size_t>(std::min<uint64_t>(m_Header->blockSize, entry.size - first));
+        if (first + size > out.size()) return false;
+        std::byte* dst = out.data() + first;
+
+        switch (b.codec) {
+            case PakCodec::Raw:
+                if (b.storedSize != size) return false;
+                std::memcpy(dst, src, size);
+                return true;
+            case PakCodec::LZ4:
+                return lz4::decompress(src, b.storedSize, dst, size) == size;
+        }
+
+        return false;
+    }
+
+    bool PakArchive::read(const PakIndexEntry &entry, std::span<std::byte> out) const {
+        if (out.size() < entry.size) return false;
+
+        // not worth waking the workers for.
+        if (entry.blockCount <= 1 || !gbl::jobs) {
+            for (uint32_t i = 0; i < entry.blockCount; i++) {
+                if (!decodeBlock(entry, i, out)) return false;
+            }
+            return true;
+        }
+
+        std::atomic<bool> ok = true;
+        gbl::jobs->parallelFor(entry.blockCount, [&](size_t i) {
+            if (!decodeBlock(entry, static_cast<uint32_t>(i), out)) ok = false;
+        });
+
+        return ok;
+    }
+
+    std::optional<std::vector<std::byte>> PakArchive::read(std::string_view name) const {
+        const auto* entry = find(name);
+        if (!entry) return std::nullopt;
+
+        std::vector<std::byte> data(entry->size);
+        if (!read(*entry, data)) {
+            spdlog::error("Archive entry {} is corrupt", name);
+            return std::nullopt;
+        }
+
+        return data;
+    }
+
+    PakWriter::PakWriter() : PakWriter(Config{}) {}
+
+    PakWriter::PakWriter(const Config &config) : m_Config(config) {}
+
+    void PakWriter::add(std::string_view name, std::vector<std::byte> data) {
+        m_Entries.push_back({ normalizePakName(name), std::move(data) });
+    }
+
+    void PakWriter::addFile(std::string_view name, const std::filesystem::path &path) {
+        auto file = io::MappedFile::open(path);
+        if (!file) throw std::runtime_error("Failed to read " + path.string());
+
+        add(name, { file->getBytes().begin(), file->getBytes().end() });
+    }
+
+    void PakWriter::write(const std::filesystem::path &path) {
+        struct Encoded {
+            PakCodec codec = PakCodec::Raw;
+            std::vector<std::byte> bytes;
+        };
+
+        std::sort(m_Entries.begin(), m_Entries.end(), [](const Pending& a, const Pending& b) {
+            uint64_t ha = hashPakName(a.name), hb = hashPakName(b.name);
+            return ha != hb ? ha < hb : a.name < b.name;
+        });
+
+        const size_t blockSize = m_Config.blockSize;
+
+        // every block of every entry, encoded in parallel.
+        std::vector<std::pair<size_t, size_t>> work;
+        std::vector<std::vector<Encoded>> encoded(m_Entries.size());
+        for (size_t e = 0; e < m_Entries.size(); e++) {
+            size_t count = (m_Entries[e].data.size() + blockSize - 1) / blockSize;
+            encoded[e].resize(count);
+            for (size_t b = 0; b < count; b++) work.emplace_back(e, b);
+        }
+
+        auto encode = [&](size_t i) {
+            auto [e, b] = work[i];
+            const auto& data = m_Entries[e].data;
+            size_t first = b * blockSize;
+            size_t size = std::min(blockSize, data.size() - first);
+
+            auto& out = encoded[e][b];
+            if (m_Config.codec == PakCodec::LZ4) {
+                out.bytes.resize(lz4::compressBound(size));
+                size_t compressed = lz4::compress(data.data() + first, size, out.bytes.data(), out.bytes.size());
+                if (compressed && compressed < size) {
+                    out.bytes.resize(compressed);
+                    out.codec = PakCodec::LZ4;
+                    return;
+                }
+            }
+
+            out.bytes.assign(data.begin() + static_cast<ptrdiff_t>(first), data.begin() + static_cast<ptrdiff_t>(first + size));
+            out.codec = PakCodec::Raw;
+        };
+
+        if (gbl::jobs) {
+            gbl::jobs->parallelFor(work.size(), encode);
+        } else {
+            for (size_t i = 0; i < work.size(); i++) encode(i);
+        }
+
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        if (!f) throw std::runtime_error("Failed to open " + path.string() + " for writing");
+
+        auto pad = [&](size_t alignment) {
+            auto pos = static_cast<size_t>(f.tellp());
+            size_t aligned = (pos + alignment - 1) / alignment * alignment;
+            for (; pos < aligned; pos++) f.put(0);
+        };
+
+        PakHeader header{};
+        std::memcpy(header.magic, PAK_MAGIC, 4);
+        header.version = PAK_VERSION;
+        header.entryCount = static_cast<uint32_t>(m_Entries.size());
+        header.blockSize = m_Config.blockSize;
+        f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::vector<PakIndexEntry> index;
+        std::vector<PakBlock> blocks;
+        std::string names;
+
+        for (size_t e = 0; e < m_Entries.size(); e++) {
+            pad(PAK_ALIGNMENT);
+
+            PakIndexEntry entry{};
+            entry.hash = hashPakName(m_Entries[e].name);
+            entry.offset = static_cast<uint64_t>(f.tellp());
+            entry.size = m_Entries[e].data.size();
+            entry.firstBlock = static_cast<uint32_t>(blocks.size());
+            entry.blockCount = static_cast<uint32_t>(encoded[e].size());
+            entry.nameOffset = static_cast<uint32_t>(names.size());
+            entry.nameLength = static_cast<uint32_t>(m_Entries[e].name.size());
+            names += m_Entries[e].name;
+
+            for (const auto& block : encoded[e]) {
+                blocks.push_back({ entry.storedSize, static_cast<uint32_t>(block.bytes.size()), block.codec });
+                f.write(reinterpret_cast<const char*>(block.bytes.data()), static_cast<std::streamsize>(block.bytes.size()));
+                entry.storedSize += block.bytes.size();
+            }
+
+            index.push_back(entry);
+        }
+
+        pad(alignof(PakIndexEntry));
+        header.indexOffset = static_cast<uint64_t>(f.tellp());
+        f.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(PakIndexEntry)));
+
+        header.blocksOffset = static_cast<uint64_t>(f.tellp());
+        header.blockCount = blocks.size();
+        f.write(reinterpret_cast<const char*>(blocks.data()), static_cast<std::streamsize>(blocks.size() * sizeof(PakBlock)));
+
+        header.namesOffset = static_cast<uint64_t>(f.tellp());
+        header.namesSize = names.size();
+        f.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+        f.seekp(0);
+        f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        if (!f) throw std::runtime_error("Failed to write " + path.string());
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "kat/core.hpp"
+
+#include <bit>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace kat {
+
+    // .kpak layout, all little endian:
+    //
+    //   PakHeader            at 0
+    //   entry data           each entry starts on a PAK_ALIGNMENT boundary, its blocks back to back
+    //   PakIndexEntry[]      sorted by hash, then name
+    //   PakBlock[]           indexed by PakIndexEntry::firstBlock
+    //   names                not terminated, see PakIndexEntry::nameOffset
+    //
+    // Entries are split into blocks of blockSize bytes, each compressed on its own so they can be decoded in
+    // parallel. A block that doesn't shrink is stored raw.
+
+    static_assert(std::endian::native == std::endian::little, "kpak is read in place, which assumes little endian");
+
+    constexpr char PAK_MAGIC[4] = { 'K', 'P', 'A', 'K' };
+    constexpr uint32_t PAK_VERSION = 1;
+    constexpr size_t PAK_ALIGNMENT = 4096;
+
+    enum class PakCodec : uint32_t {
+        Raw = 0,
+        LZ4 = 1
+    };
+
+    struct PakHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t blockSize;
+        uint64_t indexOffset;
+        uint64_t blocksOffset;
+        uint64_t blockCount;
+        uint64_t namesOffset;
+        uint64_t namesSize;
+        uint64_t reserved;
+    };
+
+    struct PakIndexEntry {
+        uint64_t hash;
+        uint64_t offset;        // of the first block, from the start of the archive
+        uint64_t size;          // decompressed
+        uint64_t storedSize;
+        uint32_t firstBlock;
+        uint32_t blockCount;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+    };
+
+    struct PakBlock {
+        uint64_t offset;        // from the start of the entry
+        uint32_t storedSize;
+        PakCodec codec;
+    };
+
+    static_assert(sizeof(PakHeader) == 64);
+    static_assert(sizeof(PakIndexEntry) == 48);
+    static_assert(sizeof(PakBlock) == 16);
+
+    // entry names are relative paths with forward slashes, e.g. "shaders/shader.vert".
+    std::string normalizePakName(std::string_view name);
+    uint64_t hashPakName(std::string_view name);
+
+    namespace io { class MappedFile; }
+
+    // A read only archive, mapped into memory as a whole. Lookups are a binary search over the index.
+    class PakArchive {
+    public:
+        static std::shared_ptr<PakArchive> open(const std::filesystem::path& path); // empty on failure
+
+        PakArchive(const PakArchive&) = delete;
+        PakArchive& operator=(const PakArchive&) = delete;
+
+        [[nodiscard]] const PakIndexEntry* find(std::string_view name) const;
+        [[nodiscard]] std::string_view getName(const PakIndexEntry& entry) const;
+        [[nodiscard]] std::span<const PakIndexEntry> getEntries() const noexcept;
+
+        // the stored bytes, without copying. only possible when every block is stored raw.
+        [[nodiscard]] std::optional<std::span<const std::byte>> view(const PakIndexEntry& entry) const;
+
+        // decodes into out, which must hold entry.size bytes. out can be mapped GL memory such as a StagingRing
+        // allocation, nothing is staged in between. blocks are spread over the job system.
+        bool read(const PakIndexEntry& entry, std::span<std::byte> out) const;
+        std::optional<std::vector<std::byte>> read(std::string_view name) const;
+
+    private:
+        PakArchive() = default;
+
+        bool decodeBlock(const PakIndexEntry& entry, uint32_t block, std::span<std::byte> out) const;
+
+        std::shared_ptr<io::MappedFile> m_File;
+        const std::byte* m_Data = nullptr;
+        size_t m_Size = 0;
+
+        const PakHeader* m_Header = nullptr;
+        std::span<const PakIndexEntry> m_Index;
+        std::span<const PakBlock> m_Blocks;
+        const char* m_Names = nullptr;
+    };
+
+    // Builds a .kpak, used by the cooker.
+    class PakWriter {
+    public:
+        struct Config {
+            uint32_t blockSize = 64 * 1024;
+            PakCodec codec = PakCodec::LZ4;
+        };
+
+        PakWriter();
+        explicit PakWriter(const Config& config);
+
+        void add(std::string_view name, std::vector<std::byte> data);
+        void addFile(std::string_view name, const std::filesystem::path& path);
+
+        // throws std::runtime_error when the output can't be written.
+        void write(const std::filesystem::path& path);
+
+    private:
+        struct Pending {
+            std::string name;
+            std::vector<std::byte> data;
+        };
+
+        Config m_Config;
+        std::vector<Pending> m_Entries;
+    };
+
+    namespace gbl {
+        // mounted archives, searched in order by io::read. set up before any loads and not changed after.
+        inline std::vector<std::shared_ptr<PakArchive>> paks;
+    }
+}
@@ -0,0 +1,153 @@
+#include "lz4.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace kat::lz4 {
+    constexpr size_t MIN_MATCH = 4;
+    constexpr size_t LAST_LITERALS = 5;     // the last 5 bytes are always literals
+    constexpr size_t MF_LIMIT = 12;         // and the last match starts at least 12 bytes before the end
+    constexpr size_t MAX_OFFSET = 65535;
+    constexpr int HASH_BITS = 16;
+
+    static uint32_t read32(const std::byte* p) {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static uint32_t hash(uint32_t sequence) {
+        return (sequence * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    static bool writeLength(size_t length, std::byte*& op, const std::byte* end) {
+        while (length >= 255) {
+            if (op >= end) return false;
+            *op++ = std::byte{255};
+            length -= 255;
+        }
+        if (op >= end) return false;
+        *op++ = static_cast<std::byte>(length);
+        return true;
+    }
+
+    static bool writeSequence(const std::byte* literals, size_t literalLength, size_t offset, size_t matchLength,
+                              std::byte*& op, const std::byte* end) {
+        if (op >= end) return false;
+
+        std::byte* token = op++;
+        size_t ml = matchLength ? matchLength - MIN_MATCH : 0;
+        *token = static_cast<std::byte>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(ml, 15));
+
+        if (literalLength >= 15 && !writeLength(literalLength - 15, op, end)) return false;
+
+        if (static_cast<size_t>(end - op) < literalLength) return false;
+        std::memcpy(op, literals, literalLength);
+        op += literalLength;
+
+        // the final sequence only carries literals.
+        if (matchLength == 0) return true;
+
+        if (end - op < 2) return false;
+        *op++ = static_cast<std::byte>(offset & 0xff);
+        *op++ = static_cast<std::byte>(offset >> 8);
+
+        if (ml >= 15 && !writeLength(ml - 15, op, end)) return false;
+        return true;
+    }
+
+    size_t compress(const std::byte *src, size_t size, std::byte *dst, size_t capacity) {
+        std::byte* op = dst;
+        const std::byte* end = dst + capacity;
+
+        size_t anchor = 0;
+
+        if (size > MF_LIMIT) {
+            std::vector<uint32_t> table(size_t(1) << HASH_BITS, UINT32_MAX);
+
+            size_t ip = 0;
+            const size_t matchLimit = size - LAST_LITERALS;
+            const size_t ipLimit = size - MF_LIMIT;
+
+            while (ip < ipLimit) {
+                uint32_t sequence = read32(src + ip);
+                uint32_t& slot = table[hash(sequence)];
+                uint32_t ref = slot;
+                slot = static_cast<uint32_t>(ip);
+
+                if (ref == UINT32_MAX || ip - ref > MAX_OFFSET || read32(src + ref) != sequence) {
+                    ip++;
+                    continue;
+                }
+
+                size_t length = MIN_MATCH;
+                while (ip + length < matchLimit && src[ref + length] == src[ip + length]) length++;
+
+                if (!writeSequence(src + anchor, ip - anchor, ip - ref, length, op, end)) return 0;
+
+                ip += length;
+                anchor = ip;
+            }
+        }
+
+        if (!writeSequence(src + anchor, size - anchor, 0, 0, op, end)) return 0;
+        return op - dst;
+    }
+
+    static bool readLength(const std::byte*& ip, const std::byte* end, size_t& length) {
+        uint8_t b;
+        do {
+            if (ip >= end) return false;
+            b = static_cast<uint8_t>(*ip++);
+            length += b;
+        } while (b == 255);
+        return true;
+    }
+
+    std::optional<size_t> decompress(const std::byte *src, size_t size, std::byte *dst, size_t capacity) {
+        const std::byte* ip = src;
+        const std::byte* iend = src + size;
+        std::byte* op = dst;
+        std::byte* oend = dst + capacity;
+
+        while (ip < iend) {
+            auto token = static_cast<uint8_t>(*ip++);
+
+            size_t literalLength = token >> 4;
+            if (literalLength == 15 && !readLength(ip, iend, literalLength)) return std::nullopt;
+
+            if (static_cast<size_t>(iend - ip) < literalLength || static_cast<size_t>(oend - op) < literalLength)
+                return std::nullopt;
+
+            std::memcpy(op, ip, literalLength);
+            ip += literalLength;
+            op += literalLength;
+
+            if (ip == iend) break;
+
+            if (iend - ip < 2) return std::nullopt;
+            size_t offset = static_cast<uint8_t>(ip[0]) | (static_cast<size_t>(static_cast<uint8_t>(ip[1])) << 8);
+            ip += 2;
+
+            if (offset == 0 || offset > static_cast<size_t>(op - dst)) return std::nullopt;
+
+            size_t matchLength = token & 15;
+            if (matchLength == 15 && !readLength(ip, iend, matchLength)) return std::nullopt;
+            matchLength += MIN_MATCH;
+
+            if (static_cast<size_t>(oend - op) < matchLength) return std::nullopt;
+
+            // matches may overlap their own output, which repeats the pattern.
+            const std::byte* match = op - offset;
+            if (offset >= matchLength) {
+                std::memcpy(op, match, matchLength);
+                op += matchLength;
+            } else {
+                for (size_t i = 0; i < matchLength; i++) *op++ = match[i];
+            }
+        }
+
+        return static_cast<size_t>(op - dst);
+    }
+}
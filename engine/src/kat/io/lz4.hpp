@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+// A small implementation of the LZ4 block format (no frames), compatible with the reference decoder.
+namespace kat::lz4 {
+
+    constexpr size_t compressBound(size_t size) {
+        return size + size / 255 + 16;
+    }
+
+    // returns the compressed size, or 0 when it doesn't fit in capacity.
+    size_t compress(const std::byte* src, size_t size, std::byte* dst, size_t capacity);
+
+    // returns the decompressed size, empty on malformed input or when capacity is too small.
+    std::optional<size_t> decompress(const std::byte* src, size_t size, std::byte* dst, size_t capacity);
+}
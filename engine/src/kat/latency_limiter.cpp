@@ -0,0 +1,79 @@
+#include "latency_limiter.hpp"
+
+namespace kat {
+    LatencyLimiter::LatencyLimiter() : LatencyLimiter(Config{}) {}
+
+    LatencyLimiter::LatencyLimiter(const Config &config) : m_FramesInFlight(1) {
+        setFramesInFlight(config.framesInFlight);
+    }
+
+    LatencyLimiter::~LatencyLimiter() {
+        // whoever owns the context should have cleared by now, there may be no context to delete them with.
+        if (!m_Fences.empty()) spdlog::warn("Latency limiter destroyed with {} fences left", m_Fences.size());
+    }
+
+    void LatencyLimiter::setFramesInFlight(uint32_t frames) {
+        m_FramesInFlight.store(std::clamp(frames, 1u, MAX_FRAMES_IN_FLIGHT), std::memory_order_relaxed);
+    }
+
+    uint32_t LatencyLimiter::getFramesInFlight() const noexcept {
+        return m_FramesInFlight.load(std::memory_order_relaxed);
+    }
+
+    void LatencyLimiter::presented(util::Clock::time_point inputTime) {
+        auto swapped = util::Clock::clock::now();
+
+        m_Fences.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+        // the frame about to be built counts as in flight too.
+        while (m_Fences.size() >= getFramesInFlight()) {
+            GLenum status = glClientWaitSync(m_Fences.front(), GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000);
+            if (status == GL_TIMEOUT_EXPIRED) continue;
+
+            glDeleteSync(m_Fences.front());
+            m_Fences.pop_front();
+        }
+
+        double wait = util::Clock::duration(util::Clock::clock::now() - swapped).count();
+
+        std::lock_guard lock(m_Mutex);
+        auto& s = m_Stats;
+        s.frames++;
+        s.meanWait += (wait - s.meanWait) / static_cast<double>(s.frames);
+        s.maxWait = std::max(s.maxWait, wait);
+
+        // nothing sampled yet, e.g. the first frames before input was polled.
+        if (inputTime.time_since_epoch().count() > 0.0) {
+            double latency = util::Clock::duration(swapped - inputTime).count();
+            s.lastLatency = latency;
+            m_LatencySamples++;
+            s.meanLatency += (latency - s.meanLatency) / static_cast<double>(m_LatencySamples);
+            s.maxLatency = std::max(s.maxLatency, latency);
+
+            // alongside the frame phases, so it makes the periodic log and its percentiles.
+            gbl::clock.getStats().record(util::FramePhase::Latency, latency);
+        }
+    }
+
+    void LatencyLimiter::clear() {
+        for (GLsync fence : m_Fences) glDeleteSync(fence);
+        m_Fences.clear();
+    }
+
+    LatencyLimiter::Stats LatencyLimiter::getStats() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Stats;
+    }
+
+    void LatencyLimiter::resetStats() {
+        std::lock_guard lock(m_Mutex);
+        m_Stats = {};
+        m_LatencySamples = 0;
+    }
+
+    void LatencyLimiter::logStats() const {
+        auto s = getStats();
+        spdlog::info("Input to swap ({} in flight): {:.2f}ms mean, {:.2f}ms max, fence waits {:.2f}ms mean, {:.2f}ms max",
+                     getFramesInFlight(), s.meanLatency * 1000.0, s.maxLatency * 1000.0, s.meanWait * 1000.0, s.maxWait * 1000.0);
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "kat/engine.hpp"
+#include "kat/util/clock.hpp"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+namespace kat {
+
+    // Keeps the driver from queueing frames far ahead of the GPU.
+    //
+    // Every present is followed by a fence, and once K frames are in flight presenting waits for the oldest to
+    // finish on the GPU. The render thread is held back, so simulation (blocked on the frame pipeline) samples input
+    // for the next frame only once the GPU has caught up. K = 1 finishes each frame before the next one's input is
+    // read, lowest latency and no CPU/GPU overlap; 2 and 3 trade latency back for throughput.
+    class LatencyLimiter {
+    public:
+        static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
+        struct Config {
+            uint32_t framesInFlight = 2;
+        };
+
+        // in seconds, since the last reset.
+        struct Stats {
+            uint64_t frames = 0;
+            double meanLatency = 0.0;   // input sampled to swap returned
+            double maxLatency = 0.0;
+            double lastLatency = 0.0;
+            double meanWait = 0.0;      // blocked on fences after the swap
+            double maxWait = 0.0;
+        };
+
+        LatencyLimiter();
+        explicit LatencyLimiter(const Config& config);
+        ~LatencyLimiter();
+
+        LatencyLimiter(const LatencyLimiter&) = delete;
+        LatencyLimiter& operator=(const LatencyLimiter&) = delete;
+
+        // clamped to 1-MAX_FRAMES_IN_FLIGHT, any thread.
+        void setFramesInFlight(uint32_t frames);
+        [[nodiscard]] uint32_t getFramesInFlight() const noexcept;
+
+        // GL thread, right after the swap. inputTime is when the presented frame's input was sampled.
+        void presented(util::Clock::time_point inputTime);
+
+        // drops the fences, GL thread. before the context goes away.
+        void clear();
+
+        [[nodiscard]] Stats getStats() const;
+        void resetStats();
+        void logStats() const;
+
+    private:
+        std::atomic<uint32_t> m_FramesInFlight;
+        std::deque<GLsync> m_Fences;
+
+        mutable std::mutex m_Mutex;
+        Stats m_Stats;
+        uint64_t m_LatencySamples = 0;
+    };
+}
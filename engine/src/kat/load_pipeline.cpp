@@ -0,0 +1,248 @@
+#include "load_pipeline.hpp"
+
+#include "kat/io/batch_reader.hpp"
+#include "kat/io/kpak.hpp"
+#include "kat/util/profiler.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace kat {
+    namespace {
+        constexpr const char* STAGE_NAMES[] = { "read", "decompress", "decode", "upload" };
+
+        double seconds(std::chrono::steady_clock::duration d) {
+            return std::chrono::duration<double>(d).count();
+        }
+    }
+
+    LoadPipeline::LoadPipeline() : LoadPipeline(Config{}) {}
+
+    // requests are unbounded so submitting never blocks the GL thread, the stages after it are not.
+    LoadPipeline::LoadPipeline(const Config& config) : m_Config(config),
+                                                       m_Requests(std::numeric_limits<size_t>::max()),
+                                                       m_Compressed(std::max<size_t>(config.queueCapacity, 1)),
+                                                       m_Decodes(std::max<size_t>(config.queueCapacity, 1)),
+                                                       m_Uploads(std::max<size_t>(config.queueCapacity, 1)) {
+        size_t decodeThreads = m_Config.decodeThreads;
+        if (decodeThreads == 0) decodeThreads = std::max(std::thread::hardware_concurrency() / 2, 1u);
+
+        m_ReadThread = std::thread(&LoadPipeline::readLoop, this);
+        m_DecompressThread = std::thread(&LoadPipeline::decompressLoop, this);
+        for (size_t i = 0; i < decodeThreads; i++) m_DecodeThreads.emplace_back(&LoadPipeline::decodeLoop, this);
+    }
+
+    LoadPipeline::~LoadPipeline() {
+        // closing every queue at once also wakes stages blocked on a full queue that nobody pumps anymore.
+        m_Requests.close();
+        m_Compressed.close();
+        m_Decodes.close();
+        m_Uploads.close();
+
+        m_ReadThread.join();
+        m_DecompressThread.join();
+        for (auto& thread : m_DecodeThreads) thread.join();
+    }
+
+    void LoadPipeline::submit(std::vector<std::filesystem::path> paths, Decoder decode, Uploader upload) {
+        if (!m_FirstSubmit || m_Submitted == m_Completed) {
+            m_FirstSubmit = Clock::now();
+            m_LastComplete.reset();
+        }
+
+        Item item;
+        item.paths = std::move(paths);
+        item.decode = std::move(decode);
+        item.upload = std::move(upload);
+
+        m_Submitted++;
+        m_Requests.push(std::move(item));
+    }
+
+    void LoadPipeline::readLoop() {
+        KAT_PROFILE_THREAD("load read");
+        io::BatchReader reader;
+
+        std::vector<Item> batch;
+        std::vector<std::filesystem::path> loose;
+        std::vector<std::pair<size_t, size_t>> looseSlots; // item, path
+
+        while (auto first = m_Requests.pop()) {
+            batch.clear();
+            batch.push_back(std::move(*first));
+
+            size_t files = batch.back().paths.size();
+            while (files < m_Config.readBatch) {
+                auto next = m_Requests.try_pop();
+                if (!next) break;
+
+                files += next->paths.size();
+                batch.push_back(std::move(*next));
+            }
+
+            auto start = Clock::now();
+            loose.clear();
+            looseSlots.clear();
+
+            for (size_t i = 0; i < batch.size(); i++) {
+                auto& item = batch[i];
+                item.blobs.resize(item.paths.size());
+                item.packed.resize(item.paths.size());
+
+                for (size_t p = 0; p < item.paths.size(); p++) {
+                    auto name = item.paths[p].generic_string();
+
+                    bool found = false;
+                    for (const auto& pak : gbl::paks) {
+                        const auto* entry = pak->find(name);
+                        if (!entry) continue;
+
+                        if (auto view = pak->view(*entry)) item.blobs[p] = { pak, *view };
+                        else item.packed[p] = Packed{ pak, entry };
+
+                        found = true;
+                        break;
+                    }
+
+                    if (!found) {
+                        loose.push_back(item.paths[p]);
+                        looseSlots.emplace_back(i, p);
+                    }
+                }
+            }
+
+            if (!loose.empty()) {
+                auto blobs = reader.read(loose);
+                for (size_t i = 0; i < blobs.size(); i++) {
+                    auto [item, path] = looseSlots[i];
+                    batch[item].blobs[path] = std::move(blobs[i]);
+                }
+            }
+
+            record(Stage::Read, Clock::now() - start, batch.size());
+
+            for (auto& item : batch) {
+                bool compressed = std::any_of(item.packed.begin(), item.packed.end(), [](const auto& p) { return p.has_value(); });
+                if (!(compressed ? m_Compressed : m_Decodes).push(std::move(item))) return;
+            }
+        }
+    }
+
+    void LoadPipeline::decompressLoop() {
+        KAT_PROFILE_THREAD("load decompress");
+        while (auto item = m_Compressed.pop()) {
+            auto start = Clock::now();
+
+            for (size_t p = 0; p < item->packed.size(); p++) {
+                if (!item->packed[p]) continue;
+
+                const auto& [pak, entry] = *item->packed[p];
+                std::vector<std::byte> data(entry->size);
+
+                if (pak->read(*entry, data)) item->blobs[p] = io::Blob(std::move(data));
+                else spdlog::error("Archive entry {} is corrupt", pak->getName(*entry));
+            }
+            item->packed.clear();
+
+            record(Stage::Decompress, Clock::now() - start);
+            if (!m_Decodes.push(std::move(*item))) return;
+        }
+    }
+
+    void LoadPipeline::decodeLoop() {
+        KAT_PROFILE_THREAD("load decode");
+        while (auto item = m_Decodes.pop()) {
+            auto start = Clock::now();
+
+            for (size_t p = 0; p < item->paths.size(); p++) {
+                if (item->blobs[p]) continue;
+
+                spdlog::error("Failed to load {}", item->paths[p].string());
+                item->failed = true;
+            }
+
+            if (!item->failed) {
+                try {
+                    item->decoded = item->decode(item->blobs);
+                } catch (const std::exception& e) {
+                    spdlog::error("Failed to decode {}: {}", item->paths.front().string(), e.what());
+                    item->failed = true;
+                }
+            }
+
+            // the file data isn't needed past here, don't keep it around while waiting on the GL thread.
+            item->blobs.clear();
+            record(Stage::Decode, Clock::now() - start);
+
+            if (!m_Uploads.push(std::move(*item))) return;
+        }
+    }
+
+    void LoadPipeline::upload(Item& item) {
+        if (!item.failed) {
+            auto start = Clock::now();
+            item.upload(item.decoded.get());
+            record(Stage::Upload, Clock::now() - start);
+        } else {
+            m_Failed++;
+        }
+
+        m_Completed++;
+        if (m_Completed == m_Submitted) m_LastComplete = Clock::now();
+    }
+
+    void LoadPipeline::pump() {
+        auto start = Clock::now();
+        while (seconds(Clock::now() - start) < m_Config.uploadBudget) {
+            auto item = m_Uploads.try_pop();
+            if (!item) break;
+
+            upload(*item);
+        }
+    }
+
+    void LoadPipeline::finish() {
+        while (m_Completed < m_Submitted) {
+            auto item = m_Uploads.pop();
+            if (!item) break;
+
+            upload(*item);
+        }
+    }
+
+    size_t LoadPipeline::getPendingCount() const noexcept {
+        return m_Submitted - m_Completed;
+    }
+
+    void LoadPipeline::record(Stage stage, Clock::duration elapsed, size_t items) {
+        double s = seconds(elapsed);
+
+        std::lock_guard lock(m_StatsMutex);
+        auto& stats = m_Stats[static_cast<size_t>(stage)];
+        stats.items += items;
+        stats.busy += s;
+        stats.longest = std::max(stats.longest, s / static_cast<double>(std::max<size_t>(items, 1)));
+    }
+
+    LoadPipeline::StageStats LoadPipeline::getStats(Stage stage) const {
+        std::lock_guard lock(m_StatsMutex);
+        return m_Stats[static_cast<size_t>(stage)];
+    }
+
+    void LoadPipeline::logStats() const {
+        std::lock_guard lock(m_StatsMutex);
+
+        double wall = m_FirstSubmit && m_LastComplete ? seconds(*m_LastComplete - *m_FirstSubmit) : 0.0;
+        spdlog::info("Loaded {} assets ({} failed) in {:.1f} ms", m_Completed.load(), m_Failed.load(), wall * 1000.0);
+
+        for (size_t i = 0; i < m_Stats.size(); i++) {
+            const auto& stats = m_Stats[i];
+            if (stats.items == 0) continue;
+
+            spdlog::info("  {:<10} {:>4} items, {:>7.1f} ms busy, {:>6.2f} ms slowest",
+                         STAGE_NAMES[i], stats.items, stats.busy * 1000.0, stats.longest * 1000.0);
+        }
+    }
+}
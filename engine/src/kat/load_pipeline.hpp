@@ -0,0 +1,128 @@
+#pragma once
+
+#include "kat/engine.hpp"
+#include "kat/io/file.hpp"
+#include "kat/util/bounded_queue.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace kat {
+
+    class PakArchive;
+    struct PakIndexEntry;
+
+    // Streams assets through read -> decompress -> decode -> upload, one stage per thread (or pool of threads), so
+    // loading many assets takes about as long as the slowest stage rather than the sum of all of them.
+    //
+    // Stages are connected by bounded queues: a stage that runs ahead blocks once the next queue is full, which
+    // caps how many files are held in memory at once. Submitting never blocks, so it is fine to queue everything up
+    // front, even before a window exists. Uploads only happen on the GL thread, inside pump() / finish().
+    class LoadPipeline {
+    public:
+        enum class Stage {
+            Read,           // loose files are batched through io::BatchReader, raw archive entries are viewed in place
+            Decompress,     // compressed archive entries
+            Decode,         // the asset's decoder, on one of the decode threads
+            Upload,         // the asset's uploader, on the GL thread
+            Count
+        };
+
+        struct Config {
+            size_t queueCapacity = 16;      // items waiting between two stages
+            size_t readBatch = 32;          // files handed to the batch reader at once
+            size_t decodeThreads = 0;       // 0 picks half of the hardware threads
+            double uploadBudget = 0.004;    // seconds of GL thread time per pump()
+        };
+
+        struct StageStats {
+            size_t items = 0;
+            double busy = 0.0;      // seconds spent working, summed over the stage's threads
+            double longest = 0.0;   // slowest single item
+        };
+
+        // decoders get the bytes of every path of a request, in order. uploaders get what the decoder returned.
+        using Decoder = std::function<std::shared_ptr<void>(std::span<const io::Blob>)>;
+        using Uploader = std::function<void(void*)>;
+
+        LoadPipeline();
+        explicit LoadPipeline(const Config& config);
+        ~LoadPipeline();
+
+        LoadPipeline(const LoadPipeline&) = delete;
+        LoadPipeline& operator=(const LoadPipeline&) = delete;
+
+        void submit(std::vector<std::filesystem::path> paths, Decoder decode, Uploader upload);
+
+        // decode(std::span<const io::Blob>) -> D on a decode thread, then upload(D&) on the GL thread.
+        template<typename Decode, typename Upload>
+        void load(std::vector<std::filesystem::path> paths, Decode decode, Upload upload) {
+            using D = std::invoke_result_t<Decode, std::span<const io::Blob>>;
+            submit(std::move(paths),
+                   [decode = std::move(decode)](std::span<const io::Blob> blobs) -> std::shared_ptr<void> {
+                       return std::make_shared<D>(decode(blobs));
+                   },
+                   [upload = std::move(upload)](void* decoded) { upload(*static_cast<D*>(decoded)); });
+        }
+
+        // uploads whatever is ready, within the budget. GL thread.
+        void pump();
+
+        // blocks until everything submitted so far is uploaded. GL thread.
+        void finish();
+
+        [[nodiscard]] size_t getPendingCount() const noexcept;
+        [[nodiscard]] StageStats getStats(Stage stage) const;
+        void logStats() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Packed {
+            std::shared_ptr<PakArchive> pak;
+            const PakIndexEntry* entry;
+        };
+
+        struct Item {
+            std::vector<std::filesystem::path> paths;
+            Decoder decode;
+            Uploader upload;
+
+            std::vector<io::Blob> blobs;
+            std::vector<std::optional<Packed>> packed;
+            std::shared_ptr<void> decoded;
+            bool failed = false;
+        };
+
+        void readLoop();
+        void decompressLoop();
+        void decodeLoop();
+
+        void upload(Item& item);
+        void record(Stage stage, Clock::duration elapsed, size_t items = 1);
+
+        Config m_Config;
+
+        util::bounded_queue<Item> m_Requests;
+        util::bounded_queue<Item> m_Compressed;
+        util::bounded_queue<Item> m_Decodes;
+        util::bounded_queue<Item> m_Uploads;
+
+        std::thread m_ReadThread;
+        std::thread m_DecompressThread;
+        std::vector<std::thread> m_DecodeThreads;
+
+        std::atomic<size_t> m_Submitted = 0;
+        std::atomic<size_t> m_Completed = 0;
+        std::atomic<size_t> m_Failed = 0;
+
+        std::optional<Clock::time_point> m_FirstSubmit;
+        std::optional<Clock::time_point> m_LastComplete;
+
+        std::array<StageStats, static_cast<size_t>(Stage::Count)> m_Stats{};
+        mutable std::mutex m_StatsMutex;
+    };
+}
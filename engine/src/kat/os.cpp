@@ -1,13 +1,44 @@
 #include "os.hpp"
+#include "kat/gl_trace.hpp"
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
 
 namespace kat {
     std::shared_ptr<Window> Window::create(const Window::Config &config) {
-        gbl::activeWindow = std::shared_ptr<Window>(new Window(config));
+        Config actual = config;
+        if (std::getenv("KAT_HEADLESS") && !std::holds_alternative<Headless>(actual.mode)) {
+            Headless headless;
+            if (auto* size = std::get_if<glm::uvec2>(&actual.mode)) headless.size = *size;
+
+            if (const char* frames = std::getenv("KAT_HEADLESS_FRAMES")) {
+                std::from_chars(frames, frames + std::strlen(frames), headless.frames);
+            }
+
+            actual.mode = headless;
+        }
+
+        gbl::activeWindow = std::shared_ptr<Window>(new Window(actual));
+
+        // KAT_GL_TRACE builds record every GL call into the file it names.
+        if (const char* trace = std::getenv("KAT_GL_TRACE")) gltrace::start(trace);
+
         gbl::appEvents.dispatch(AppEvent::Initialize);
         return gbl::activeWindow;
     }
 
     Window::Window(const Window::Config &config) {
+        m_Limiter.setTargetFps(config.maxFps);
+        m_SwapInterval.store(config.swapInterval, std::memory_order_relaxed);
+        m_AppliedSwapInterval = config.swapInterval;
+        m_Latency.setFramesInFlight(config.framesInFlight);
+
+        if (auto* headless = std::get_if<Headless>(&config.mode)) {
+            createHeadless(*headless);
+            return;
+        }
+
         glfwInit();
 
         glfwDefaultWindowHints();
@@ -56,29 +87,153 @@ namespace kat {
 
         glfwMakeContextCurrent(m_Window);
         gladLoadGL(glfwGetProcAddress);
+        glfwSwapInterval(config.swapInterval);
+
+        updateSize();
+    }
+
+    void Window::createHeadless(const Headless &headless) {
+        m_Headless = headless::createContext();
+        if (!m_Headless) throw std::runtime_error("no headless GL context");
+
+        // surfaceless contexts have no default framebuffer, stand one in.
+        glCreateRenderbuffers(1, &m_OffscreenColor);
+        glNamedRenderbufferStorage(m_OffscreenColor, GL_RGBA8, static_cast<int>(headless.size.x), static_cast<int>(headless.size.y));
+        glCreateRenderbuffers(1, &m_OffscreenDepthStencil);
+        glNamedRenderbufferStorage(m_OffscreenDepthStencil, GL_DEPTH24_STENCIL8, static_cast<int>(headless.size.x), static_cast<int>(headless.size.y));
+
+        glCreateFramebuffers(1, &m_OffscreenFramebuffer);
+        glNamedFramebufferRenderbuffer(m_OffscreenFramebuffer, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_OffscreenColor);
+        glNamedFramebufferRenderbuffer(m_OffscreenFramebuffer, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_OffscreenDepthStencil);
+        glNamedFramebufferReadBuffer(m_OffscreenFramebuffer, GL_COLOR_ATTACHMENT0);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_OffscreenFramebuffer);
+
+        m_FrameLimit = headless.frames;
+        m_Width.store(static_cast<int>(headless.size.x), std::memory_order_relaxed);
+        m_Height.store(static_cast<int>(headless.size.y), std::memory_order_relaxed);
     }
 
     Window::~Window() {
+        m_Latency.clear();
+        gltrace::stop();
+
+        if (m_Headless) {
+            headless::makeCurrent(*m_Headless);
+            glDeleteFramebuffers(1, &m_OffscreenFramebuffer);
+            glDeleteRenderbuffers(1, &m_OffscreenColor);
+            glDeleteRenderbuffers(1, &m_OffscreenDepthStencil);
+            headless::destroyContext(*m_Headless);
+            return;
+        }
+
         glfwDestroyWindow(m_Window);
         glfwTerminate();
     }
 
     bool Window::isOpen() const {
+        if (m_Headless) return !m_Closing.load(std::memory_order_relaxed);
         return !glfwWindowShouldClose(m_Window);
     }
 
+    void Window::close() {
+        m_Closing.store(true, std::memory_order_relaxed);
+        if (m_Window) glfwSetWindowShouldClose(m_Window, true);
+    }
+
     void Window::update() {
-        glfwSwapBuffers(m_Window);
-        glfwPollEvents();
+        swapBuffers();
+        pollEvents();
+    }
+
+    void Window::swapBuffers() {
+        swapBuffers(getInputTime());
+    }
+
+    void Window::swapBuffers(util::Clock::time_point inputTime) {
+        KAT_PROFILE_FUNCTION();
+        m_Limiter.wait();
+
+        if (m_Headless) {
+            // nothing to present or wait on, the loop runs as fast as it renders.
+            if (m_FrameLimit && ++m_Presented >= m_FrameLimit) close();
+        } else {
+            int interval = m_SwapInterval.load(std::memory_order_relaxed);
+            if (interval != m_AppliedSwapInterval) {
+                glfwSwapInterval(interval);
+                m_AppliedSwapInterval = interval;
+            }
+
+            glfwSwapBuffers(m_Window);
+        }
+
+        m_Limiter.presented();
+        m_Latency.presented(inputTime);
+        gltrace::frame();
+        kat::gbl::appEvents.dispatch(kat::AppEvent::Present);
+    }
+
+    void Window::pollEvents() {
+        pollInput();
 
         // don't start updates unless the window is remaining open after pollEvents.
         if (isOpen()) kat::gbl::appEvents.dispatch(kat::AppEvent::Update);
     }
 
+    void Window::pollInput() {
+        KAT_PROFILE_FUNCTION();
+        if (!m_Headless) {
+            glfwPollEvents();
+            updateSize();
+        }
+
+        m_InputTime.store(util::Clock::duration(util::Clock::clock::now().time_since_epoch()).count(), std::memory_order_relaxed);
+    }
+
+    util::Clock::time_point Window::getInputTime() const noexcept {
+        return util::Clock::time_point(util::Clock::duration(m_InputTime.load(std::memory_order_relaxed)));
+    }
+
+    void Window::setSwapInterval(int interval) {
+        m_SwapInterval.store(interval, std::memory_order_relaxed);
+    }
+
+    int Window::getSwapInterval() const noexcept {
+        return m_SwapInterval.load(std::memory_order_relaxed);
+    }
+
+    util::FrameLimiter &Window::getLimiter() noexcept {
+        return m_Limiter;
+    }
+
+    LatencyLimiter &Window::getLatencyLimiter() noexcept {
+        return m_Latency;
+    }
+
+    void Window::makeContextCurrent() const {
+        if (m_Headless) {
+            headless::makeCurrent(*m_Headless);
+        } else {
+            glfwMakeContextCurrent(m_Window);
+        }
+    }
+
+    void Window::releaseContext() {
+        if (gbl::activeWindow && gbl::activeWindow->isHeadless()) {
+            headless::release();
+        } else {
+            glfwMakeContextCurrent(nullptr);
+        }
+    }
+
     glm::ivec2 Window::getSize() const {
-        glm::ivec2 v;
-        glfwGetFramebufferSize(m_Window, &v.x, &v.y);
-        return v;
+        return { m_Width.load(std::memory_order_relaxed), m_Height.load(std::memory_order_relaxed) };
+    }
+
+    void Window::updateSize() {
+        int w, h;
+        glfwGetFramebufferSize(m_Window, &w, &h);
+        m_Width.store(w, std::memory_order_relaxed);
+        m_Height.store(h, std::memory_order_relaxed);
     }
 
     GLFWwindow *Window::operator*() const noexcept {
@@ -89,7 +244,16 @@ namespace kat {
         return m_Window;
     }
 
+    bool Window::isHeadless() const noexcept {
+        return m_Headless.has_value();
+    }
+
+    unsigned int Window::getDefaultFramebuffer() const noexcept {
+        return m_OffscreenFramebuffer;
+    }
+
     bool Window::getKey(int key) {
+        if (!m_Window) return false;
         return glfwGetKey(m_Window, key) == GLFW_PRESS;
     }
 
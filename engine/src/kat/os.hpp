@@ -1,6 +1,10 @@
 #pragma once
 
 #include "kat/engine.hpp"
+#include "kat/headless.hpp"
+#include "kat/latency_limiter.hpp"
+#include "kat/util/frame_limiter.hpp"
+#include <atomic>
 #include <unordered_set>
 
 namespace kat {
@@ -14,33 +18,99 @@ namespace kat {
             bool exclusive = false;
         };
 
-        using Mode = std::variant<glm::uvec2, Fullscreen>;
+        // no window or display, an offscreen context rendering into an offscreen default framebuffer, unsynced to
+        // any refresh rate. for benchmarks and golden images on CI, needs KAT_HEADLESS.
+        struct Headless {
+            glm::uvec2 size{1920, 1080};
+            uint64_t frames = 0;    // closes itself after this many presents, 0 runs until close()
+        };
+
+        using Mode = std::variant<glm::uvec2, Fullscreen, Headless>;
 
         struct Config {
             std::string title = "Window";
             Mode mode = Fullscreen{0, false};
+            int swapInterval = 1;   // 0 uncapped, 1 vsync, -1 adaptive vsync where supported
+            double maxFps = 0.0;    // paced by the frame limiter, 0 for none
+            uint32_t framesInFlight = 2;    // see LatencyLimiter
         };
 
+        // the KAT_HEADLESS environment variable forces Headless (sized like a windowed mode), KAT_HEADLESS_FRAMES
+        // sets its frame count, so existing binaries run on CI unchanged.
         static std::shared_ptr<Window> create(const Config& config);
 
         ~Window();
 
         bool isOpen() const;
+        void close();
 
         // THIS SHOULD REALLY BE THE LAST THING CALLED IN THE MAIN LOOP
         void update();
 
+        // update() split in two, for when presenting happens on a different thread than event handling.
+        void swapBuffers();
+        void swapBuffers(util::Clock::time_point inputTime);   // when the presented frame's input was sampled
+        void pollEvents(); // main thread only
+
+        // pollEvents without dispatching Update, to sample input once more right before a frame is submitted.
+        void pollInput(); // main thread only
+
+        // when input was last polled.
+        [[nodiscard]] util::Clock::time_point getInputTime() const noexcept;
+
+        // any thread, applied on the next swap by the thread owning the context.
+        void setSwapInterval(int interval);
+        [[nodiscard]] int getSwapInterval() const noexcept;
+
+        // paces swapBuffers to a target frame rate and measures present intervals.
+        [[nodiscard]] util::FrameLimiter& getLimiter() noexcept;
+
+        // bounds the frames queued ahead of the GPU after every swap, and measures input to swap latency.
+        [[nodiscard]] LatencyLimiter& getLatencyLimiter() noexcept;
+
+        // moves the GL context between threads, it can only be current on one at a time.
+        void makeContextCurrent() const;
+        static void releaseContext();
+
+        // cached on pollEvents, so it is safe to call from the render thread.
         glm::ivec2 getSize() const;
 
+        // null when headless
         GLFWwindow* operator*() const noexcept;
         [[nodiscard]] GLFWwindow* getHandle() const noexcept;
 
+        [[nodiscard]] bool isHeadless() const noexcept;
+
+        // what Framebuffer::bindDefault binds, 0 unless headless.
+        [[nodiscard]] unsigned int getDefaultFramebuffer() const noexcept;
+
         bool getKey(int key);
 
     private:
         explicit Window(const Config &config);
 
-        GLFWwindow *m_Window;
+        void updateSize();
+        void createHeadless(const Headless& headless);
+
+        GLFWwindow *m_Window = nullptr;
+
+        std::optional<headless::Context> m_Headless;
+        unsigned int m_OffscreenFramebuffer = 0;
+        unsigned int m_OffscreenColor = 0;
+        unsigned int m_OffscreenDepthStencil = 0;
+        uint64_t m_FrameLimit = 0;
+        uint64_t m_Presented = 0;
+        std::atomic<bool> m_Closing = false;
+
+        util::FrameLimiter m_Limiter;
+        std::atomic<int> m_SwapInterval = 1;
+        int m_AppliedSwapInterval = 1;
+
+        LatencyLimiter m_Latency;
+        std::atomic<double> m_InputTime = 0.0;    // seconds since the clock's epoch
+
+        std::atomic<int> m_Width = 0;
+        std::atomic<int> m_Height = 0;
     };
 
     namespace input {
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+namespace kat::util {
+
+    // A blocking multi producer / multi consumer queue with a fixed capacity, producers wait while it is full.
+    // Once closed, pushes fail and pops drain what is left, then return empty.
+    template<typename T>
+    class bounded_queue {
+    public:
+
+        inline explicit bounded_queue(size_t capacity) : m_Capacity(capacity) {};
+
+        bounded_queue(const bounded_queue&) = delete;
+        bounded_queue& operator=(const bounded_queue&) = delete;
+
+        inline bool push(T value) {
+            std::unique_lock lock(m_Mutex);
+            m_NotFull.wait(lock, [this]() { return m_Queue.size() < m_Capacity || m_Closed; });
+            if (m_Closed) return false;
+
+            m_Queue.push_back(std::move(value));
+            m_NotEmpty.notify_one();
+            return true;
+        };
+
+        inline bool try_push(T& value) {
+            std::lock_guard lock(m_Mutex);
+            if (m_Closed || m_Queue.size() >= m_Capacity) return false;
+
+            m_Queue.push_back(std::move(value));
+            m_NotEmpty.notify_one();
+            return true;
+        };
+
+        inline std::optional<T> pop() {
+            std::unique_lock lock(m_Mutex);
+            m_NotEmpty.wait(lock, [this]() { return !m_Queue.empty() || m_Closed; });
+            return take();
+        };
+
+        inline std::optional<T> try_pop() {
+            std::lock_guard lock(m_Mutex);
+            return take();
+        };
+
+        inline void close() {
+            std::lock_guard lock(m_Mutex);
+            m_Closed = true;
+            m_NotFull.notify_all();
+            m_NotEmpty.notify_all();
+        };
+
+        [[nodiscard]] inline size_t size() const {
+            std::lock_guard lock(m_Mutex);
+            return m_Queue.size();
+        };
+
+        [[nodiscard]] constexpr size_t capacity() const noexcept { return m_Capacity; };
+
+    private:
+
+        inline std::optional<T> take() {
+            if (m_Queue.empty()) return std::nullopt;
+
+            T value = std::move(m_Queue.front());
+            m_Queue.pop_front();
+            m_NotFull.notify_one();
+            return value;
+        };
+
+        size_t m_Capacity;
+        std::deque<T> m_Queue;
+        bool m_Closed = false;
+
+        mutable std::mutex m_Mutex;
+        std::condition_variable m_NotFull;
+        std::condition_variable m_NotEmpty;
+    };
+}
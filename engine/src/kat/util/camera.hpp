@@ -1,6 +1,6 @@
 #pragma once
 
-#include "kat/engine.hpp"
+#include "kat/core.hpp"
 #include "kat/util/interfaces.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 
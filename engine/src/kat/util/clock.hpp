@@ -1,5 +1,8 @@
 #pragma once
 
+#include "kat/util/frame_stats.hpp"
+#include "kat/util/profiler.hpp"
+
 #include <chrono>
 #include <concepts>
 #include <type_traits>
@@ -15,10 +18,16 @@ namespace kat::util {
                          m_ThisFrame(clock::now()), m_DeltaTime(1.0 / 60.0) {};
 
         inline void tick() {
+            KAT_PROFILE_FRAME();
+
             m_FrameCounter++;
             m_LastFrame = m_ThisFrame;
             m_ThisFrame = clock::now();
             m_DeltaTime = m_ThisFrame - m_LastFrame;
+
+            // the first delta is made up.
+            if (m_FrameCounter > 1) m_Stats.record(FramePhase::Frame, m_DeltaTime.count());
+            m_Stats.update();
         };
 
         [[nodiscard]] duration getDeltaTime() const noexcept {
@@ -33,12 +42,22 @@ namespace kat::util {
             return m_ThisFrame;
         };
 
+        [[nodiscard]] unsigned long long getFrameCount() const noexcept {
+            return m_FrameCounter;
+        };
+
+        // frame times from tick, and whatever phases the loop measures into it.
+        [[nodiscard]] FrameStats& getStats() noexcept {
+            return m_Stats;
+        };
+
     private:
 
         unsigned long long m_FrameCounter = 0;
         time_point m_LastFrame;
         time_point m_ThisFrame;
         duration m_DeltaTime;
+        FrameStats m_Stats;
     };
 
 }
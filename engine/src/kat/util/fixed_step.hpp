@@ -0,0 +1,91 @@
+#pragma once
+
+#include "kat/util/clock.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace kat::util {
+
+    // Runs simulation in fixed steps, however long frames take.
+    //
+    // Every frame's real time goes into an accumulator, and whole steps are taken out of it. What is left over is
+    // the interpolation alpha, how far rendering is between the previous and the latest simulated state. A heavy
+    // frame can owe at most maxSteps steps, the rest of its time is dropped instead of snowballing into the next one.
+    class FixedStepLoop {
+    public:
+        struct Config {
+            double step = 1.0 / 60.0;
+            uint32_t maxSteps = 4;          // per frame, time beyond this is dropped
+            double maxFrameTime = 0.25;     // longer frames (breakpoints, window drags) count as this long
+        };
+
+        inline FixedStepLoop() : FixedStepLoop(Config{}) {};
+        inline explicit FixedStepLoop(const Config& config) : m_Config(config) {};
+
+        // adds a frame's time and returns how many steps are due.
+        inline uint32_t advance(double frameTime) {
+            m_Accumulator += std::clamp(frameTime, 0.0, m_Config.maxFrameTime);
+
+            auto due = static_cast<uint64_t>(m_Accumulator / m_Config.step);
+            auto steps = static_cast<uint32_t>(std::min<uint64_t>(due, m_Config.maxSteps));
+            m_Accumulator -= static_cast<double>(steps) * m_Config.step;
+
+            if (steps < due) {
+                // behind by more than the cap, keep only the fraction so alpha stays continuous.
+                double remainder = std::fmod(m_Accumulator, m_Config.step);
+                m_Dropped += m_Accumulator - remainder;
+                m_Accumulator = remainder;
+            }
+
+            m_StepCount += steps;
+            return steps;
+        };
+
+        inline uint32_t advance(const Clock& clock) {
+            return advance(clock.getDeltaTime().count());
+        };
+
+        // advance, then call step(dt) once per due step.
+        template<typename F>
+        inline uint32_t run(double frameTime, F&& step) {
+            uint32_t steps = advance(frameTime);
+            for (uint32_t i = 0; i < steps; i++) step(m_Config.step);
+            return steps;
+        };
+
+        template<typename F>
+        inline uint32_t run(const Clock& clock, F&& step) {
+            return run(clock.getDeltaTime().count(), std::forward<F>(step));
+        };
+
+        // 0 at the latest step, approaching 1 as the next one comes due.
+        [[nodiscard]] inline double getAlpha() const noexcept {
+            return m_Accumulator / m_Config.step;
+        };
+
+        [[nodiscard]] inline double getStep() const noexcept {
+            return m_Config.step;
+        };
+
+        [[nodiscard]] inline uint64_t getStepCount() const noexcept {
+            return m_StepCount;
+        };
+
+        // simulated time given up to the max steps guard.
+        [[nodiscard]] inline double getDroppedTime() const noexcept {
+            return m_Dropped;
+        };
+
+        [[nodiscard]] inline const Config& getConfig() const noexcept {
+            return m_Config;
+        };
+
+    private:
+        Config m_Config;
+        double m_Accumulator = 0.0;
+        double m_Dropped = 0.0;
+        uint64_t m_StepCount = 0;
+    };
+}
@@ -0,0 +1,128 @@
+#include "frame_limiter.hpp"
+
+#include <cmath>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace kat::util {
+    namespace {
+        void relax() {
+#if defined(__x86_64__) || defined(_M_X64)
+            _mm_pause();
+#else
+            std::this_thread::yield();
+#endif
+        }
+
+        using Seconds = std::chrono::duration<double>;
+
+        std::chrono::steady_clock::time_point now() {
+            return std::chrono::steady_clock::now();
+        }
+
+        std::chrono::steady_clock::duration toSteady(double seconds) {
+            return std::chrono::duration_cast<std::chrono::steady_clock::duration>(Seconds(seconds));
+        }
+    }
+
+    FrameLimiter::FrameLimiter() : FrameLimiter(Config{}) {}
+
+    FrameLimiter::FrameLimiter(const Config &config)
+            : m_Config(config), m_TargetFps(config.targetFps), m_Spin(config.maxSpin) {}
+
+    void FrameLimiter::setTargetFps(double fps) {
+        m_TargetFps.store(std::max(fps, 0.0), std::memory_order_relaxed);
+    }
+
+    double FrameLimiter::getTargetFps() const noexcept {
+        return m_TargetFps.load(std::memory_order_relaxed);
+    }
+
+    void FrameLimiter::wait() {
+        double fps = getTargetFps();
+        if (fps <= 0.0) {
+            m_HasDeadline = false;
+            return;
+        }
+
+        auto period = toSteady(1.0 / fps);
+        auto current = now();
+
+        // a deadline a whole frame in the past means we fell behind, start over instead of rushing to catch up.
+        if (!m_HasDeadline || current - m_Deadline > period) {
+            m_Deadline = current;
+            m_HasDeadline = true;
+            return;
+        }
+
+        m_Deadline += period;
+        sleepUntil(m_Deadline);
+    }
+
+    void FrameLimiter::sleepUntil(SteadyClock::time_point deadline) {
+        auto margin = toSteady(m_Spin);
+
+        if (deadline - now() > margin) {
+            auto target = deadline - margin;
+            std::this_thread::sleep_until(target);
+
+            // follow how late sleeps wake up, quick to widen and slow to shrink.
+            double overshoot = Seconds(now() - target).count();
+            double wanted = std::clamp(overshoot * 1.5, m_Config.minSpin, m_Config.maxSpin);
+            m_Spin = wanted > m_Spin ? wanted : m_Spin + (wanted - m_Spin) * 0.05;
+        }
+
+        while (now() < deadline) relax();
+    }
+
+    void FrameLimiter::presented() {
+        auto current = now();
+        if (!m_HasPresented) {
+            m_LastPresent = current;
+            m_HasPresented = true;
+            return;
+        }
+
+        double interval = Seconds(current - m_LastPresent).count();
+        m_LastPresent = current;
+
+        double fps = getTargetFps();
+
+        std::lock_guard lock(m_Mutex);
+        auto& s = m_Stats;
+        s.frames++;
+
+        double delta = interval - s.mean;
+        s.mean += delta / static_cast<double>(s.frames);
+        m_M2 += delta * (interval - s.mean);
+        s.jitter = s.frames > 1 ? std::sqrt(m_M2 / static_cast<double>(s.frames - 1)) : 0.0;
+
+        s.min = s.frames == 1 ? interval : std::min(s.min, interval);
+        s.max = std::max(s.max, interval);
+        if (fps > 0.0 && interval > 1.5 / fps) s.late++;
+        s.spin = m_Spin;
+    }
+
+    FrameLimiter::Stats FrameLimiter::getStats() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Stats;
+    }
+
+    void FrameLimiter::resetStats() {
+        std::lock_guard lock(m_Mutex);
+        m_Stats = {};
+        m_M2 = 0.0;
+    }
+
+    void FrameLimiter::logStats() const {
+        auto s = getStats();
+        double fps = getTargetFps();
+
+        spdlog::info("Frame pacing ({}): {} frames, {:.3f}ms mean, {:.3f}ms jitter, {:.3f}-{:.3f}ms, {} late, {:.2f}ms spin",
+                     fps > 0.0 ? fmt::format("{:.0f} fps", fps) : "unlimited", s.frames, s.mean * 1000.0,
+                     s.jitter * 1000.0, s.min * 1000.0, s.max * 1000.0, s.late, s.spin * 1000.0);
+    }
+}
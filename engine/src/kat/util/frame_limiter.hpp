@@ -0,0 +1,72 @@
+#pragma once
+
+#include "kat/core.hpp"
+#include "kat/util/clock.hpp"
+
+#include <atomic>
+#include <mutex>
+
+namespace kat::util {
+
+    // Sleeps until a frame's deadline, then measures when it actually went out.
+    //
+    // Coarse sleeps (nanosleep underneath) wake up late by a scheduler quantum or so, so waiting sleeps until a
+    // margin before the deadline and spins the rest. The margin follows how late sleeps have been waking up, kept
+    // small where the timer is precise and widened where it isn't.
+    class FrameLimiter {
+    public:
+        struct Config {
+            double targetFps = 0.0;         // 0 leaves pacing to vsync or runs uncapped
+            double minSpin = 0.0002;
+            double maxSpin = 0.004;
+        };
+
+        // present intervals since the last reset, in seconds.
+        struct Stats {
+            uint64_t frames = 0;
+            double mean = 0.0;
+            double jitter = 0.0;    // standard deviation
+            double min = 0.0;
+            double max = 0.0;
+            uint64_t late = 0;      // more than half a target frame past the deadline
+            double spin = 0.0;      // current spin margin
+        };
+
+        FrameLimiter();
+        explicit FrameLimiter(const Config& config);
+
+        // any thread, takes effect on the next wait.
+        void setTargetFps(double fps);
+        [[nodiscard]] double getTargetFps() const noexcept;
+
+        // before presenting, blocks until this frame's deadline.
+        void wait();
+
+        // right after presenting.
+        void presented();
+
+        [[nodiscard]] Stats getStats() const;
+        void resetStats();
+        void logStats() const;
+
+    private:
+        // monotonic and integral, unlike Clock (high_resolution_clock can be the wall clock, stepped by NTP).
+        using SteadyClock = std::chrono::steady_clock;
+
+        void sleepUntil(SteadyClock::time_point deadline);
+
+        Config m_Config;
+        std::atomic<double> m_TargetFps;
+
+        SteadyClock::time_point m_Deadline{};
+        bool m_HasDeadline = false;
+        double m_Spin;
+
+        SteadyClock::time_point m_LastPresent{};
+        bool m_HasPresented = false;
+
+        mutable std::mutex m_Mutex;
+        Stats m_Stats;
+        double m_M2 = 0.0;  // running sum of squared deviations (Welford)
+    };
+}
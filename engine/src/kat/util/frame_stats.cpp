@@ -0,0 +1,213 @@
+#include "frame_stats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace kat::util {
+    namespace {
+        template<typename T>
+        void storeMax(std::atomic<T>& target, T value) {
+            T current = target.load(std::memory_order_relaxed);
+            while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+        }
+
+        template<typename T>
+        void add(std::atomic<T>& target, T value) {
+            T current = target.load(std::memory_order_relaxed);
+            while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {}
+        }
+
+        double ms(double seconds) {
+            return seconds * 1000.0;
+        }
+    }
+
+    void HdrHistogram::record(double seconds) {
+        auto micros = static_cast<uint64_t>(std::max(seconds, 0.0) * 1e6);
+        m_Buckets[indexOf(micros)].fetch_add(1, std::memory_order_relaxed);
+        m_Count.fetch_add(1, std::memory_order_relaxed);
+        storeMax(m_Max, micros);
+    }
+
+    uint64_t HdrHistogram::getCount() const noexcept {
+        return m_Count.load(std::memory_order_relaxed);
+    }
+
+    double HdrHistogram::getMax() const noexcept {
+        return static_cast<double>(m_Max.load(std::memory_order_relaxed)) * 1e-6;
+    }
+
+    double HdrHistogram::getPercentile(double p) const {
+        uint64_t count = getCount();
+        if (count == 0) return 0.0;
+
+        auto rank = static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 1.0) * static_cast<double>(count)));
+        rank = std::max<uint64_t>(rank, 1);
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; i++) {
+            seen += m_Buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                double lo = static_cast<double>(lowerBoundOf(i));
+                double hi = static_cast<double>(i + 1 < BUCKETS ? lowerBoundOf(i + 1) : lowerBoundOf(i) + 1);
+                return std::min((lo + hi) * 0.5e-6, getMax());
+            }
+        }
+        return getMax();
+    }
+
+    void HdrHistogram::reset() {
+        for (auto& bucket : m_Buckets) bucket.store(0, std::memory_order_relaxed);
+        m_Count.store(0, std::memory_order_relaxed);
+        m_Max.store(0, std::memory_order_relaxed);
+    }
+
+    // exact below SUB_BUCKETS, then SUB_BUCKETS linear steps per power of two.
+    size_t HdrHistogram::indexOf(uint64_t micros) {
+        if (micros < SUB_BUCKETS) return micros;
+
+        uint32_t exponent = std::bit_width(micros) - 1;
+        if (exponent > MAX_EXPONENT) return BUCKETS - 1;
+
+        return (exponent - SUB_BITS + 1) * SUB_BUCKETS + ((micros >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1));
+    }
+
+    uint64_t HdrHistogram::lowerBoundOf(size_t index) {
+        if (index < SUB_BUCKETS) return index;
+
+        auto exponent = static_cast<uint32_t>(index / SUB_BUCKETS) + SUB_BITS - 1;
+        return static_cast<uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << (exponent - SUB_BITS);
+    }
+
+    const char *nameOf(FramePhase phase) {
+        switch (phase) {
+            case FramePhase::Frame: return "frame";
+            case FramePhase::Update: return "update";
+            case FramePhase::Render: return "render";
+            case FramePhase::Swap: return "swap";
+            case FramePhase::Gpu: return "gpu";
+            case FramePhase::Latency: return "latency";
+            default: return "?";
+        }
+    }
+
+    FrameStats::Scope::Scope(FrameStats &stats, FramePhase phase)
+            : m_Stats(stats), m_Phase(phase), m_Start(std::chrono::steady_clock::now()) {}
+
+    FrameStats::Scope::~Scope() {
+        m_Stats.record(m_Phase, std::chrono::duration<double>(std::chrono::steady_clock::now() - m_Start).count());
+    }
+
+    FrameStats::FrameStats() : FrameStats(Config{}) {}
+
+    FrameStats::FrameStats(const Config &config)
+            : m_Config(config), m_Mask(std::bit_ceil(std::max<size_t>(config.window, 1)) - 1),
+              m_LastLog(std::chrono::steady_clock::now()) {
+        for (size_t i = 0; i < static_cast<size_t>(FramePhase::Count); i++) m_Phases.push_back(std::make_unique<Phase>(m_Mask + 1));
+    }
+
+    void FrameStats::record(FramePhase phase, double seconds) {
+        auto& p = *m_Phases[static_cast<size_t>(phase)];
+
+        // single writer per phase: fill the slot, then publish it by moving the write index past it.
+        uint64_t index = p.written.load(std::memory_order_relaxed);
+        p.ring[index & m_Mask].store(static_cast<float>(seconds), std::memory_order_relaxed);
+        p.written.store(index + 1, std::memory_order_release);
+
+        add(p.sum, seconds);
+        p.histogram.record(seconds);
+
+        if (phase == FramePhase::Frame && seconds > m_Config.hitchThreshold) {
+            m_Hitches.fetch_add(1, std::memory_order_relaxed);
+            storeMax(m_LongestHitch, seconds);
+        }
+    }
+
+    FrameStats::Scope FrameStats::measure(FramePhase phase) {
+        return { *this, phase };
+    }
+
+    FrameStats::Summary FrameStats::getRecent(FramePhase phase) const {
+        const auto& p = *m_Phases[static_cast<size_t>(phase)];
+
+        uint64_t written = p.written.load(std::memory_order_acquire);
+        size_t count = static_cast<size_t>(std::min<uint64_t>(written, m_Mask + 1));
+        if (count == 0) return {};
+
+        std::vector<float> values(count);
+        for (size_t i = 0; i < count; i++) values[i] = p.ring[(written - count + i) & m_Mask].load(std::memory_order_relaxed);
+        return summarize(std::move(values));
+    }
+
+    FrameStats::Summary FrameStats::summarize(std::vector<float> values) {
+        size_t count = values.size();
+        if (count == 0) return {};
+
+        std::sort(values.begin(), values.end());
+
+        auto at = [&](double q) { return static_cast<double>(values[std::min(count - 1, static_cast<size_t>(q * static_cast<double>(count)))]); };
+
+        double sum = 0.0;
+        for (float v : values) sum += v;
+
+        return { count, sum / static_cast<double>(count), at(0.5), at(0.95), at(0.99), values.back() };
+    }
+
+    FrameStats::Summary FrameStats::getTotal(FramePhase phase) const {
+        const auto& p = *m_Phases[static_cast<size_t>(phase)];
+        const auto& h = p.histogram;
+
+        uint64_t count = h.getCount();
+        if (count == 0) return {};
+
+        return { count, p.sum.load(std::memory_order_relaxed) / static_cast<double>(count),
+                 h.getPercentile(0.5), h.getPercentile(0.95), h.getPercentile(0.99), h.getMax() };
+    }
+
+    uint64_t FrameStats::getHitchCount() const noexcept {
+        return m_Hitches.load(std::memory_order_relaxed);
+    }
+
+    double FrameStats::getLongestHitch() const noexcept {
+        return m_LongestHitch.load(std::memory_order_relaxed);
+    }
+
+    void FrameStats::update() {
+        if (m_Config.logInterval <= 0.0) return;
+
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration<double>(now - m_LastLog).count() < m_Config.logInterval) return;
+
+        m_LastLog = now;
+        log();
+    }
+
+    void FrameStats::log() const {
+        for (size_t i = 0; i < static_cast<size_t>(FramePhase::Count); i++) {
+            auto phase = static_cast<FramePhase>(i);
+            auto recent = getRecent(phase);
+            if (recent.count == 0) continue;
+
+            auto total = getTotal(phase);
+            spdlog::info("{:>7}: {:.2f}ms mean, p50 {:.2f} / p95 {:.2f} / p99 {:.2f} / max {:.2f}ms (last {}), "
+                         "p99 {:.2f} / max {:.2f}ms overall", nameOf(phase), ms(recent.mean), ms(recent.p50),
+                         ms(recent.p95), ms(recent.p99), ms(recent.max), recent.count, ms(total.p99), ms(total.max));
+        }
+
+        if (auto hitches = getHitchCount()) {
+            spdlog::warn("{} frames over {:.1f}ms, longest {:.2f}ms", hitches, ms(m_Config.hitchThreshold), ms(getLongestHitch()));
+        }
+    }
+
+    void FrameStats::reset() {
+        for (auto& p : m_Phases) {
+            p->written.store(0, std::memory_order_relaxed);
+            p->sum.store(0.0, std::memory_order_relaxed);
+            p->histogram.reset();
+        }
+
+        m_Hitches.store(0, std::memory_order_relaxed);
+        m_LongestHitch.store(0.0, std::memory_order_relaxed);
+    }
+}
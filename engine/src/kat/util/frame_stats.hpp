@@ -0,0 +1,130 @@
+#pragma once
+
+#include "kat/core.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+namespace kat::util {
+
+    // Counts of durations in log-linear buckets (32 per power of two, so within ~3%), from a microsecond to days.
+    // Fixed size and lock-free to record into, percentiles come from walking the buckets.
+    class HdrHistogram {
+    public:
+        static constexpr uint32_t SUB_BITS = 5;
+        static constexpr uint32_t SUB_BUCKETS = 1u << SUB_BITS;
+        static constexpr uint32_t MAX_EXPONENT = 40;
+        static constexpr size_t BUCKETS = (MAX_EXPONENT - SUB_BITS + 2) * SUB_BUCKETS;
+
+        // any thread
+        void record(double seconds);
+
+        [[nodiscard]] uint64_t getCount() const noexcept;
+        [[nodiscard]] double getMax() const noexcept;
+
+        // p in [0, 1], the middle of the bucket holding it.
+        [[nodiscard]] double getPercentile(double p) const;
+
+        void reset();
+
+    private:
+        static size_t indexOf(uint64_t micros);
+        static uint64_t lowerBoundOf(size_t index);
+
+        std::array<std::atomic<uint64_t>, BUCKETS> m_Buckets{};
+        std::atomic<uint64_t> m_Count = 0;
+        std::atomic<uint64_t> m_Max = 0;
+    };
+
+    enum class FramePhase {
+        Frame,      // tick to tick
+        Update,
+        Render,
+        Swap,
+        Gpu,        // first to last GPU zone, a few frames late
+        Latency,    // input sampled to swap returned
+        Count
+    };
+
+    const char* nameOf(FramePhase phase);
+
+    // Frame timings for long sessions: a ring of the latest few hundred per phase for exact recent percentiles, and
+    // a histogram of everything since the last reset. Each phase takes one writer at a time (update on the main
+    // thread, render, swap, gpu and latency on the render thread), readers never block them.
+    class FrameStats {
+    public:
+        struct Config {
+            size_t window = 1024;           // frames per ring, rounded up to a power of two
+            double logInterval = 60.0;      // seconds between periodic logs, 0 to only log by hand
+            double hitchThreshold = 1.0 / 20.0;
+        };
+
+        struct Summary {
+            uint64_t count = 0;
+            double mean = 0.0;
+            double p50 = 0.0;
+            double p95 = 0.0;
+            double p99 = 0.0;
+            double max = 0.0;
+        };
+
+        // records a phase's duration when it goes out of scope.
+        class Scope {
+        public:
+            Scope(FrameStats& stats, FramePhase phase);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            FrameStats& m_Stats;
+            FramePhase m_Phase;
+            std::chrono::steady_clock::time_point m_Start;
+        };
+
+        FrameStats();
+        explicit FrameStats(const Config& config);
+
+        void record(FramePhase phase, double seconds);
+        [[nodiscard]] Scope measure(FramePhase phase);
+
+        // exact percentiles of a set of durations, in any order.
+        [[nodiscard]] static Summary summarize(std::vector<float> values);
+
+        // the ring, exact.
+        [[nodiscard]] Summary getRecent(FramePhase phase) const;
+
+        // the histogram, since the last reset.
+        [[nodiscard]] Summary getTotal(FramePhase phase) const;
+
+        // frames over the hitch threshold, and the longest of them.
+        [[nodiscard]] uint64_t getHitchCount() const noexcept;
+        [[nodiscard]] double getLongestHitch() const noexcept;
+
+        // logs when logInterval passed since the last one, once per frame from one thread.
+        void update();
+        void log() const;
+        void reset();
+
+    private:
+        struct Phase {
+            std::vector<std::atomic<float>> ring;
+            std::atomic<uint64_t> written = 0;
+            std::atomic<double> sum = 0.0;
+            HdrHistogram histogram;
+
+            explicit Phase(size_t size) : ring(size) {}
+        };
+
+        Config m_Config;
+        size_t m_Mask;
+        std::vector<std::unique_ptr<Phase>> m_Phases;
+
+        std::atomic<uint64_t> m_Hitches = 0;
+        std::atomic<double> m_LongestHitch = 0.0;
+
+        std::chrono::steady_clock::time_point m_LastLog;
+    };
+}
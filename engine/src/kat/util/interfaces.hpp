@@ -1,6 +1,6 @@
 #pragma once
 
-#include "kat/engine.hpp"
+#include "kat/core.hpp"
 #include "glm/gtc/constants.hpp"
 
 #include <concepts>
@@ -0,0 +1,112 @@
+#include "job_system.hpp"
+#include "kat/util/profiler.hpp"
+
+#include <atomic>
+
+namespace kat {
+    JobSystem::JobSystem(size_t workerCount) {
+        if (workerCount == 0) {
+            size_t hw = std::thread::hardware_concurrency();
+            workerCount = hw > 1 ? hw - 1 : 1;
+        }
+
+        for (size_t i = 0; i < workerCount; i++) {
+            m_Workers.emplace_back(&JobSystem::workerLoop, this);
+        }
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_WorkAvailable.notify_all();
+
+        for (auto& w : m_Workers) w.join();
+    }
+
+    void JobSystem::submit(Job job) {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Queue.push_back(std::move(job));
+        }
+        m_WorkAvailable.notify_one();
+    }
+
+    void JobSystem::parallelFor(size_t count, const std::function<void(size_t)> &fn) {
+        if (count == 0) return;
+
+        // helpers can still be queued once every index is done and this returns, so whatever they touch has to
+        // outlive the call. fn is only reached for an index below count, which can't happen after that.
+        struct State {
+            const std::function<void(size_t)>* fn;
+            size_t count;
+            std::atomic<size_t> next = 0;
+            size_t done = 0;
+            std::mutex mutex;
+            std::condition_variable condition;
+        };
+
+        auto state = std::make_shared<State>();
+        state->fn = &fn;
+        state->count = count;
+
+        auto work = [state]() {
+            size_t finished = 0;
+            for (size_t i = state->next++; i < state->count; i = state->next++) {
+                (*state->fn)(i);
+                finished++;
+            }
+            if (!finished) return;
+
+            std::lock_guard lock(state->mutex);
+            state->done += finished;
+            if (state->done == state->count) state->condition.notify_all();
+        };
+
+        size_t helpers = std::min(count, m_Workers.size());
+        for (size_t i = 0; i < helpers; i++) submit(work);
+
+        work();
+
+        std::unique_lock lock(state->mutex);
+        state->condition.wait(lock, [&]() { return state->done == state->count; });
+    }
+
+    void JobSystem::waitIdle() {
+        std::unique_lock lock(m_Mutex);
+        m_Idle.wait(lock, [this]() { return m_Queue.empty() && m_Running == 0; });
+    }
+
+    size_t JobSystem::getWorkerCount() const noexcept {
+        return m_Workers.size();
+    }
+
+    void JobSystem::workerLoop() {
+        KAT_PROFILE_THREAD("job worker");
+
+        std::unique_lock lock(m_Mutex);
+        while (true) {
+            m_WorkAvailable.wait(lock, [this]() { return !m_Queue.empty() || m_Stopping; });
+            if (m_Queue.empty() && m_Stopping) return;
+
+            runOne(lock);
+        }
+    }
+
+    bool JobSystem::runOne(std::unique_lock<std::mutex> &lock) {
+        if (m_Queue.empty()) return false;
+
+        Job job = std::move(m_Queue.front());
+        m_Queue.pop_front();
+        m_Running++;
+
+        lock.unlock();
+        job();
+        lock.lock();
+
+        m_Running--;
+        if (m_Queue.empty() && m_Running == 0) m_Idle.notify_all();
+        return true;
+    }
+}
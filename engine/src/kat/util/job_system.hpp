@@ -0,0 +1,65 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kat {
+
+    // A plain worker pool. Jobs must not touch GL, hand results back to the GL thread instead.
+    class JobSystem {
+    public:
+        using Job = std::function<void()>;
+
+        // defaults to one worker per hardware thread, leaving one for the main thread.
+        explicit JobSystem(size_t workerCount = 0);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        void submit(Job job);
+
+        template<typename F>
+        auto async(F&& f) -> std::future<std::invoke_result_t<F>> {
+            using R = std::invoke_result_t<F>;
+            auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+            auto future = task->get_future();
+            submit([task]() { (*task)(); });
+            return future;
+        }
+
+        // runs fn(i) for every i in [0, count), spread over the workers, and waits for all of them. the calling
+        // thread helps out rather than sitting idle.
+        void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+        // blocks until the queue is empty and no job is running.
+        void waitIdle();
+
+        [[nodiscard]] size_t getWorkerCount() const noexcept;
+
+    private:
+        void workerLoop();
+        bool runOne(std::unique_lock<std::mutex>& lock);
+
+        std::vector<std::thread> m_Workers;
+        std::deque<Job> m_Queue;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_WorkAvailable;
+        std::condition_variable m_Idle;
+
+        size_t m_Running = 0;
+        bool m_Stopping = false;
+    };
+
+    namespace gbl {
+        // created by gbl::setup, by hand where there is no window (tools, the server)
+        inline std::unique_ptr<JobSystem> jobs;
+    }
+}
@@ -0,0 +1,234 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace kat::profiler {
+    // time in nanoseconds since start in the low 62 bits, the event type in the top two.
+    struct Event {
+        const char* name;
+        uint64_t stamp;
+    };
+
+    // an event as it sits in a ring. exports read slots while their thread keeps writing, so every field is atomic and
+    // sequence says which event the slot holds: index + 1 once written, 0 while being rewritten.
+    struct Slot {
+        std::atomic<uint64_t> sequence = 0;
+        std::atomic<const char*> name = nullptr;
+        std::atomic<uint64_t> stamp = 0;
+    };
+
+    static_assert(sizeof(Slot) == 24);
+
+    struct ThreadBuffer {
+        std::vector<Slot> ring = std::vector<Slot>(EVENTS_PER_THREAD);
+        std::atomic<uint64_t> written = 0;
+        std::vector<const char*> open;  // names of the zones begun and not ended, for end()
+
+        uint32_t id = 0;
+        std::string name;
+    };
+
+    namespace {
+        using clock = std::chrono::steady_clock;
+
+        constexpr uint64_t TIME_MASK = (uint64_t(1) << 62) - 1;
+
+        const clock::time_point s_Start = clock::now();
+
+        // buffers live until exit so threads that are gone still show up in traces.
+        std::mutex s_Mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> s_Buffers;
+
+        // hitch capture, under s_Mutex. frame() and captureHitches() may be called from different threads.
+        double s_HitchThreshold = 0.0;
+        double s_HitchCooldown = 10.0;
+        std::filesystem::path s_HitchDirectory;
+        clock::time_point s_LastFrame{};
+        clock::time_point s_LastCapture{};
+        uint32_t s_Captures = 0;
+
+        ThreadBuffer* registerBuffer(std::string name) {
+            std::lock_guard lock(s_Mutex);
+            auto& b = s_Buffers.emplace_back(std::make_unique<ThreadBuffer>());
+            b->id = static_cast<uint32_t>(s_Buffers.size());
+            b->name = name.empty() ? fmt::format("thread {}", b->id) : std::move(name);
+            return b.get();
+        }
+
+        ThreadBuffer& local() {
+            thread_local ThreadBuffer* buffer = registerBuffer({});
+            return *buffer;
+        }
+
+        void push(ThreadBuffer& b, const char* name, EventType type, clock::time_point at) {
+            // anything before the profiler existed is clamped to its start.
+            auto time = static_cast<uint64_t>(std::max<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(at - s_Start).count(), 0));
+
+            // single writer seqlock: mark the slot torn, fill it, then publish it under its new sequence.
+            uint64_t index = b.written.load(std::memory_order_relaxed);
+            Slot& slot = b.ring[index & (EVENTS_PER_THREAD - 1)];
+
+            slot.sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.name.store(name, std::memory_order_relaxed);
+            slot.stamp.store((time & TIME_MASK) | (static_cast<uint64_t>(type) << 62), std::memory_order_relaxed);
+            slot.sequence.store(index + 1, std::memory_order_release);
+
+            b.written.store(index + 1, std::memory_order_release);
+        }
+
+        // what is in a ring right now, oldest first. slots rewritten while copying no longer hold the event that was
+        // asked for, and are dropped.
+        std::vector<Event> snapshot(const ThreadBuffer& b) {
+            uint64_t written = b.written.load(std::memory_order_acquire);
+            uint64_t first = written > EVENTS_PER_THREAD ? written - EVENTS_PER_THREAD : 0;
+
+            std::vector<Event> events;
+            events.reserve(written - first);
+            for (uint64_t i = first; i < written; i++) {
+                const Slot& slot = b.ring[i & (EVENTS_PER_THREAD - 1)];
+
+                uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+                Event event{ slot.name.load(std::memory_order_relaxed), slot.stamp.load(std::memory_order_relaxed) };
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (sequence != i + 1 || slot.sequence.load(std::memory_order_relaxed) != sequence) continue;
+                events.push_back(event);
+            }
+
+            return events;
+        }
+
+        void writeString(std::ostream& out, std::string_view s) {
+            out << '"';
+            for (char c : s) {
+                if (c == '"' || c == '\\') out << '\\';
+                if (static_cast<unsigned char>(c) < 0x20) continue;
+                out << c;
+            }
+            out << '"';
+        }
+    }
+
+    void begin(const char* name) {
+        auto& b = local();
+        b.open.push_back(name);
+        push(b, name, EventType::Begin, clock::now());
+    }
+
+    void end() {
+        auto& b = local();
+        if (b.open.empty()) return;
+
+        const char* name = b.open.back();
+        b.open.pop_back();
+        push(b, name, EventType::End, clock::now());
+    }
+
+    void frame() {
+        auto now = clock::now();
+        push(local(), "frame", EventType::Frame, now);
+
+        double duration;
+        std::filesystem::path path;
+        {
+            std::lock_guard lock(s_Mutex);
+            auto last = std::exchange(s_LastFrame, now);
+            if (s_HitchThreshold <= 0.0 || last == clock::time_point{}) return;
+
+            duration = std::chrono::duration<double>(now - last).count();
+            if (duration < s_HitchThreshold) return;
+            if (s_Captures > 0 && std::chrono::duration<double>(now - s_LastCapture).count() < s_HitchCooldown) return;
+
+            s_LastCapture = now;
+            path = s_HitchDirectory / fmt::format("hitch-{}.json", s_Captures++);
+        }
+
+        // exporting takes the lock itself.
+        if (exportChromeTrace(path)) spdlog::warn("{:.2f}ms frame, trace written to {}", duration * 1000.0, path.string());
+    }
+
+    void setThreadName(std::string name) {
+        auto& b = local();
+        std::lock_guard lock(s_Mutex);
+        b.name = std::move(name);
+    }
+
+    Track::Track(std::string name) : m_Buffer(registerBuffer(std::move(name))) {}
+
+    void Track::record(const char *name, EventType type, std::chrono::steady_clock::time_point time) {
+        push(*m_Buffer, name, type, time);
+    }
+
+    bool exportChromeTrace(const std::filesystem::path &path) {
+        if (!isEnabled()) spdlog::warn("Exporting a trace from a build without KAT_PROFILE, it will be empty");
+
+        if (path.has_parent_path()) {
+            std::error_code ec;
+            std::filesystem::create_directories(path.parent_path(), ec);
+        }
+
+        std::ofstream out(path);
+        if (!out) {
+            spdlog::error("Can't write trace {}", path.string());
+            return false;
+        }
+
+        std::vector<std::pair<const ThreadBuffer*, std::string>> threads;
+        {
+            std::lock_guard lock(s_Mutex);
+            for (const auto& b : s_Buffers) threads.emplace_back(b.get(), b->name);
+        }
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        auto separate = [&] {
+            if (!first) out << ",\n";
+            first = false;
+        };
+
+        char ts[32];
+        for (const auto& [buffer, name] : threads) {
+            separate();
+            out << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->id << R"(,"args":{"name":)";
+            writeString(out, name);
+            out << "}}";
+
+            // ends whose begin already fell out of the ring would confuse the viewer, skip them.
+            size_t depth = 0;
+            for (const auto& event : snapshot(*buffer)) {
+                auto type = static_cast<EventType>(event.stamp >> 62);
+                std::snprintf(ts, sizeof(ts), "%.3f", static_cast<double>(event.stamp & TIME_MASK) / 1000.0);
+
+                if (type == EventType::End && depth == 0) continue;
+                depth = type == EventType::Begin ? depth + 1 : type == EventType::End ? depth - 1 : depth;
+
+                separate();
+                out << "{\"name\":";
+                writeString(out, event.name);
+                switch (type) {
+                    case EventType::Begin: out << ",\"ph\":\"B\""; break;
+                    case EventType::End: out << ",\"ph\":\"E\""; break;
+                    case EventType::Frame: out << ",\"ph\":\"i\",\"s\":\"g\""; break;
+                }
+                out << ",\"ts\":" << ts << ",\"pid\":1,\"tid\":" << buffer->id << "}";
+            }
+        }
+
+        out << "\n]}\n";
+        return static_cast<bool>(out);
+    }
+
+    void captureHitches(double threshold, const std::filesystem::path &directory, double cooldown) {
+        std::lock_guard lock(s_Mutex);
+        s_HitchDirectory = directory;
+        s_HitchCooldown = cooldown;
+        s_HitchThreshold = std::max(threshold, 0.0);
+    }
+}
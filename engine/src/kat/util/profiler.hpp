@@ -0,0 +1,81 @@
+#pragma once
+
+#include "kat/core.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+// Zones compile to nothing unless built with KAT_PROFILE. names must be string literals (or otherwise outlive the
+// profiler), only the pointer is recorded.
+#define KAT_PROFILE_CONCAT_INNER(a, b) a##b
+#define KAT_PROFILE_CONCAT(a, b) KAT_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef KAT_PROFILE
+#define KAT_PROFILE_SCOPE(name) ::kat::profiler::Zone KAT_PROFILE_CONCAT(katProfileZone, __LINE__)(name)
+#define KAT_PROFILE_FUNCTION() KAT_PROFILE_SCOPE(__func__)
+#define KAT_PROFILE_FRAME() ::kat::profiler::frame()
+#define KAT_PROFILE_THREAD(name) ::kat::profiler::setThreadName(name)
+#else
+#define KAT_PROFILE_SCOPE(name) ((void) 0)
+#define KAT_PROFILE_FUNCTION() ((void) 0)
+#define KAT_PROFILE_FRAME() ((void) 0)
+#define KAT_PROFILE_THREAD(name) ((void) 0)
+#endif
+
+namespace kat::profiler {
+    struct ThreadBuffer;
+
+    // Every thread records into its own ring of begin / end events, 24 bytes each, without locks. The rings keep the
+    // last EVENTS_PER_THREAD events, exporting copies whatever is in them at that moment.
+    static constexpr size_t EVENTS_PER_THREAD = 1 << 16;
+
+    enum class EventType : uint8_t {
+        Begin, End, Frame
+    };
+
+    // the calling thread's ring
+    void begin(const char* name);
+    void end();
+    void frame();
+    void setThreadName(std::string name);
+
+    // A timeline that isn't a thread, for events measured elsewhere (GPU timestamps) and recorded after the fact.
+    // One thread records into a track at a time, begin / end in time order.
+    class Track {
+    public:
+        explicit Track(std::string name);
+
+        void record(const char* name, EventType type, std::chrono::steady_clock::time_point time);
+
+    private:
+        ThreadBuffer* m_Buffer;
+    };
+
+    // Chrome trace event JSON, opens in chrome://tracing and ui.perfetto.dev. false if it can't be written.
+    bool exportChromeTrace(const std::filesystem::path& path);
+
+    // frames longer than threshold export a trace into directory, at most once per cooldown. 0 turns it off.
+    void captureHitches(double threshold, const std::filesystem::path& directory, double cooldown = 10.0);
+
+    [[nodiscard]] constexpr bool isEnabled() noexcept {
+#ifdef KAT_PROFILE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    class Zone {
+    public:
+        inline explicit Zone(const char* name) {
+            begin(name);
+        };
+
+        inline ~Zone() {
+            end();
+        };
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+    };
+}
@@ -26,7 +26,8 @@ namespace kat::transform {
             stack_node* tail;
         };
 
-        inline stack_node* head;
+        // the stack belongs to whichever thread is rendering, so each thread gets its own.
+        inline thread_local stack_node* head;
 
         inline void push(glm::mat4 mat) {
             if (head) {
@@ -36,7 +37,7 @@ namespace kat::transform {
             }
         };
 
-        inline std::stack<stack_node*> markers;
+        inline thread_local std::stack<stack_node*> markers;
 
         inline bool pop() {
             if (head) {
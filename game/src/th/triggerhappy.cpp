@@ -3,28 +3,62 @@
 namespace th {
     TriggerHappy::TriggerHappy() {
         kat::gbl::setup();
+
+        // cooked builds ship everything in one archive, loose files are used otherwise.
+        if (std::filesystem::exists("data.kpak")) {
+            if (auto pak = kat::PakArchive::open("data.kpak")) kat::gbl::paks.push_back(pak);
+        }
+
         setDefaults();
+
+        // reading and parsing don't need a context, so they overlap with window creation.
+        kat::LoadPipeline loader;
+        queueAssets(loader);
+
         createWindow();
-        loadAssets();
+        loadAssets(loader);
     }
 
     TriggerHappy::~TriggerHappy() = default;
 
     void TriggerHappy::run() {
+        m_Pipeline = std::make_unique<kat::FramePipeline<FrameSnapshot>>(
+                [this](const FrameSnapshot& frame) { render(frame); },
+                kat::FrameScheduler::Config{ 1 });
+        m_Pipeline->start();
+
+        // profiled builds keep a trace of anything longer than the hitch threshold.
+        KAT_PROFILE_THREAD("main");
+        kat::profiler::captureHitches(1.0 / 20.0, "traces");
+
         kat::gbl::clock.tick();
 
         while (kat::gbl::activeWindow->isOpen()) {
-            update(kat::gbl::clock.getDeltaTime().count());
+            // blocks until the gpu is within the latency limiter's frames in flight, input is sampled after that.
+            auto& frame = m_Pipeline->beginFrame();
+            kat::gbl::activeWindow->pollEvents();
+            kat::gbl::clock.tick();
 
-            m_DownscaleFramebuffer->bindViewport();
-            renderWorld();
+            {
+                KAT_PROFILE_SCOPE("update");
+                auto scope = kat::gbl::clock.getStats().measure(kat::util::FramePhase::Update);
+                m_Loop.run(kat::gbl::clock, [this](double dt) { update(dt); });
+            }
 
-            kat::Framebuffer::bindDefaultViewport();
-            renderScreen();
-
-            kat::gbl::activeWindow->update();
-            kat::gbl::clock.tick();
+            snapshot(frame, static_cast<float>(m_Loop.getAlpha()));
+            m_Pipeline->submitFrame();
         }
+
+        // the context comes back to this thread, so the gl resources we own can be released normally.
+        m_Pipeline->stop();
+
+        kat::gbl::activeWindow->getLimiter().logStats();
+        kat::gbl::activeWindow->getLatencyLimiter().logStats();
+        kat::gbl::clock.getStats().log();
+        if (kat::gbl::gpuProfiler) kat::gbl::gpuProfiler->logStats();
+        kat::gbl::renderStats.log();
+
+        if (kat::profiler::isEnabled()) kat::profiler::exportChromeTrace("traces/exit.json");
     }
 
     void TriggerHappy::setDefaults() {
@@ -40,20 +74,77 @@ namespace th {
         });
     }
 
-    void TriggerHappy::loadAssets() {
+    void TriggerHappy::queueAssets(kat::LoadPipeline& loader) {
+        for (const char* path : {"shaders/shader.frag", "shaders/shader.vert", "shaders/screen.frag", "shaders/screen.vert"}) {
+            loader.load({path},
+                        [](std::span<const kat::io::Blob> blobs) { return blobs[0]; },
+                        [path](const kat::io::Blob& source) { kat::gbl::assets->shaderModule(path, source.getString()); });
+        }
+    }
+
+    void TriggerHappy::loadAssets(kat::LoadPipeline& loader) {
+        // the modules land in the asset cache, so building the shaders below doesn't touch the disk again.
+        loader.finish();
+        loader.logStats();
+
         m_ScreenQuad = kat::Mesh::createQuad({-1.0f, -1.0f}, {1.0f, 1.0f}, {{0.0f, 0.0f}, {1.0f, 1.0f}});
         m_TestQuad = kat::Mesh::createQuad({-64.0f, -64.0f}, {64.0f, 64.0f}, { {0.0f, 304.0f / 384.0f}, {0.125f, 1.0f}});
-        m_TestShader = kat::GraphicsShader::load({"shaders/shader.frag", "shaders/shader.vert"});
-        m_ScreenShader = kat::GraphicsShader::load({"shaders/screen.frag", "shaders/screen.vert"});
+        m_TestShader = kat::gbl::assets->shader({"shaders/shader.frag", "shaders/shader.vert"});
+        m_ScreenShader = kat::gbl::assets->shader({"shaders/screen.frag", "shaders/screen.vert"});
 
         m_DownscaleFramebuffer = kat::Framebuffer::makeSimpleRenderTarget({480, 270});
 
         m_Camera = std::make_shared<kat::util::OrthographicCamera>(-240, 240, -135, 135);
+        m_RenderCamera = std::make_shared<kat::util::OrthographicCamera>(-240, 240, -135, 135);
 
-        m_Texture = kat::Texture2D::load("textures/t4-3.png");
+        // frames rendered before the first fixed step interpolate from here.
+        m_PreviousPosition = m_Camera->getPosition();
+        m_PreviousZoom = m_Camera->getZoom();
+
+        m_Texture = kat::gbl::assets->texture("textures/t4-3.png");
+
+        createDecorations();
+    }
+
+    void TriggerHappy::createDecorations() {
+        constexpr int GRID = 256;
+        constexpr float SPACING = 48.0f;
+        constexpr float SIZE = 16.0f;
+
+        // the culler stretches a unit square over each instance's bounds.
+        m_DecorationBatcher = kat::StaticBatcher::create();
+        auto square = m_DecorationBatcher->add({
+                { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f }, {0,0,0,1}, {0,0,0} },
+                { { 1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f }, {0,0,0,1}, {0,0,0} },
+                { { 1.0f, 1.0f, 0.0f }, { 1.0f, 1.0f }, {0,0,0,1}, {0,0,0} },
+                { { 0.0f, 1.0f, 0.0f }, { 0.0f, 1.0f }, {0,0,0,1}, {0,0,0} }
+        }, { 0, 1, 2, 2, 3, 0 });
+
+        std::vector<kat::GpuCuller::Instance> instances;
+        instances.reserve(GRID * GRID);
+
+        for (int y = 0; y < GRID; y++) {
+            for (int x = 0; x < GRID; x++) {
+                // cheap hash so the field doesn't read as a grid.
+                uint32_t h = static_cast<uint32_t>(x) * 73856093u ^ static_cast<uint32_t>(y) * 19349663u;
+                glm::vec2 jitter{ static_cast<float>(h & 0xFF) / 255.0f, static_cast<float>((h >> 8) & 0xFF) / 255.0f };
+                glm::vec2 min = (glm::vec2{ x, y } - GRID / 2.0f + jitter) * SPACING;
+
+                instances.push_back({
+                        .bounds = { min, min + SIZE },
+                        .uvRect = { 0.0f, 304.0f / 384.0f, 0.125f, 1.0f },
+                        .mesh = square
+                });
+            }
+        }
+
+        m_Decorations = std::make_unique<kat::GpuCuller>(m_DecorationBatcher, std::move(instances));
     }
 
     void TriggerHappy::update(double deltaTime) {
+        m_PreviousPosition = m_Camera->getPosition();
+        m_PreviousZoom = m_Camera->getZoom();
+
         float moveScale = 1.0f;
         if (kat::input::isKeyPressed(GLFW_KEY_LEFT_SHIFT) || kat::input::isKeyPressed(GLFW_KEY_RIGHT_SHIFT)) {
             moveScale = 2.0f;
@@ -89,29 +180,59 @@ namespace th {
         m_Camera->update();
     }
 
-    void TriggerHappy::renderWorld() {
-        kat::transform::push(m_Camera->getCombined());
+    void TriggerHappy::snapshot(FrameSnapshot &frame, float alpha) {
+        m_RenderCamera->setPosition(glm::mix(m_PreviousPosition, m_Camera->getPosition(), alpha));
+        m_RenderCamera->setZoom(glm::mix(m_PreviousZoom, m_Camera->getZoom(), alpha));
+        m_RenderCamera->update();
+
+        frame.viewProjection = m_RenderCamera->getCombined();
+
+        // the view's corners in world space, ortho so two of them are enough.
+        auto inverse = glm::inverse(frame.viewProjection);
+        glm::vec4 a = inverse * glm::vec4{ -1.0f, -1.0f, 0.0f, 1.0f };
+        glm::vec4 b = inverse * glm::vec4{ 1.0f, 1.0f, 0.0f, 1.0f };
+        frame.cameraRect = { glm::min(glm::vec2(a), glm::vec2(b)), glm::max(glm::vec2(a), glm::vec2(b)) };
+        frame.zoomScale = m_RenderCamera->getZoomScale();
+    }
+
+    void TriggerHappy::render(const FrameSnapshot &frame) {
+        {
+            KAT_GPU_SCOPE("world");
+            m_DownscaleFramebuffer->bindViewport();
+            renderWorld(frame);
+        }
+        {
+            KAT_GPU_SCOPE("screen");
+            kat::Framebuffer::bindDefaultViewport();
+            renderScreen(frame);
+        }
+    }
+
+    void TriggerHappy::renderWorld(const FrameSnapshot &frame) {
+        kat::transform::push(frame.viewProjection);
 
         kat::graphics::clear(kat::colors::BLACK);
         kat::graphics::polygonMode(kat::graphics::PolygonMode::Fill);
 
-        m_TestShader->bind();
-        m_TestShader->bindTexture("uTexture", 0, m_Texture);
-        m_TestQuad->render();
+        m_Decorations->cull(frame.cameraRect);
+        m_Decorations->draw(m_Texture);
+
+        m_WorldQueue.push(0, 0.0f, m_TestShader, m_Texture, m_TestQuad);
+        m_WorldQueue.flush();
 
         kat::transform::pop();
     }
 
-    void TriggerHappy::renderScreen() {
+    void TriggerHappy::renderScreen(const FrameSnapshot &frame) {
         kat::graphics::polygonMode(kat::graphics::PolygonMode::Fill);
 
-        if (m_Camera->getZoomScale() < 1.0f) {
+        if (frame.zoomScale < 1.0f) {
             kat::graphics::clear({0.75f, 0.75f, 0.75f, 1.0f});
         }
 
         m_ScreenShader->bind();
         m_ScreenShader->bindTexture("uTexture", 0, m_DownscaleFramebuffer->getColorAttachment(0));
-        m_ScreenShader->setFloat("uScale", m_Camera->getZoomScale());
+        m_ScreenShader->setFloat("uScale", frame.zoomScale);
         m_ScreenQuad->render();
     }
 }
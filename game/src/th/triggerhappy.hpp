@@ -1,20 +1,37 @@
 #pragma once
 
 #include <kat/engine.hpp>
+#include <kat/assets.hpp>
 #include <kat/os.hpp>
+#include <kat/frame_pipeline.hpp>
+#include <kat/load_pipeline.hpp>
 #include "kat/graphics/colors.hpp"
 
+#include <kat/graphics/gpu_culling.hpp>
+#include <kat/graphics/gpu_profiler.hpp>
 #include <kat/graphics/mesh.hpp>
 #include <kat/graphics/shader.hpp>
 #include <kat/graphics/render_target.hpp>
+#include <kat/graphics/render_queue.hpp>
+#include <kat/graphics/render_stats.hpp>
+#include <kat/graphics/static_batch.hpp>
 #include <kat/graphics.hpp>
+#include <kat/io/kpak.hpp>
 #include <kat/util/camera.hpp>
 #include <kat/util/clock.hpp>
+#include <kat/util/fixed_step.hpp>
 #include <kat/util/transform_stack.hpp>
 
 
 namespace th {
 
+    // everything the render thread needs from a simulated frame.
+    struct FrameSnapshot {
+        glm::mat4 viewProjection;
+        glm::vec4 cameraRect; // world space min.xy, max.xy
+        float zoomScale;
+    };
+
     class TriggerHappy {
     public:
 
@@ -33,22 +50,42 @@ namespace th {
 
         void setDefaults();
         void createWindow();
-        void loadAssets();
+        void queueAssets(kat::LoadPipeline& loader);
+        void loadAssets(kat::LoadPipeline& loader);
+        void createDecorations();
+
+        void update(double deltaTime); // one fixed step
+        void snapshot(FrameSnapshot& frame, float alpha);
+
+        void render(const FrameSnapshot& frame);
+        void renderWorld(const FrameSnapshot& frame);
+        void renderScreen(const FrameSnapshot& frame);
 
-        void update(double deltaTime);
-        void renderWorld();
-        void renderScreen();
+        std::unique_ptr<kat::FramePipeline<FrameSnapshot>> m_Pipeline;
 
         std::unique_ptr<kat::Mesh> m_ScreenQuad;
         std::unique_ptr<kat::Mesh> m_TestQuad;
 
-        std::shared_ptr<kat::GraphicsShader> m_TestShader;
-        std::shared_ptr<kat::GraphicsShader> m_ScreenShader;
+        kat::AssetHandle<kat::GraphicsShader> m_TestShader;
+        kat::AssetHandle<kat::GraphicsShader> m_ScreenShader;
 
         std::unique_ptr<kat::Framebuffer> m_DownscaleFramebuffer;
 
+        kat::RenderQueue m_WorldQueue; // render thread only
+
+        // static scenery, culled on the gpu so the cpu never walks it.
+        std::shared_ptr<kat::StaticBatcher> m_DecorationBatcher;
+        std::unique_ptr<kat::GpuCuller> m_Decorations;
+
+        kat::util::FixedStepLoop m_Loop;
+
+        // simulated at the fixed rate, rendered through m_RenderCamera between the last two steps.
         std::shared_ptr<kat::util::OrthographicCamera> m_Camera;
-        std::shared_ptr<kat::Texture2D> m_Texture;
+        std::shared_ptr<kat::util::OrthographicCamera> m_RenderCamera;
+        glm::vec3 m_PreviousPosition{};
+        float m_PreviousZoom = 0.0f;
+
+        kat::AssetHandle<kat::Texture2D> m_Texture;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "server/world.hpp"
+
+#include <kat/io/kpak.hpp>
+#include <kat/util/clock.hpp>
+#include <kat/util/job_system.hpp>
+
+#include <atomic>
+#include <charconv>
+#include <csignal>
+#include <thread>
+
+namespace {
+    std::atomic<bool> s_Running = true;
+
+    void stop(int) {
+        s_Running.store(false, std::memory_order_relaxed);
+    }
+
+    template<typename T>
+    bool parse(std::string_view s, T& value) {
+        auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+        return ec == std::errc() && end == s.data() + s.size();
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+
+    uint32_t rate = 30;
+    uint64_t ticks = 0;
+    std::string_view pak = "data.kpak";
+    bool valid = true;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--rate" && i + 1 < args.size()) {
+            valid &= parse(args[++i], rate);
+        } else if (args[i] == "--ticks" && i + 1 < args.size()) {
+            valid &= parse(args[++i], ticks);
+        } else if (args[i] == "--pak" && i + 1 < args.size()) {
+            pak = args[++i];
+        } else {
+            valid = false;
+        }
+    }
+
+    if (!valid || rate == 0) {
+        spdlog::error("usage: KatServer [--rate <ticks per second>] [--ticks <count, 0 runs until interrupted>] [--pak <file>]");
+        return EXIT_FAILURE;
+    }
+
+    std::signal(SIGINT, stop);
+    std::signal(SIGTERM, stop);
+
+    kat::gbl::jobs = std::make_unique<kat::JobSystem>();
+    if (std::filesystem::exists(pak)) {
+        if (auto archive = kat::PakArchive::open(pak)) kat::gbl::paks.push_back(archive);
+    }
+
+    server::World world;
+
+    // steady, a wall clock adjustment would stall or burst the simulation.
+    using clock = std::chrono::steady_clock;
+    const double dt = 1.0 / rate;
+    const auto step = std::chrono::duration_cast<clock::duration>(kat::util::Clock::duration(dt));
+    const auto statsInterval = std::chrono::seconds(10);
+
+    spdlog::info("Simulating at {} ticks per second", rate);
+
+    size_t overruns = 0;
+    auto next = clock::now();
+    auto nextStats = next + statsInterval;
+    while (s_Running.load(std::memory_order_relaxed) && (ticks == 0 || world.getTick() < ticks)) {
+        world.tick(dt);
+
+        next += step;
+        auto now = clock::now();
+        if (now > next + step) {
+            // more than a tick behind, drop the backlog rather than spiral.
+            overruns++;
+            next = now;
+        } else {
+            std::this_thread::sleep_until(next);
+        }
+
+        if (now >= nextStats) {
+            world.logStats();
+            nextStats = now + statsInterval;
+        }
+    }
+
+    world.logStats();
+    if (overruns) spdlog::warn("Fell behind {} times", overruns);
+
+    kat::gbl::paks.clear();
+    kat::gbl::jobs.reset();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,39 @@
+#include "world.hpp"
+
+#include <kat/util/clock.hpp>
+
+namespace server {
+    void World::addSystem(std::string name, System system) {
+        m_Systems.push_back({ std::move(name), std::move(system) });
+    }
+
+    void World::tick(double dt) {
+        for (auto& entry : m_Systems) {
+            auto start = std::chrono::steady_clock::now();
+            entry.system(*this, dt);
+            double elapsed = kat::util::Clock::duration(std::chrono::steady_clock::now() - start).count();
+
+            entry.total += elapsed;
+            entry.longest = std::max(entry.longest, elapsed);
+        }
+
+        m_Tick++;
+        m_Time += dt;
+    }
+
+    uint64_t World::getTick() const noexcept {
+        return m_Tick;
+    }
+
+    double World::getTime() const noexcept {
+        return m_Time;
+    }
+
+    void World::logStats() const {
+        spdlog::info("{} ticks, {:.1f}s simulated, {} systems", m_Tick, m_Time, m_Systems.size());
+        for (const auto& entry : m_Systems) {
+            spdlog::info("  {}: {:.3f}ms avg, {:.3f}ms max", entry.name,
+                         m_Tick ? entry.total * 1000.0 / static_cast<double>(m_Tick) : 0.0, entry.longest * 1000.0);
+        }
+    }
+}
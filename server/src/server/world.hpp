@@ -0,0 +1,37 @@
+#pragma once
+
+#include <kat/core.hpp>
+
+#include <functional>
+
+namespace server {
+
+    // The simulated world, advanced in fixed ticks with nothing drawn. Systems (NPC schedules, pathfinding, combat
+    // resolution) run in the order they were added, every tick, with the tick length.
+    class World {
+    public:
+        using System = std::function<void(World&, double)>;
+
+        void addSystem(std::string name, System system);
+
+        void tick(double dt);
+
+        [[nodiscard]] uint64_t getTick() const noexcept;
+        [[nodiscard]] double getTime() const noexcept;  // simulated seconds
+
+        // average and longest time each system took per tick.
+        void logStats() const;
+
+    private:
+        struct Entry {
+            std::string name;
+            System system;
+            double total = 0.0;
+            double longest = 0.0;
+        };
+
+        std::vector<Entry> m_Systems;
+        uint64_t m_Tick = 0;
+        double m_Time = 0.0;
+    };
+}
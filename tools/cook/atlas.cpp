@@ -0,0 +1,149 @@
+#include "cook/commands.hpp"
+
+#include <kat/engine.hpp>
+#include <kat/graphics/atlas.hpp>
+#include <kat/io/batch_reader.hpp>
+
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+
+namespace cook {
+    namespace {
+        struct Image {
+            std::string name;
+            glm::uvec2 size;
+            std::vector<uint8_t> pixels;
+        };
+
+        bool parse(std::string_view s, uint32_t& value) {
+            auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+            return ec == std::errc() && end == s.data() + s.size();
+        }
+    }
+
+    int atlas(std::span<const std::string_view> args) {
+        std::vector<std::string_view> positional;
+        kat::AtlasPacker::Config config;
+        bool valid = true;
+
+        for (size_t i = 0; i < args.size(); i++) {
+            if (args[i] == "--size" && i + 1 < args.size()) {
+                valid &= parse(args[++i], config.pageSize.x);
+                config.pageSize.y = config.pageSize.x;
+            } else if (args[i] == "--padding" && i + 1 < args.size()) {
+                valid &= parse(args[++i], config.padding);
+            } else if (args[i] == "--no-trim") {
+                config.trim = false;
+            } else if (args[i] == "--no-extrude") {
+                config.extrude = false;
+            } else {
+                positional.push_back(args[i]);
+            }
+        }
+
+        if (positional.size() != 2 || !valid || config.pageSize.x == 0) {
+            spdlog::error("atlas <output.katlas> <directory> [--size <pixels>] [--padding <pixels>] [--no-trim] [--no-extrude]");
+            return EXIT_FAILURE;
+        }
+
+        std::filesystem::path output(positional[0]);
+        std::filesystem::path root(positional[1]);
+
+        std::vector<std::filesystem::path> paths;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".png") paths.push_back(entry.path());
+        }
+        std::sort(paths.begin(), paths.end());
+
+        kat::io::BatchReader reader;
+        auto blobs = reader.read(paths);
+
+        // rows bottom to top, like the engine loads them. the pages are flipped back when written.
+        stbi_set_flip_vertically_on_load(true);
+
+        std::vector<Image> images;
+        for (size_t i = 0; i < paths.size(); i++) {
+            if (!blobs[i]) return EXIT_FAILURE;
+
+            int width = 0, height = 0, nc = 0;
+            unsigned char* data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(blobs[i].getData()),
+                                                        static_cast<int>(blobs[i].getSize()), &width, &height, &nc, 4);
+            if (!data) {
+                spdlog::error("Failed to decode {}", paths[i].string());
+                return EXIT_FAILURE;
+            }
+
+            Image& image = images.emplace_back();
+            image.name = std::filesystem::relative(paths[i], root).generic_string();
+            image.size = glm::uvec2(width, height);
+            image.pixels.assign(data, data + static_cast<size_t>(width) * height * 4);
+            stbi_image_free(data);
+        }
+
+        // MaxRects packs tighter when the large sprites go first.
+        std::vector<size_t> order(images.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            auto sa = images[a].size, sb = images[b].size;
+            return std::max(sa.x, sa.y) > std::max(sb.x, sb.y);
+        });
+
+        kat::AtlasPacker packer(config);
+        std::vector<std::vector<uint8_t>> pages;
+        std::vector<uint32_t> sprites(images.size());
+
+        for (size_t i : order) {
+            auto placement = packer.add(images[i].size, images[i].pixels);
+            if (!placement) {
+                spdlog::error("Failed to pack {}", images[i].name);
+                return EXIT_FAILURE;
+            }
+
+            sprites[i] = placement->sprite;
+            if (placement->duplicate) continue;
+
+            uint32_t page = packer.getSprite(placement->sprite).page;
+            if (pages.size() <= page) pages.resize(page + 1, std::vector<uint8_t>(static_cast<size_t>(config.pageSize.x) * config.pageSize.y * 4));
+
+            for (uint32_t y = 0; y < placement->size.y; y++) {
+                std::copy_n(&placement->pixels[static_cast<size_t>(y) * placement->size.x * 4], placement->size.x * 4,
+                            &pages[page][((static_cast<size_t>(placement->position.y) + y) * config.pageSize.x + placement->position.x) * 4]);
+            }
+        }
+
+        std::ofstream index(output);
+        if (!index) throw std::runtime_error("can't write " + output.string());
+        index << "katlas 1\n";
+
+        stbi_flip_vertically_on_write(1);
+        for (size_t i = 0; i < pages.size(); i++) {
+            auto file = fmt::format("{}_{}.png", output.stem().string(), i);
+            auto path = output.parent_path() / file;
+
+            if (!stbi_write_png(path.string().c_str(), static_cast<int>(config.pageSize.x), static_cast<int>(config.pageSize.y), 4,
+                                pages[i].data(), static_cast<int>(config.pageSize.x) * 4)) {
+                throw std::runtime_error("can't write " + path.string());
+            }
+
+            index << "page " << file << '\n';
+        }
+
+        for (size_t i = 0; i < images.size(); i++) {
+            const auto& sprite = packer.getSprite(sprites[i]);
+            index << "sprite " << sprite.page << ' '
+                  << sprite.bottomLeft.x << ' ' << sprite.bottomLeft.y << ' ' << sprite.topRight.x << ' ' << sprite.topRight.y << ' '
+                  << sprite.offset.x << ' ' << sprite.offset.y << ' ' << sprite.sourceSize.x << ' ' << sprite.sourceSize.y << ' '
+                  << images[i].name << '\n';
+        }
+
+        if (!index) throw std::runtime_error("can't write " + output.string());
+
+        packer.logReport();
+        return EXIT_SUCCESS;
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+
+namespace cook {
+
+    // every command gets the arguments following its name and returns the exit code.
+    using Command = int(*)(std::span<const std::string_view> args);
+
+    int pack(std::span<const std::string_view> args);
+    int atlas(std::span<const std::string_view> args);
+    int palette(std::span<const std::string_view> args);
+}
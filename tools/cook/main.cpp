@@ -0,0 +1,53 @@
+#include "cook/commands.hpp"
+
+#include <kat/engine.hpp>
+#include <kat/util/job_system.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace cook {
+    constexpr std::pair<std::string_view, Command> COMMANDS[] = {
+            { "pack", pack },
+            { "atlas", atlas },
+            { "palette", palette },
+    };
+
+    void usage() {
+        spdlog::info("usage: KatCook <command> [args...]");
+        spdlog::info("  pack <output.kpak> <directory> [--raw] [--block-size <bytes>]");
+        spdlog::info("  atlas <output.katlas> <directory> [--size <pixels>] [--padding <pixels>] [--no-trim] [--no-extrude]");
+        spdlog::info("  palette <output directory> <directory> [--quantize] [--colors <1-256>]");
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+    if (args.empty()) {
+        cook::usage();
+        return EXIT_FAILURE;
+    }
+
+    kat::gbl::jobs = std::make_unique<kat::JobSystem>();
+
+    int result = EXIT_FAILURE;
+    bool found = false;
+    for (const auto& [name, command] : cook::COMMANDS) {
+        if (name != args[0]) continue;
+
+        found = true;
+        try {
+            result = command(std::span(args).subspan(1));
+        } catch (const std::exception& e) {
+            spdlog::error("{} failed: {}", name, e.what());
+        }
+    }
+
+    if (!found) {
+        spdlog::error("Unknown command {}", args[0]);
+        cook::usage();
+    }
+
+    kat::gbl::jobs.reset();
+    return result;
+}
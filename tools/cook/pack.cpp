@@ -0,0 +1,65 @@
+#include "cook/commands.hpp"
+
+#include <kat/engine.hpp>
+#include <kat/io/batch_reader.hpp>
+#include <kat/io/kpak.hpp>
+
+#include <charconv>
+
+namespace cook {
+    int pack(std::span<const std::string_view> args) {
+        std::vector<std::string_view> positional;
+        kat::PakWriter::Config config;
+
+        for (size_t i = 0; i < args.size(); i++) {
+            if (args[i] == "--raw") {
+                config.codec = kat::PakCodec::Raw;
+            } else if (args[i] == "--block-size" && i + 1 < args.size()) {
+                auto s = args[++i];
+                std::from_chars(s.data(), s.data() + s.size(), config.blockSize);
+            } else {
+                positional.push_back(args[i]);
+            }
+        }
+
+        if (positional.size() != 2 || config.blockSize == 0) {
+            spdlog::error("pack <output.kpak> <directory> [--raw] [--block-size <bytes>]");
+            return EXIT_FAILURE;
+        }
+
+        std::filesystem::path output(positional[0]);
+        std::filesystem::path root(positional[1]);
+
+        std::vector<std::filesystem::path> paths;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+            if (!entry.is_regular_file()) continue;
+
+            // don't pack a previous output living in the same tree.
+            std::error_code ec;
+            if (std::filesystem::equivalent(entry.path(), output, ec)) continue;
+
+            paths.push_back(entry.path());
+        }
+
+        // asset trees are mostly small files, read them all at once.
+        kat::io::BatchReader reader;
+        auto blobs = reader.read(paths);
+
+        kat::PakWriter writer(config);
+        size_t bytes = 0;
+
+        for (size_t i = 0; i < paths.size(); i++) {
+            if (!blobs[i]) return EXIT_FAILURE;
+
+            auto data = blobs[i].getBytes();
+            writer.add(std::filesystem::relative(paths[i], root).generic_string(), { data.begin(), data.end() });
+            bytes += data.size();
+        }
+
+        writer.write(output);
+
+        spdlog::info("Packed {} files ({} bytes) into {} ({} bytes)", paths.size(), bytes, output.string(),
+                     std::filesystem::file_size(output));
+        return EXIT_SUCCESS;
+    }
+}
@@ -0,0 +1,94 @@
+#include "cook/commands.hpp"
+
+#include <kat/engine.hpp>
+#include <kat/graphics/palette.hpp>
+#include <kat/io/batch_reader.hpp>
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+
+namespace cook {
+    int palette(std::span<const std::string_view> args) {
+        std::vector<std::string_view> positional;
+        uint32_t colors = kat::Palette::MAX_COLORS;
+        bool quantize = false;
+        bool valid = true;
+
+        for (size_t i = 0; i < args.size(); i++) {
+            if (args[i] == "--quantize") {
+                quantize = true;
+            } else if (args[i] == "--colors" && i + 1 < args.size()) {
+                auto s = args[++i];
+                auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), colors);
+                valid &= ec == std::errc() && end == s.data() + s.size();
+            } else {
+                positional.push_back(args[i]);
+            }
+        }
+
+        if (positional.size() != 2 || !valid || colors == 0 || colors > kat::Palette::MAX_COLORS) {
+            spdlog::error("palette <output directory> <directory> [--quantize] [--colors <1-256>]");
+            return EXIT_FAILURE;
+        }
+
+        std::filesystem::path output(positional[0]);
+        std::filesystem::path root(positional[1]);
+
+        std::vector<std::filesystem::path> paths;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".png") paths.push_back(entry.path());
+        }
+        std::sort(paths.begin(), paths.end());
+
+        kat::io::BatchReader reader;
+        auto blobs = reader.read(paths);
+
+        // rows bottom to top, the way the engine uploads them.
+        stbi_set_flip_vertically_on_load(true);
+
+        size_t converted = 0, rgbaBytes = 0, indexedBytes = 0;
+        for (size_t i = 0; i < paths.size(); i++) {
+            if (!blobs[i]) return EXIT_FAILURE;
+
+            int width = 0, height = 0, nc = 0;
+            unsigned char* data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(blobs[i].getData()),
+                                                        static_cast<int>(blobs[i].getSize()), &width, &height, &nc, 4);
+            if (!data) {
+                spdlog::error("Failed to decode {}", paths[i].string());
+                return EXIT_FAILURE;
+            }
+
+            glm::uvec2 size(width, height);
+            std::span<const uint8_t> rgba(data, static_cast<size_t>(width) * height * 4);
+
+            auto image = quantize ? kat::IndexedImage::quantize(size, rgba, colors) : kat::IndexedImage::fromRGBA(size, rgba, colors);
+            stbi_image_free(data);
+
+            auto name = std::filesystem::relative(paths[i], root);
+            if (!image) {
+                spdlog::warn("{} has more than {} colours, left as is (--quantize to reduce it)", name.generic_string(), colors);
+                continue;
+            }
+
+            auto path = output / name;
+            path.replace_extension(".kidx");
+            std::filesystem::create_directories(path.parent_path());
+
+            auto bytes = image->encode();
+            std::ofstream out(path, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            if (!out) throw std::runtime_error("can't write " + path.string());
+
+            spdlog::debug("{}: {} colours", name.generic_string(), image->palette.size());
+            converted++;
+            rgbaBytes += image->indices.size() * 4;
+            indexedBytes += image->indices.size();
+        }
+
+        spdlog::info("Indexed {} of {} images, {} bytes of RGBA8 texels become {}", converted, paths.size(), rgbaBytes, indexedBytes);
+        return EXIT_SUCCESS;
+    }
+}
@@ -0,0 +1,289 @@
+#include "gltrace/analysis.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace gltrace {
+    namespace {
+        // functions which only set state, and how many leading arguments say which state.
+        constexpr std::pair<std::string_view, uint8_t> STATE_SETTERS[] = {
+                { "glUseProgram", 0 }, { "glBindVertexArray", 0 }, { "glActiveTexture", 0 },
+                { "glBindBuffer", 1 }, { "glBindBufferBase", 2 }, { "glBindBufferRange", 2 },
+                { "glBindSampler", 1 }, { "glBindImageTexture", 1 },
+                { "glPolygonMode", 1 }, { "glPixelStorei", 1 }, { "glClearColor", 0 }, { "glClearDepth", 0 },
+                { "glViewport", 0 }, { "glScissor", 0 }, { "glBlendFunc", 0 }, { "glBlendFuncSeparate", 0 },
+                { "glBlendEquation", 0 }, { "glDepthFunc", 0 }, { "glDepthMask", 0 }, { "glColorMask", 0 },
+                { "glCullFace", 0 }, { "glFrontFace", 0 }, { "glLineWidth", 0 }, { "glPointSize", 0 },
+                { "glStencilFunc", 0 }, { "glStencilOp", 0 }, { "glStencilMask", 0 },
+                { "glNamedFramebufferReadBuffer", 1 }, { "glNamedFramebufferDrawBuffer", 1 },
+                { "glTextureParameteri", 2 }, { "glTextureParameterf", 2 },
+                { "glSamplerParameteri", 2 }, { "glSamplerParameterf", 2 },
+        };
+
+        // block until the driver catches up or hand data back from it, on top of every glGet* and glIs*.
+        constexpr std::string_view SYNC_CALLS[] = {
+                "glFinish", "glClientWaitSync", "glReadPixels", "glReadnPixels", "glMapBuffer", "glMapBufferRange",
+                "glMapNamedBuffer", "glMapNamedBufferRange", "glCheckFramebufferStatus", "glCheckNamedFramebufferStatus",
+        };
+
+        constexpr uint64_t GL_FRAMEBUFFER = 0x8D40;
+        constexpr uint64_t GL_READ_FRAMEBUFFER = 0x8CA8;
+        constexpr uint64_t GL_DRAW_FRAMEBUFFER = 0x8CA9;
+        constexpr uint64_t GL_TEXTURE0 = 0x84C0;
+
+        double ms(uint64_t nanoseconds) {
+            return static_cast<double>(nanoseconds) * 1e-6;
+        }
+
+        double us(uint64_t nanoseconds) {
+            return static_cast<double>(nanoseconds) * 1e-3;
+        }
+    }
+
+    Analysis::Analysis(const kat::GlTraceReader &reader) {
+        const auto& functions = reader.getFunctions();
+
+        std::unordered_map<std::string_view, uint16_t> ids;
+        for (size_t i = 0; i < functions.size(); i++) ids.emplace(functions[i].name, static_cast<uint16_t>(i));
+
+        auto idOf = [&](std::string_view name, uint16_t fallback) {
+            auto it = ids.find(name);
+            return it == ids.end() ? fallback : it->second;
+        };
+
+        m_UseProgram = idOf("glUseProgram", kat::GL_TRACE_FRAME);
+        m_ActiveTextureFunction = idOf("glActiveTexture", kat::GL_TRACE_FRAME);
+
+        for (size_t i = 0; i < functions.size(); i++) {
+            Function& f = m_Functions.emplace_back();
+            f.name = functions[i].name;
+            f.types = functions[i].types;
+            f.family = static_cast<uint16_t>(i);
+
+            // values behind pointers weren't recorded, so those can't be compared. uniform vectors and matrices record a
+            // hash of theirs instead ('h'), which compares fine.
+            bool byValue = f.types.find('p') == std::string_view::npos;
+
+            auto setter = std::find_if(std::begin(STATE_SETTERS), std::end(STATE_SETTERS), [&](const auto& s) { return s.first == f.name; });
+            if (setter != std::end(STATE_SETTERS)) {
+                f.rule = Rule::State;
+                f.keyArgs = setter->second;
+            } else if (f.name == "glBindFramebuffer") {
+                f.rule = Rule::BindFramebuffer;
+            } else if (f.name == "glBindTexture" || f.name == "glBindTextureUnit") {
+                // both bind to a unit, glBindTexture to the active one.
+                f.rule = Rule::BindTexture;
+                f.family = idOf("glBindTexture", f.family);
+            } else if (f.name == "glBindTextures") {
+                f.rule = Rule::ForgetTextures;
+                f.family = idOf("glBindTexture", f.family);
+            } else if (f.name == "glEnable" || f.name == "glDisable") {
+                f.rule = Rule::Enable;
+                f.keyArgs = 1;
+                f.family = idOf("glEnable", f.family);
+            } else if (f.name == "glEnablei" || f.name == "glDisablei") {
+                f.rule = Rule::Enable;
+                f.keyArgs = 2;
+                f.family = idOf("glEnablei", f.family);
+            } else if (f.name.starts_with("glProgramUniform") && byValue) {
+                f.rule = Rule::State;
+                f.keyArgs = 2;
+            } else if (f.name.starts_with("glUniform") && byValue) {
+                f.rule = Rule::Uniform;
+                f.keyArgs = 1;
+            }
+
+            f.sync = f.name.starts_with("glGet") || f.name.starts_with("glIs") ||
+                     std::find(std::begin(SYNC_CALLS), std::end(SYNC_CALLS), f.name) != std::end(SYNC_CALLS);
+            f.draw = f.name.starts_with("glDraw") || f.name.starts_with("glMultiDraw");
+        }
+    }
+
+    void Analysis::add(const kat::GlTraceCall &call) {
+        m_End = std::max(m_End, call.time + call.duration);
+
+        if (call.isFrame()) {
+            if (m_Hot) m_Frames.push_back(m_Current);
+            m_Hot = true;
+            m_Current = { call.time };
+            return;
+        }
+
+        m_Calls++;
+        if (!m_Hot) m_StartupCalls++;
+        if (call.function >= m_Functions.size()) return;
+
+        Function& f = m_Functions[call.function];
+        f.calls++;
+        f.time += call.duration;
+        f.longest = std::max(f.longest, call.duration);
+
+        bool redundant = f.rule != Rule::None && isRedundant(f, call);
+        if (redundant) f.redundant++;
+
+        if (call.function == m_UseProgram && call.argCount > 0) m_Program = call.args[0];
+        if (call.function == m_ActiveTextureFunction && call.argCount > 0) m_ActiveTexture = call.args[0];
+
+        if (!m_Hot) return;
+
+        f.hotCalls++;
+        f.hotTime += call.duration;
+        if (redundant) f.hotRedundant++;
+
+        m_Current.calls++;
+        m_Current.time += call.duration;
+        if (f.draw) m_Current.draws++;
+        if (f.sync) m_Current.syncs++;
+        if (redundant) m_Current.redundant++;
+    }
+
+    bool Analysis::isRedundant(const Function &function, const kat::GlTraceCall &call) {
+        const auto& a = call.args;
+        if (call.argCount < function.keyArgs) return false;
+
+        // returns whether value was already what key is set to, and sets it.
+        auto set = [this](const StateKey& key, const StateValue& value) {
+            auto [it, inserted] = m_State.try_emplace(key, value);
+            if (inserted) return false;
+
+            bool same = it->second == value;
+            it->second = value;
+            return same;
+        };
+
+        StateValue value{};
+        switch (function.rule) {
+            case Rule::State:
+            case Rule::Uniform: {
+                std::copy(a.begin() + function.keyArgs, a.begin() + call.argCount, value.begin());
+
+                uint64_t k0 = function.keyArgs > 0 ? a[0] : 0;
+                uint64_t k1 = function.keyArgs > 1 ? a[1] : 0;
+                if (function.rule == Rule::Uniform) return set({ function.family, m_Program, k0, 0 }, value);
+                return set({ function.family, k0, k1, 0 }, value);
+            }
+            case Rule::Enable:
+                value[0] = function.name.starts_with("glEnable") ? 1 : 0;
+                return set({ function.family, a[0], function.keyArgs > 1 ? a[1] : 0, 0 }, value);
+            case Rule::BindTexture: {
+                if (call.argCount < 2) return false;
+
+                // a unit holds one texture per target, but a texture only ever has one target, so the name alone
+                // tells bindings apart. except 0, which glBindTexture unbinds from just its target.
+                bool unit = function.name == "glBindTextureUnit";
+                value[0] = a[1];
+                if (!unit && a[1] == 0) value[1] = a[0];
+                return set({ function.family, unit ? a[0] : m_ActiveTexture - GL_TEXTURE0, 0, 0 }, value);
+            }
+            case Rule::ForgetTextures:
+                if (call.argCount < 2) return false;
+                for (uint64_t unit = a[0]; unit < a[0] + a[1]; unit++) m_State.erase({ function.family, unit, 0, 0 });
+                return false;
+            case Rule::BindFramebuffer: {
+                if (call.argCount < 2) return false;
+                value[0] = a[1];
+                if (a[0] != GL_FRAMEBUFFER) return set({ function.family, a[0], 0, 0 }, value);
+
+                bool draw = set({ function.family, GL_DRAW_FRAMEBUFFER, 0, 0 }, value);
+                bool read = set({ function.family, GL_READ_FRAMEBUFFER, 0, 0 }, value);
+                return draw && read;
+            }
+            default:
+                return false;
+        }
+    }
+
+    void Analysis::report(const Options &options) const {
+        spdlog::info("{} calls to {} functions, {} before the first present, {} frames over {:.2f}s", m_Calls,
+                     std::count_if(m_Functions.begin(), m_Functions.end(), [](const Function& f) { return f.calls > 0; }),
+                     m_StartupCalls, m_Frames.size(), static_cast<double>(m_End) * 1e-9);
+
+        if (options.frames) {
+            spdlog::info("");
+            spdlog::info("{:>6} {:>10} {:>8} {:>8} {:>10} {:>10}", "frame", "calls", "draws", "sync", "redundant", "GL ms");
+            for (size_t i = 0; i < m_Frames.size(); i++) {
+                const auto& f = m_Frames[i];
+                spdlog::info("{:>6} {:>10} {:>8} {:>8} {:>10} {:>10.3f}", i, f.calls, f.draws, f.syncs, f.redundant, ms(f.time));
+            }
+        }
+
+        if (m_Frames.empty()) {
+            spdlog::warn("The trace has no complete frame, only totals follow");
+        } else {
+            std::vector<uint64_t> calls;
+            uint64_t draws = 0, time = 0;
+            for (const auto& f : m_Frames) {
+                calls.push_back(f.calls);
+                draws += f.draws;
+                time += f.time;
+            }
+            std::sort(calls.begin(), calls.end());
+
+            double frames = static_cast<double>(m_Frames.size());
+            auto at = [&](double q) { return calls[std::min(calls.size() - 1, static_cast<size_t>(q * frames))]; };
+
+            spdlog::info("");
+            spdlog::info("calls per frame: min {} / p50 {} / p95 {} / max {}, {:.1f} draws and {:.3f}ms inside GL on average",
+                         calls.front(), at(0.5), at(0.95), calls.back(), static_cast<double>(draws) / frames, ms(time) / frames);
+
+            // ten buckets between the fewest and most calls a frame made.
+            constexpr size_t BUCKETS = 10;
+            constexpr size_t WIDTH = 40;
+            uint64_t lo = calls.front(), span = std::max<uint64_t>(calls.back() - lo, 1);
+
+            std::array<size_t, BUCKETS> counts{};
+            for (uint64_t c : calls) counts[std::min(BUCKETS - 1, static_cast<size_t>((c - lo) * BUCKETS / span))]++;
+
+            size_t most = *std::max_element(counts.begin(), counts.end());
+            for (size_t b = 0; b < BUCKETS; b++) {
+                spdlog::info("  {:>8} - {:<8} {:>6} {}", lo + span * b / BUCKETS, lo + span * (b + 1) / BUCKETS, counts[b],
+                             std::string(counts[b] * WIDTH / most, '#'));
+            }
+        }
+
+        double frames = static_cast<double>(std::max<size_t>(m_Frames.size(), 1));
+        auto sorted = [&](auto key, auto filter) {
+            std::vector<const Function*> out;
+            for (const auto& f : m_Functions) {
+                if (filter(f)) out.push_back(&f);
+            }
+            std::sort(out.begin(), out.end(), [&](const Function* a, const Function* b) { return key(*a) > key(*b); });
+            if (out.size() > options.top) out.resize(options.top);
+            return out;
+        };
+
+        spdlog::info("");
+        spdlog::info("most called per frame:");
+        spdlog::info("  {:<40} {:>10} {:>12} {:>12}", "function", "per frame", "us / frame", "longest us");
+        for (const auto* f : sorted([](const Function& f) { return f.hotCalls; }, [](const Function& f) { return f.hotCalls > 0; })) {
+            spdlog::info("  {:<40} {:>10.1f} {:>12.2f} {:>12.2f}", f->name, static_cast<double>(f->hotCalls) / frames,
+                         us(f->hotTime) / frames, us(f->longest));
+        }
+
+        spdlog::info("");
+        spdlog::info("redundant state changes, setting what was already set:");
+        spdlog::info("  (uniform vectors and matrices compare by value, other calls taking pointers aren't compared)");
+        auto redundant = sorted([](const Function& f) { return f.redundant; }, [](const Function& f) { return f.redundant > 0; });
+        if (redundant.empty()) spdlog::info("  none");
+        for (const auto* f : redundant) {
+            spdlog::info("  {:<40} {:>10} of {:<10} {:>5.1f}%, {:.1f} per frame", f->name, f->redundant, f->calls,
+                         100.0 * static_cast<double>(f->redundant) / static_cast<double>(f->calls),
+                         static_cast<double>(f->hotRedundant) / frames);
+        }
+
+        spdlog::info("");
+        spdlog::info("synchronous calls (queries, readbacks, waits):");
+        auto sync = sorted([](const Function& f) { return f.hotCalls * 1'000'000'000ull + f.calls; },
+                           [](const Function& f) { return f.sync && f.calls > 0; });
+        if (sync.empty()) spdlog::info("  none");
+        for (const auto* f : sync) {
+            // location lookups make the driver search the linked program, they only need doing once per program.
+            bool lookup = f->name.ends_with("Location") || f->name.ends_with("Index");
+            std::string_view note = f->hotCalls == 0 ? "" : lookup ? "  <- in the hot path, cache it" : "  <- in the hot path";
+
+            spdlog::info("  {:<40} {:>8} in frames ({:.1f} per frame), {:>8} at startup, {:.3f}ms total, longest {:.2f}us{}",
+                         f->name, f->hotCalls, static_cast<double>(f->hotCalls) / frames, f->calls - f->hotCalls, ms(f->time),
+                         us(f->longest), note);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <kat/io/gl_trace_file.hpp>
+
+#include <array>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace gltrace {
+    struct Options {
+        size_t top = 20;            // rows per table
+        bool frames = false;        // a line per frame
+    };
+
+    // Everything KatGlTrace reports, gathered in one pass over a trace. Calls before the first present count as
+    // startup, everything after it is the hot path the per-frame numbers are about.
+    class Analysis {
+    public:
+        explicit Analysis(const kat::GlTraceReader& reader);
+
+        void add(const kat::GlTraceCall& call);
+        void report(const Options& options) const;
+
+    private:
+        enum class Rule : uint8_t {
+            None,
+            State,          // the first keyArgs arguments say what is set, the rest is its value
+            Enable,         // glEnable / glDisable, sharing state per cap
+            BindTexture,    // glBindTexture / glBindTextureUnit, one binding per unit
+            ForgetTextures, // glBindTextures, whose names weren't recorded
+            Uniform,        // glUniform*, per bound program
+            BindFramebuffer // GL_FRAMEBUFFER sets both the draw and the read binding
+        };
+
+        struct Function {
+            std::string_view name;
+            std::string_view types;
+
+            Rule rule = Rule::None;
+            uint8_t keyArgs = 0;
+            uint16_t family = 0;    // functions setting the same state share one
+            bool sync = false;      // waits on, or reads back from, the driver
+            bool draw = false;
+
+            uint64_t calls = 0;
+            uint64_t hotCalls = 0;
+            uint64_t time = 0;      // nanoseconds
+            uint64_t hotTime = 0;
+            uint32_t longest = 0;
+            uint64_t redundant = 0;
+            uint64_t hotRedundant = 0;
+        };
+
+        struct Frame {
+            uint64_t start = 0;
+            uint64_t calls = 0;
+            uint64_t draws = 0;
+            uint64_t syncs = 0;
+            uint64_t redundant = 0;
+            uint64_t time = 0;      // spent inside GL
+        };
+
+        using StateKey = std::tuple<uint16_t, uint64_t, uint64_t, uint64_t>;
+        using StateValue = std::array<uint64_t, kat::GL_TRACE_MAX_ARGS>;
+
+        [[nodiscard]] bool isRedundant(const Function& function, const kat::GlTraceCall& call);
+
+        std::vector<Function> m_Functions;
+        std::map<StateKey, StateValue> m_State;
+        uint64_t m_ActiveTexture = 0x84C0;  // GL_TEXTURE0
+        uint64_t m_Program = 0;
+
+        std::vector<Frame> m_Frames;    // only complete ones
+        Frame m_Current;
+        bool m_Hot = false;
+
+        uint64_t m_Calls = 0;
+        uint64_t m_StartupCalls = 0;
+        uint64_t m_End = 0;
+        uint16_t m_UseProgram = kat::GL_TRACE_FRAME;
+        uint16_t m_ActiveTextureFunction = kat::GL_TRACE_FRAME;
+    };
+}
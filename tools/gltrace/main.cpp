@@ -0,0 +1,40 @@
+#include "gltrace/analysis.hpp"
+
+#include <kat/io/gl_trace_file.hpp>
+
+#include <charconv>
+
+int main(int argc, char** argv) {
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+
+    std::vector<std::string_view> positional;
+    gltrace::Options options;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--frames") {
+            options.frames = true;
+        } else if (args[i] == "--top" && i + 1 < args.size()) {
+            auto s = args[++i];
+            std::from_chars(s.data(), s.data() + s.size(), options.top);
+        } else {
+            positional.push_back(args[i]);
+        }
+    }
+
+    if (positional.size() != 1 || options.top == 0) {
+        spdlog::info("usage: KatGlTrace <trace> [--top <rows>] [--frames]");
+        spdlog::info("  record one by running a KAT_GL_TRACE build with the KAT_GL_TRACE environment variable set to a path");
+        return EXIT_FAILURE;
+    }
+
+    auto reader = kat::GlTraceReader::open(std::filesystem::path(positional[0]));
+    if (!reader) return EXIT_FAILURE;
+
+    gltrace::Analysis analysis(*reader);
+
+    kat::GlTraceCall call;
+    while (reader->next(call)) analysis.add(call);
+
+    analysis.report(options);
+    return EXIT_SUCCESS;
+}